@@ -25,8 +25,8 @@
 #include "ArpeggiatorsManager.h"
 #include "ColourSchemesManager.h"
 #include "HotkeySchemesManager.h"
-#include "ArpeggiatorsManager.h"
 #include "ScalesManager.h"
+#include "StartupTasks.h"
 
 #include "HelioTheme.h"
 #include "ThemeSettings.h"
@@ -48,6 +48,50 @@
 #include "RootTreeItem.h"
 #include "SerializablePluginDescription.h"
 
+#if HELIO_UNIT_TESTS
+
+#define UNIT_TESTS_STOP_TIMEOUT_MS 5000
+
+//===----------------------------------------------------------------------===//
+// Unit tests
+//===----------------------------------------------------------------------===//
+
+// Some of the tests need the message loop running, e.g. to lock the
+// message manager from other threads, so they don't run on the message thread
+class UnitTestsThread final : public Thread
+{
+public:
+
+    UnitTestsThread() : Thread("Unit Tests") {}
+
+    ~UnitTestsThread() override
+    {
+        this->stopThread(UNIT_TESTS_STOP_TIMEOUT_MS);
+    }
+
+    void run() override
+    {
+        UnitTestRunner runner;
+        runner.setAssertOnFailure(false);
+        runner.runAllTests();
+
+        int numFailures = 0;
+        for (int i = 0; i < runner.getNumResults(); ++i)
+        {
+            numFailures += runner.getResult(i)->failures;
+        }
+
+        MessageManager::callAsync([numFailures]()
+        {
+            JUCEApplication::getInstance()->setApplicationReturnValue(numFailures > 0 ? 1 : 0);
+            JUCEApplication::quit();
+        });
+    }
+
+};
+
+#endif // HELIO_UNIT_TESTS
+
 //===----------------------------------------------------------------------===//
 // Static
 //===----------------------------------------------------------------------===//
@@ -210,6 +254,14 @@ String App::getHumanReadableDate(const Time &date)
     return timeString.trimEnd();
 }
 
+void App::waitForStartupTasks()
+{
+    if (this->startupTasks != nullptr)
+    {
+        this->startupTasks->waitForAll();
+    }
+}
+
 void App::recreateLayout()
 {
     this->getWindow()->dismissLayoutComponent();
@@ -255,12 +307,31 @@ void App::initialise(const String &commandLine)
         this->config = new class Config();
     
         // TODO: get rid of singletons somehow
-        TranslationsManager::getInstance().initialise(commandLine);
-        ArpeggiatorsManager::getInstance().initialise(commandLine);
-        ColourSchemesManager::getInstance().initialise(commandLine);
-        HotkeySchemesManager::getInstance().initialise(commandLine);
-        ArpeggiatorsManager::getInstance().initialise(commandLine);
-        ScalesManager::getInstance().initialise(commandLine);
+        // Resource managers are independent from each other,
+        // so they are loaded in parallel, and the main thread only waits
+        // for the ones needed to show the first screen; the rest are
+        // joined in waitForStartupTasks, before the workspace is loaded
+        this->startupTasks = new StartupTasks();
+
+        this->startupTasks->add(Serialization::Resources::translations, [commandLine]()
+        { TranslationsManager::getInstance().initialise(commandLine); });
+
+        this->startupTasks->add(Serialization::Resources::colourSchemes, [commandLine]()
+        { ColourSchemesManager::getInstance().initialise(commandLine); });
+
+        this->startupTasks->add(Serialization::Resources::hotkeySchemes, [commandLine]()
+        { HotkeySchemesManager::getInstance().initialise(commandLine); });
+
+        this->startupTasks->add(Serialization::Resources::arpeggiators, [commandLine]()
+        { ArpeggiatorsManager::getInstance().initialise(commandLine); });
+
+        this->startupTasks->add(Serialization::Resources::scales, [commandLine]()
+        { ScalesManager::getInstance().initialise(commandLine); });
+
+        this->startupTasks->start();
+        this->startupTasks->waitFor(Serialization::Resources::translations);
+        this->startupTasks->waitFor(Serialization::Resources::colourSchemes);
+        this->startupTasks->waitFor(Serialization::Resources::hotkeySchemes);
 
         this->workspace = new class Workspace();
         this->window = new MainWindow();
@@ -288,6 +359,14 @@ void App::initialise(const String &commandLine)
         fs.run(commandLine);
         this->quit();
     }
+#if HELIO_UNIT_TESTS
+    else if (this->runMode == App::UNIT_TESTS)
+    {
+        // quits the app when done
+        this->unitTests = new UnitTestsThread();
+        this->unitTests->startThread();
+    }
+#endif
 }
 
 void App::shutdown()
@@ -308,6 +387,9 @@ void App::shutdown()
         this->clipboard = nullptr;
         this->theme = nullptr;
 
+        // Make sure nothing is still loading in background
+        this->startupTasks = nullptr;
+
         const File tempFolder(DocumentHelpers::getTemporaryFolder());
         if (tempFolder.exists())
         {
@@ -322,11 +404,16 @@ void App::shutdown()
         ArpeggiatorsManager::getInstance().shutdown();
         HotkeySchemesManager::getInstance().shutdown();
         ColourSchemesManager::getInstance().shutdown();
-        ArpeggiatorsManager::getInstance().shutdown();
         TranslationsManager::getInstance().shutdown();
         
         Logger::setCurrentLogger(nullptr);
     }
+#if HELIO_UNIT_TESTS
+    else if (this->runMode == App::UNIT_TESTS)
+    {
+        this->unitTests = nullptr;
+    }
+#endif
 }
 
 const String App::getApplicationName()
@@ -469,6 +556,12 @@ App::RunMode App::detectRunMode(const String &commandLine)
 {
     if (commandLine != "")
     {
+#if HELIO_UNIT_TESTS
+        if (commandLine.contains("--run-tests"))
+        {
+            return App::UNIT_TESTS;
+        }
+#endif
         if (commandLine.contains("-F") && commandLine.contains("-f"))
         {
             return App::FONT_SERIALIZE;
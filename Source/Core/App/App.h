@@ -41,6 +41,11 @@ class AudioCore;
 class InternalClipboard;
 class SessionService;
 class UpdatesService;
+class StartupTasks;
+
+#if HELIO_UNIT_TESTS
+class UnitTestsThread;
+#endif
 
 class App final : public JUCEApplication,
                   private AsyncUpdater,
@@ -73,6 +78,7 @@ public:
     static void dismissAllModalComponents();
 
     void recreateLayout();
+    void waitForStartupTasks();
     
     //===------------------------------------------------------------------===//
     // JUCEApplication
@@ -113,6 +119,11 @@ private:
     ScopedPointer<class MainWindow> window;
     ScopedPointer<SessionService> sessionService;
     ScopedPointer<UpdatesService> updatesService;
+    ScopedPointer<StartupTasks> startupTasks;
+
+#if HELIO_UNIT_TESTS
+    ScopedPointer<UnitTestsThread> unitTests;
+#endif
 
 private:
 
@@ -127,7 +138,10 @@ private:
     {
         NORMAL,
         PLUGIN_CHECK,
-        FONT_SERIALIZE
+        FONT_SERIALIZE,
+#if HELIO_UNIT_TESTS
+        UNIT_TESTS
+#endif
     };
 
     App::RunMode detectRunMode(const String &commandLine);
@@ -0,0 +1,162 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "StartupTasks.h"
+
+class StartupTasks::TaskJob final : public ThreadPoolJob
+{
+public:
+
+    TaskJob(StartupTasks &owner, StartupTasks::Task *task) :
+        ThreadPoolJob("Startup task: " + task->id.toString()),
+        owner(owner),
+        task(task) {}
+
+    JobStatus runJob() override
+    {
+        const double startTime = Time::getMillisecondCounterHiRes();
+        this->task->function();
+        const double elapsedMs = Time::getMillisecondCounterHiRes() - startTime;
+        this->owner.onTaskDone(this->task, elapsedMs);
+        return jobHasFinished;
+    }
+
+private:
+
+    StartupTasks &owner;
+    StartupTasks::Task *task;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TaskJob)
+};
+
+StartupTasks::StartupTasks(int numThreads) :
+    startTimeMs(0.0),
+    started(false),
+    pool(jmax(1, numThreads)) {}
+
+StartupTasks::~StartupTasks()
+{
+    if (this->started)
+    {
+        this->waitForAll();
+    }
+}
+
+void StartupTasks::add(const Identifier &id, Function<void()> task,
+    const Array<Identifier> &dependencies)
+{
+    jassert(!this->started);
+    jassert(this->findTask(id) == nullptr);
+    this->tasks.add(new Task(id, task, dependencies));
+}
+
+void StartupTasks::start()
+{
+    jassert(!this->started);
+
+    // All dependencies have to be registered before the start
+    for (const auto *task : this->tasks)
+    {
+        for (const auto &dependency : task->dependencies)
+        {
+            ignoreUnused(dependency);
+            jassert(this->findTask(dependency) != nullptr);
+        }
+    }
+
+    this->started = true;
+    this->startTimeMs = Time::getMillisecondCounterHiRes();
+
+    const ScopedLock lock(this->tasksLock);
+    for (auto *task : this->tasks)
+    {
+        if (task->numPendingDependencies == 0)
+        {
+            this->schedule(task);
+        }
+    }
+}
+
+void StartupTasks::waitFor(const Identifier &id) const
+{
+    if (const auto *task = this->findTask(id))
+    {
+        jassert(this->started);
+        task->done.wait();
+        return;
+    }
+
+    jassertfalse;
+}
+
+void StartupTasks::waitForAll() const
+{
+    jassert(this->started);
+    for (const auto *task : this->tasks)
+    {
+        task->done.wait();
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Private
+//===----------------------------------------------------------------------===//
+
+void StartupTasks::schedule(Task *task)
+{
+    this->pool.addJob(new TaskJob(*this, task), true);
+}
+
+void StartupTasks::onTaskDone(Task *task, double elapsedMs)
+{
+    Logger::writeToLog("Startup task " + task->id.toString() +
+        " done in " + String(elapsedMs, 2) + " ms, " +
+        String(Time::getMillisecondCounterHiRes() - this->startTimeMs, 2) +
+        " ms since start");
+
+    const ScopedLock lock(this->tasksLock);
+    for (auto *dependent : this->tasks)
+    {
+        if (dependent->dependencies.contains(task->id))
+        {
+            jassert(dependent->numPendingDependencies > 0);
+            dependent->numPendingDependencies--;
+            if (dependent->numPendingDependencies == 0)
+            {
+                this->schedule(dependent);
+            }
+        }
+    }
+
+    // Signal only after the dependents are scheduled,
+    // so that waitForAll will never miss any of them
+    task->done.signal();
+}
+
+StartupTasks::Task *StartupTasks::findTask(const Identifier &id) const
+{
+    for (auto *task : this->tasks)
+    {
+        if (task->id == id)
+        {
+            return task;
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,74 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// A tiny task graph for the app startup:
+// every task is put into the thread pool only when all of its
+// dependencies are done, so pool threads never block on each other,
+// and the caller only waits for the tasks it really needs right now.
+class StartupTasks final
+{
+public:
+
+    explicit StartupTasks(int numThreads = SystemStats::getNumCpus());
+    ~StartupTasks();
+
+    void add(const Identifier &id, Function<void()> task,
+        const Array<Identifier> &dependencies = {});
+
+    void start();
+
+    void waitFor(const Identifier &id) const;
+    void waitForAll() const;
+
+private:
+
+    struct Task final
+    {
+        Task(const Identifier &id, Function<void()> function,
+            const Array<Identifier> &dependencies) :
+            id(id),
+            function(function),
+            dependencies(dependencies),
+            numPendingDependencies(dependencies.size()),
+            done(true) {}
+
+        const Identifier id;
+        const Function<void()> function;
+        const Array<Identifier> dependencies;
+        int numPendingDependencies;
+        WaitableEvent done;
+    };
+
+    class TaskJob;
+    friend class TaskJob;
+
+    void schedule(Task *task);
+    void onTaskDone(Task *task, double elapsedMs);
+    Task *findTask(const Identifier &id) const;
+
+    CriticalSection tasksLock;
+    OwnedArray<Task> tasks;
+
+    double startTimeMs;
+    bool started;
+
+    ThreadPool pool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StartupTasks)
+};
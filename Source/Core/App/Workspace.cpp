@@ -17,6 +17,7 @@
 
 #include "Common.h"
 #include "Workspace.h"
+#include "App.h"
 #include "Config.h"
 #include "SerializationKeys.h"
 #include "DocumentHelpers.h"
@@ -61,6 +62,9 @@ void Workspace::init()
 {
     if (! this->wasInitialized)
     {
+        // Make sure all resources are loaded before any project is opened
+        App::Helio()->waitForStartupTasks();
+
         this->audioCore = new AudioCore();
         this->pluginManager = new PluginScanner();
         this->treeRoot = new RootTreeItem("Workspace One");
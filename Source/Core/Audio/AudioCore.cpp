@@ -24,6 +24,8 @@
 #include "Instrument.h"
 #include "SerializationKeys.h"
 #include "AudioMonitor.h"
+#include "AudioEngine.h"
+#include "MidiInputRouter.h"
 #include "AudiobusOutput.h"
 
 void AudioCore::initAudioFormats(AudioPluginFormatManager &formatManager)
@@ -40,6 +42,13 @@ AudioCore::AudioCore()
     this->audioMonitor = new AudioMonitor();
     this->deviceManager.addAudioCallback(this->audioMonitor);
 
+    this->audioEngine = new AudioEngine();
+    this->audioEngine->setAudioMonitor(this->audioMonitor);
+    this->deviceManager.addAudioCallback(this->audioEngine);
+
+    this->midiInputRouter = new MidiInputRouter(*this->audioEngine);
+    this->deviceManager.addMidiInputCallback(String::empty, this->midiInputRouter);
+
     AudioCore::initAudioFormats(this->formatManager);
 
 #if HELIO_AUDIOBUS_SUPPORT
@@ -53,13 +62,21 @@ AudioCore::~AudioCore()
     AudiobusOutput::shutdown();
 #endif
 
+    this->deviceManager.removeMidiInputCallback(String::empty, this->midiInputRouter);
+    this->midiInputRouter = nullptr;
+
+    // Instruments keep reporting to the monitor until the device is closed
+    this->deviceManager.closeAudioDevice();
+
+    this->deviceManager.removeAudioCallback(this->audioEngine);
+    this->audioEngine = nullptr;
+
     this->deviceManager.removeAudioCallback(this->audioMonitor);
     this->audioMonitor = nullptr;
 
     //ScopedPointer<XmlElement> test(this->metaInstrument->serialize());
     //DocumentReader::saveObfuscated(File("111.txt"), test);
 
-    this->deviceManager.closeAudioDevice();
     this->masterReference.clear();
 }
 
@@ -81,6 +98,17 @@ void AudioCore::unmute()
     }
 }
 
+void AudioCore::mute(Instrument *instrument)
+{
+    this->removeInstrumentFromDevice(instrument);
+}
+
+void AudioCore::unmute(Instrument *instrument)
+{
+    this->removeInstrumentFromDevice(instrument);
+    this->addInstrumentToDevice(instrument);
+}
+
 AudioDeviceManager &AudioCore::getDevice() noexcept
 {
     return this->deviceManager;
@@ -96,6 +124,11 @@ AudioMonitor *AudioCore::getMonitor() const noexcept
     return this->audioMonitor;
 }
 
+MidiInputRouter &AudioCore::getMidiInputRouter() const noexcept
+{
+    return *this->midiInputRouter;
+}
+
 //===----------------------------------------------------------------------===//
 // Instruments
 //===----------------------------------------------------------------------===//
@@ -117,6 +150,7 @@ void AudioCore::removeInstrument(Instrument *instrument)
 {
     this->broadcastInstrumentRemoved(instrument);
 
+    this->midiInputRouter->removeInstrument(instrument);
     this->removeInstrumentFromDevice(instrument);
     this->instruments.removeObject(instrument, true);
 
@@ -125,14 +159,14 @@ void AudioCore::removeInstrument(Instrument *instrument)
 
 void AudioCore::addInstrumentToDevice(Instrument *instrument)
 {
-    this->deviceManager.addAudioCallback(&instrument->getProcessorPlayer());
-    this->deviceManager.addMidiInputCallback(String::empty, &instrument->getProcessorPlayer().getMidiMessageCollector());
+    instrument->setLiveInputClock(this->audioEngine);
+    this->audioEngine->addCallback(&instrument->getProcessorPlayer());
 }
 
 void AudioCore::removeInstrumentFromDevice(Instrument *instrument)
 {
-    this->deviceManager.removeAudioCallback(&instrument->getProcessorPlayer());
-    this->deviceManager.removeMidiInputCallback(String::empty, &instrument->getProcessorPlayer().getMidiMessageCollector());
+    this->audioEngine->removeCallback(&instrument->getProcessorPlayer());
+    instrument->setLiveInputClock(nullptr);
 }
 
 //===----------------------------------------------------------------------===//
@@ -366,6 +400,41 @@ void AudioCore::deserializeDeviceManager(const ValueTree &tree)
     this->deviceManager.setDefaultMidiOutput(root.getProperty(Audio::defaultMidiOutput));
 }
 
+ValueTree AudioCore::serializeMidiRouting() const
+{
+    using namespace Serialization;
+
+    ValueTree tree(Audio::midiRouting);
+    for (const auto &rule : this->midiInputRouter->getRules())
+    {
+        ValueTree ruleNode(Audio::midiRoutingRule);
+        ruleNode.setProperty(Audio::midiRoutingDevice, rule.deviceName, nullptr);
+        ruleNode.setProperty(Audio::midiRoutingChannel, rule.channel, nullptr);
+        ruleNode.setProperty(Audio::midiRoutingInstrumentId, rule.instrument->getInstrumentID(), nullptr);
+        tree.appendChild(ruleNode, nullptr);
+    }
+
+    return tree;
+}
+
+void AudioCore::deserializeMidiRouting(const ValueTree &tree)
+{
+    using namespace Serialization;
+
+    this->midiInputRouter->clearRules();
+
+    const auto root = tree.getChildWithName(Audio::midiRouting);
+    forEachValueTreeChildWithType(root, c, Audio::midiRoutingRule)
+    {
+        const String instrumentId = c.getProperty(Audio::midiRoutingInstrumentId);
+        const int channel = jlimit(0, 16, int(c.getProperty(Audio::midiRoutingChannel, 0)));
+        if (Instrument *instrument = this->findInstrumentById(instrumentId))
+        {
+            this->midiInputRouter->addRule(c.getProperty(Audio::midiRoutingDevice), channel, instrument);
+        }
+    }
+}
+
 //===----------------------------------------------------------------------===//
 // Serializable
 //===----------------------------------------------------------------------===//
@@ -390,6 +459,9 @@ ValueTree AudioCore::serialize() const
 
     const auto deviceState(this->serializeDeviceManager());
     tree.appendChild(deviceState, nullptr);
+
+    const auto midiRouting(this->serializeMidiRouting());
+    tree.appendChild(midiRouting, nullptr);
     return tree;
 }
 
@@ -423,6 +495,8 @@ void AudioCore::deserialize(const ValueTree &tree)
             this->instruments.add(instrument);
         }
     }
+
+    this->deserializeMidiRouting(root);
 }
 
 void AudioCore::reset()
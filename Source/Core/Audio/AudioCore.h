@@ -18,6 +18,8 @@
 #pragma once
 
 class AudioMonitor;
+class AudioEngine;
+class MidiInputRouter;
 
 #include "Instrument.h"
 #include "OrchestraPit.h"
@@ -37,6 +39,10 @@ public:
     void mute();
     void unmute();
 
+    // Detach a single instrument, e.g. while it is rendered offline
+    void mute(Instrument *instrument);
+    void unmute(Instrument *instrument);
+
     //===------------------------------------------------------------------===//
     // Instruments
     //===------------------------------------------------------------------===//
@@ -62,6 +68,7 @@ public:
     AudioDeviceManager &getDevice() noexcept;
     AudioPluginFormatManager &getFormatManager() noexcept;
     AudioMonitor *getMonitor() const noexcept;
+    MidiInputRouter &getMidiInputRouter() const noexcept;
 
     //===------------------------------------------------------------------===//
     // Serializable
@@ -122,9 +129,18 @@ private:
     ValueTree serializeDeviceManager() const;
     void deserializeDeviceManager(const ValueTree &tree);
 
+    ValueTree serializeMidiRouting() const;
+    void deserializeMidiRouting(const ValueTree &tree);
+
     OwnedArray<Instrument> instruments;
     ScopedPointer<AudioMonitor> audioMonitor;
 
+    // processes all instruments within the one device callback
+    ScopedPointer<AudioEngine> audioEngine;
+
+    // dispatches the live midi input only to the instruments it's meant for
+    ScopedPointer<MidiInputRouter> midiInputRouter;
+
     AudioPluginFormatManager formatManager;
     AudioDeviceManager deviceManager;
 
@@ -0,0 +1,373 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "AudioEngine.h"
+#include "AudioMonitor.h"
+#include "PerformanceTrace.h"
+
+// The slot counter is set to this between the blocks, so that a worker
+// waking up late never picks a slot of a block that is being prepared
+#define AUDIO_ENGINE_BLOCK_CLOSED (std::numeric_limits<int>::max() / 2)
+
+#define AUDIO_ENGINE_WORKER_STOP_TIMEOUT 1000
+#define AUDIO_ENGINE_UNFINISHED_SLOTS_POLL_MS 1
+
+class AudioEngine::Worker final : public Thread
+{
+public:
+
+    explicit Worker(AudioEngine &engine) :
+        Thread("Audio engine worker"),
+        engine(engine) {}
+
+    void wakeUp() noexcept
+    {
+        this->blockStarted.signal();
+    }
+
+    void stop()
+    {
+        this->signalThreadShouldExit();
+        this->blockStarted.signal();
+        this->stopThread(AUDIO_ENGINE_WORKER_STOP_TIMEOUT);
+    }
+
+    void run() override
+    {
+        while (!this->threadShouldExit())
+        {
+            this->blockStarted.wait();
+
+            if (!this->threadShouldExit())
+            {
+                this->engine.processPendingSlots();
+            }
+        }
+    }
+
+private:
+
+    AudioEngine &engine;
+    WaitableEvent blockStarted;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+};
+
+AudioEngine::AudioEngine() :
+    monitor(nullptr),
+    currentDevice(nullptr),
+    numOutputChannels(0),
+    bufferSize(0),
+    blockInputData(nullptr),
+    blockNumInputChannels(0),
+    blockNumOutputChannels(0),
+    blockNumSamples(0),
+    blockNumSlots(0),
+    nextSlot(AUDIO_ENGINE_BLOCK_CLOSED),
+    numFinishedSlots(0),
+    clockVersion(0),
+    clockStartSample(0),
+    clockStartTimeMs(0.0),
+    clockSampleRate(44100.0),
+    clockLastBlockSize(0)
+{
+    // the audio thread itself is one of the workers
+    const int numWorkers = jlimit(0, AUDIO_ENGINE_MAX_WORKERS, SystemStats::getNumCpus() - 1);
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto *worker = this->workers.add(new Worker(*this));
+        worker->startThread(10);
+    }
+}
+
+AudioEngine::~AudioEngine()
+{
+    for (auto *worker : this->workers)
+    {
+        worker->stop();
+    }
+
+    this->workers.clear();
+}
+
+void AudioEngine::addCallback(AudioIODeviceCallback *callback)
+{
+    jassert(callback != nullptr);
+
+    auto slot = new Slot();
+    slot->callback = callback;
+    this->prepareSlot(*slot);
+
+    if (this->currentDevice != nullptr)
+    {
+        callback->audioDeviceAboutToStart(this->currentDevice);
+    }
+
+    const SpinLock::ScopedLockType lock(this->slotsLock);
+    this->slots.add(slot);
+}
+
+void AudioEngine::removeCallback(AudioIODeviceCallback *callback)
+{
+    ScopedPointer<Slot> removedSlot;
+
+    {
+        const SpinLock::ScopedLockType lock(this->slotsLock);
+
+        // a player left out of the last block might still be running
+        this->waitForUnfinishedSlots();
+
+        for (int i = 0; i < this->slots.size(); ++i)
+        {
+            if (this->slots.getUnchecked(i)->callback == callback)
+            {
+                removedSlot = this->slots.removeAndReturn(i);
+                break;
+            }
+        }
+    }
+
+    if (removedSlot != nullptr && this->currentDevice != nullptr)
+    {
+        callback->audioDeviceStopped();
+    }
+}
+
+void AudioEngine::setAudioMonitor(AudioMonitor *audioMonitor) noexcept
+{
+    this->monitor = audioMonitor;
+}
+
+void AudioEngine::prepareSlot(Slot &slot) const
+{
+    slot.buffer.setSize(jmax(1, this->numOutputChannels), jmax(1, this->bufferSize));
+}
+
+bool AudioEngine::hasUnfinishedSlots() const noexcept
+{
+    return this->numFinishedSlots.get() < this->blockNumSlots;
+}
+
+void AudioEngine::waitForUnfinishedSlots() const
+{
+    while (this->hasUnfinishedSlots())
+    {
+        Thread::sleep(AUDIO_ENGINE_UNFINISHED_SLOTS_POLL_MS);
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Sample clock
+//===----------------------------------------------------------------------===//
+
+int64 AudioEngine::getBlockStartSample() const noexcept
+{
+    return this->clockStartSample.get();
+}
+
+int64 AudioEngine::getSamplePositionAt(double timeMs) const noexcept
+{
+    for (;;)
+    {
+        const int version = this->clockVersion.get();
+        if ((version & 1) != 0)
+        {
+            continue;
+        }
+
+        const int64 startSample = this->clockStartSample.get();
+        const double startTimeMs = this->clockStartTimeMs.get();
+        const double sampleRate = this->clockSampleRate.get();
+
+        if (this->clockVersion.get() == version)
+        {
+            return startSample + int64((timeMs - startTimeMs) * sampleRate / 1000.0);
+        }
+    }
+}
+
+void AudioEngine::advanceClock(int numSamples) noexcept
+{
+    ++this->clockVersion;
+    this->clockStartSample = this->clockStartSample.get() + this->clockLastBlockSize;
+    this->clockStartTimeMs = Time::getMillisecondCounterHiRes();
+    ++this->clockVersion;
+
+    this->clockLastBlockSize = numSamples;
+}
+
+void AudioEngine::resetClock(double sampleRate) noexcept
+{
+    ++this->clockVersion;
+    this->clockStartSample = 0;
+    this->clockStartTimeMs = Time::getMillisecondCounterHiRes();
+    this->clockSampleRate = sampleRate;
+    ++this->clockVersion;
+
+    this->clockLastBlockSize = 0;
+}
+
+//===----------------------------------------------------------------------===//
+// AudioIODeviceCallback
+//===----------------------------------------------------------------------===//
+
+void AudioEngine::audioDeviceIOCallback(const float **inputChannelData, int numInputChannels,
+    float **outputChannelData, int numOutputChannels, int numSamples)
+{
+    TRACE_SPAN("Audio engine");
+
+    const int64 startTicks = Time::getHighResolutionTicks();
+    this->advanceClock(numSamples);
+
+    for (int channel = 0; channel < numOutputChannels; ++channel)
+    {
+        if (float *output = outputChannelData[channel])
+        {
+            FloatVectorOperations::clear(output, numSamples);
+        }
+    }
+
+    // the list is being changed, or a player from the last block is still
+    // running on a worker: skip this block rather than wait for them
+    const SpinLock::ScopedTryLockType lock(this->slotsLock);
+    if (!lock.isLocked() || this->hasUnfinishedSlots())
+    {
+        return;
+    }
+
+    const int numSlots = this->slots.size();
+
+    for (int i = 0; i < numSlots; ++i)
+    {
+        auto *slot = this->slots.getUnchecked(i);
+        slot->isProcessed = 0;
+
+        // should only happen if the device has changed its mind about the block size
+        auto &buffer = slot->buffer;
+        if (buffer.getNumChannels() < numOutputChannels || buffer.getNumSamples() < numSamples)
+        {
+            buffer.setSize(numOutputChannels, numSamples, false, false, true);
+        }
+    }
+
+    this->blockInputData = inputChannelData;
+    this->blockNumInputChannels = numInputChannels;
+    this->blockNumOutputChannels = numOutputChannels;
+    this->blockNumSamples = numSamples;
+    this->blockNumSlots = numSlots;
+    this->numFinishedSlots = 0;
+    this->nextSlot = 0; // opens the block
+
+    const int numWorkersNeeded = jmin(this->workers.size(), numSlots - 1);
+    for (int i = 0; i < numWorkersNeeded; ++i)
+    {
+        this->workers.getUnchecked(i)->wakeUp();
+    }
+
+    this->processPendingSlots();
+
+    // by now every slot is taken, and the rest of them are being processed
+    // by the workers; it's usually too short to wait for to give up the time
+    // slice, but a stuck player can't hold the device for more than a block
+    const double blockSeconds = numSamples / jmax(1.0, this->clockSampleRate.get());
+    const int64 deadlineTicks = startTicks + Time::secondsToHighResolutionTicks(blockSeconds);
+    while (this->hasUnfinishedSlots() && Time::getHighResolutionTicks() < deadlineTicks) {}
+
+    this->nextSlot = AUDIO_ENGINE_BLOCK_CLOSED;
+
+    for (int channel = 0; channel < numOutputChannels; ++channel)
+    {
+        if (float *output = outputChannelData[channel])
+        {
+            for (int i = 0; i < numSlots; ++i)
+            {
+                const auto *slot = this->slots.getUnchecked(i);
+                if (slot->isProcessed.get() != 0)
+                {
+                    FloatVectorOperations::add(output, slot->buffer.getReadPointer(channel), numSamples);
+                }
+            }
+        }
+    }
+
+    if (AudioMonitor *audioMonitor = this->monitor.get())
+    {
+        audioMonitor->addProcessingTime(Time::getHighResolutionTicks() - startTicks);
+    }
+}
+
+void AudioEngine::processPendingSlots() noexcept
+{
+    for (;;)
+    {
+        const int slotIndex = (++this->nextSlot) - 1;
+        if (slotIndex >= this->blockNumSlots)
+        {
+            return;
+        }
+
+        auto *slot = this->slots.getUnchecked(slotIndex);
+        slot->callback->audioDeviceIOCallback(this->blockInputData,
+            this->blockNumInputChannels, slot->buffer.getArrayOfWritePointers(),
+            this->blockNumOutputChannels, this->blockNumSamples);
+
+        slot->isProcessed = 1;
+        ++this->numFinishedSlots;
+    }
+}
+
+void AudioEngine::audioDeviceAboutToStart(AudioIODevice *device)
+{
+    const SpinLock::ScopedLockType lock(this->slotsLock);
+    this->waitForUnfinishedSlots();
+
+    this->currentDevice = device;
+    this->numOutputChannels = device->getActiveOutputChannels().countNumberOfSetBits();
+    this->bufferSize = device->getCurrentBufferSizeSamples();
+    this->resetClock(device->getCurrentSampleRate());
+
+    for (auto *slot : this->slots)
+    {
+        this->prepareSlot(*slot);
+        slot->callback->audioDeviceAboutToStart(device);
+    }
+}
+
+void AudioEngine::audioDeviceStopped()
+{
+    const SpinLock::ScopedLockType lock(this->slotsLock);
+    this->waitForUnfinishedSlots();
+
+    for (auto *slot : this->slots)
+    {
+        slot->callback->audioDeviceStopped();
+    }
+
+    this->currentDevice = nullptr;
+}
+
+void AudioEngine::audioDeviceError(const String &errorMessage)
+{
+    const SpinLock::ScopedLockType lock(this->slotsLock);
+
+    for (auto *slot : this->slots)
+    {
+        slot->callback->audioDeviceError(errorMessage);
+    }
+}
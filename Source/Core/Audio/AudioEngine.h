@@ -0,0 +1,125 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define AUDIO_ENGINE_MAX_WORKERS 16
+
+class AudioMonitor;
+
+// The single device callback for all instruments' players.
+//
+// On each device block the players are processed in parallel, each into its
+// own buffer: the audio thread and a pool of worker threads pick the players
+// from a shared atomic counter, and the audio thread then waits for the rest
+// to finish. The buffers are summed up in the order the players were added,
+// so the output doesn't depend on which thread has processed what.
+//
+// The audio thread never blocks: it only try-locks the players list, and
+// waits for the workers no longer than one block. A player that is still
+// running after that is left out of the block, and no new block is opened
+// until it's done, so its buffer is never touched by two threads.
+class AudioEngine final : public AudioIODeviceCallback
+{
+public:
+
+    AudioEngine();
+    ~AudioEngine() override;
+
+    // Both are called from the message thread, and work as the device
+    // manager's add/removeAudioCallback would: the callbacks are started
+    // and stopped along with the device
+    void addCallback(AudioIODeviceCallback *callback);
+    void removeCallback(AudioIODeviceCallback *callback);
+
+    // The engine reports the wall time it takes to process each block
+    void setAudioMonitor(AudioMonitor *monitor) noexcept;
+
+    //===------------------------------------------------------------------===//
+    // Sample clock
+    //===------------------------------------------------------------------===//
+
+    // The samples are counted from the start of the device; the position
+    // of the block being processed is only consistent on the audio thread
+    // and the workers, while the conversion is safe to call from any thread,
+    // and extrapolates from the last block start without locking
+    int64 getBlockStartSample() const noexcept;
+    int64 getSamplePositionAt(double timeMs) const noexcept;
+
+    //===------------------------------------------------------------------===//
+    // AudioIODeviceCallback
+    //===------------------------------------------------------------------===//
+
+    void audioDeviceIOCallback(const float **inputChannelData, int numInputChannels,
+        float **outputChannelData, int numOutputChannels, int numSamples) override;
+    void audioDeviceAboutToStart(AudioIODevice *device) override;
+    void audioDeviceStopped() override;
+    void audioDeviceError(const String &errorMessage) override;
+
+private:
+
+    struct Slot final
+    {
+        AudioIODeviceCallback *callback;
+        AudioBuffer<float> buffer;
+        Atomic<int> isProcessed;
+    };
+
+    void prepareSlot(Slot &slot) const;
+
+    // Called both by the audio thread and the workers
+    void processPendingSlots() noexcept;
+
+    bool hasUnfinishedSlots() const noexcept;
+    void waitForUnfinishedSlots() const;
+
+    class Worker;
+    friend class Worker;
+    OwnedArray<Worker> workers;
+
+    SpinLock slotsLock;
+    OwnedArray<Slot> slots;
+
+    Atomic<AudioMonitor *> monitor;
+
+    AudioIODevice *currentDevice;
+    int numOutputChannels;
+    int bufferSize;
+
+    // The parameters of the block being processed, valid while it's open
+    const float **blockInputData;
+    int blockNumInputChannels;
+    int blockNumOutputChannels;
+    int blockNumSamples;
+    int blockNumSlots;
+
+    Atomic<int> nextSlot;
+    Atomic<int> numFinishedSlots;
+
+    void advanceClock(int numSamples) noexcept;
+    void resetClock(double sampleRate) noexcept;
+
+    // Written by the audio thread only; the version is odd while
+    // the other fields are being updated, so that the readers retry
+    Atomic<int> clockVersion;
+    Atomic<int64> clockStartSample;
+    Atomic<double> clockStartTimeMs;
+    Atomic<double> clockSampleRate;
+    int clockLastBlockSize;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioEngine)
+};
@@ -51,6 +51,12 @@ void BuiltInSynthAudioPlugin::fillInPluginDescription(PluginDescription &descrip
 void BuiltInSynthAudioPlugin::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages)
 {
     buffer.clear(0, buffer.getNumSamples());
+
+    if (midiMessages.isEmpty() && !this->hasActiveVoices())
+    {
+        return;
+    }
+
     this->synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
 
     //// This is the place where you'd normally do the guts of your plugin's
@@ -70,6 +76,19 @@ void BuiltInSynthAudioPlugin::processBlock(AudioSampleBuffer &buffer, MidiBuffer
     //}
 }
 
+bool BuiltInSynthAudioPlugin::hasActiveVoices() const
+{
+    for (int i = 0; i < this->synth.getNumVoices(); ++i)
+    {
+        if (this->synth.getVoice(i)->isVoiceActive())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void BuiltInSynthAudioPlugin::prepareToPlay(double sampleRate, int estimatedSamplesPerBlock)
 {
     this->synth.setCurrentPlaybackSampleRate(sampleRate);
@@ -103,6 +103,8 @@ protected:
 
     virtual void initSampler() = 0;
 
+    bool hasActiveVoices() const;
+
     Synthesiser synth;
 
 };
@@ -27,6 +27,17 @@ BuiltInSynthFormat::BuiltInSynthFormat()
     piano.fillInPluginDescription(this->pianoDescription);
 }
 
+AudioPluginInstance *BuiltInSynthFormat::createInstance(const PluginDescription &desc)
+{
+    const BuiltInSynthPiano piano(true);
+    if (desc.name == piano.getName())
+    {
+        return new BuiltInSynthPiano();
+    }
+
+    return nullptr;
+}
+
 String BuiltInSynthFormat::getName() const
 {
     return HELIO_BUILT_IN_PLUGIN_FORMAT_NAME;
@@ -52,11 +63,5 @@ void BuiltInSynthFormat::createPluginInstance(const PluginDescription &desc, dou
                                               int initialBufferSize, void *userData,
                                               void (*callback) (void*, AudioPluginInstance*, const String&))
 {
-    if (desc.name == this->pianoDescription.name)
-    {
-        callback(userData, new BuiltInSynthPiano(), String::empty);
-        return;
-    }
-    
-    callback(userData, nullptr, String::empty);
+    callback(userData, BuiltInSynthFormat::createInstance(desc), String::empty);
 }
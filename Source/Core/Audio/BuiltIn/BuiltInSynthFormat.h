@@ -33,6 +33,11 @@ public:
 
     BuiltInSynthFormat();
 
+    // Creates the instance right away, so unlike the format manager's
+    // synchronous creation, which waits for the message thread, this is
+    // safe to call from any thread; returns nullptr for unknown plugins
+    static AudioPluginInstance *createInstance(const PluginDescription &desc);
+
     String getName() const override;
 
     bool fileMightContainThisPluginType(const String &fileOrIdentifier) override;
@@ -21,29 +21,506 @@
 #include "InternalPluginFormat.h"
 #include "SerializablePluginDescription.h"
 #include "SerializationKeys.h"
+#include "AudioEngine.h"
+#include "BuiltInSynthFormat.h"
+#include "PerformanceTrace.h"
 
 const int Instrument::midiChannelNumber = 0x1000;
 
+// Output below this level is considered silence (about -80 dB)
+#define INSTRUMENT_SILENCE_THRESHOLD 0.0001f
+
+// Don't suspend the processors without tail right after the last note
+#define INSTRUMENT_MIN_SILENCE_SECONDS 0.25
+
+#define INSTRUMENT_MAX_LOADING_THREADS 4
+#define INSTRUMENT_LIVE_INPUT_QUEUE_SIZE 512
+
+// A single-producer, single-consumer queue of the live midi input;
+// the messages are played one block after they have arrived, so that
+// their relative timing is kept, the way MidiMessageCollector does it
+class Instrument::LiveInputQueue final
+{
+public:
+
+    LiveInputQueue() :
+        fifo(INSTRUMENT_LIVE_INPUT_QUEUE_SIZE),
+        clock(nullptr)
+    {
+        this->entries.calloc(INSTRUMENT_LIVE_INPUT_QUEUE_SIZE);
+    }
+
+    void setClock(const AudioEngine *engine) noexcept
+    {
+        this->clock = engine;
+    }
+
+    void push(const MidiMessage &message, int64 samplePosition) noexcept
+    {
+        const int size = message.getRawDataSize();
+        if (size > 3)
+        {
+            return;
+        }
+
+        int start1, size1, start2, size2;
+        this->fifo.prepareToWrite(1, start1, size1, start2, size2);
+        if (size1 + size2 == 0)
+        {
+            return;
+        }
+
+        auto &entry = this->entries[size1 > 0 ? start1 : start2];
+        memcpy(entry.data, message.getRawData(), size_t(size));
+        entry.size = size;
+        entry.samplePosition = samplePosition;
+        this->fifo.finishedWrite(1);
+    }
+
+    void readBlock(MidiBuffer &target, int numSamples) noexcept
+    {
+        const int numReady = this->fifo.getNumReady();
+        if (numReady == 0)
+        {
+            return;
+        }
+
+        const auto *engine = this->clock.get();
+        const int64 previousBlockStart = (engine != nullptr) ?
+            engine->getBlockStartSample() - numSamples : 0;
+
+        int start1, size1, start2, size2;
+        this->fifo.prepareToRead(numReady, start1, size1, start2, size2);
+        this->readEntries(target, start1, size1, previousBlockStart, numSamples);
+        this->readEntries(target, start2, size2, previousBlockStart, numSamples);
+        this->fifo.finishedRead(size1 + size2);
+    }
+
+private:
+
+    struct Entry final
+    {
+        uint8 data[3];
+        int size;
+        int64 samplePosition;
+    };
+
+    void readEntries(MidiBuffer &target, int start, int size,
+        int64 previousBlockStart, int numSamples) const noexcept
+    {
+        for (int i = start; i < start + size; ++i)
+        {
+            const auto &entry = this->entries[i];
+            const int64 offset = entry.samplePosition - previousBlockStart;
+            target.addEvent(entry.data, entry.size, int(jlimit(int64(0), int64(numSamples - 1), offset)));
+        }
+    }
+
+    AbstractFifo fifo;
+    HeapBlock<Entry> entries;
+    Atomic<const AudioEngine *> clock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LiveInputQueue)
+};
+
+// Skips processing of the whole graph once it has received no midi,
+// holds no notes and has been silent for longer than its longest tail;
+// the first block with any midi or audio input in it wakes it up, and since
+// the events in that block keep their sample positions, nothing gets shifted;
+// the live input is only played in the device callbacks, so that
+// it doesn't leak into the offline renders
+class Instrument::SuspendableGraph final : public AudioProcessorGraph
+{
+public:
+
+    explicit SuspendableGraph(LiveInputQueue &liveInput) :
+        liveInput(liveInput),
+        isDeviceCallback(false),
+        tailLengthSeconds(0.0),
+        suspended(false),
+        muted(false)
+    {
+        this->resetState();
+    }
+
+    void setTailLength(double seconds) noexcept
+    {
+        this->tailLengthSeconds = seconds;
+    }
+
+    bool isIdle() const noexcept
+    {
+        return this->suspended.get();
+    }
+
+    void setMuted(bool shouldBeMuted) noexcept
+    {
+        this->muted = shouldBeMuted;
+    }
+
+    // Only called from the audio thread, around the device callback
+    void setDeviceCallback(bool isInsideDeviceCallback) noexcept
+    {
+        this->isDeviceCallback = isInsideDeviceCallback;
+    }
+
+    void prepareToPlay(double sampleRate, int estimatedSamplesPerBlock) override
+    {
+        AudioProcessorGraph::prepareToPlay(sampleRate, estimatedSamplesPerBlock);
+        this->resetState();
+    }
+
+    void processBlock(AudioBuffer<float> &buffer, MidiBuffer &midiMessages) override
+    {
+        if (this->isDeviceCallback)
+        {
+            this->liveInput.readBlock(midiMessages, buffer.getNumSamples());
+        }
+
+        // the nodes are still being added and restored
+        if (this->muted.get())
+        {
+            buffer.clear();
+            midiMessages.clear();
+            return;
+        }
+
+        const bool hasMidi = !midiMessages.isEmpty();
+
+        // the buffer comes in with the device input, which is routed
+        // into the nodes, so the effects fed by live audio stay awake
+        const bool hasAudioInput =
+            buffer.getMagnitude(0, buffer.getNumSamples()) > INSTRUMENT_SILENCE_THRESHOLD;
+
+        if (hasMidi)
+        {
+            this->updateHeldNotes(midiMessages);
+        }
+
+        if (hasMidi || hasAudioInput)
+        {
+            this->suspended = false;
+        }
+        else if (this->suspended.get())
+        {
+            buffer.clear();
+            return;
+        }
+
+        AudioProcessorGraph::processBlock(buffer, midiMessages);
+
+        if (hasMidi || hasAudioInput || this->numHeldNotes > 0 || this->numSustainedChannels > 0 ||
+            buffer.getMagnitude(0, buffer.getNumSamples()) > INSTRUMENT_SILENCE_THRESHOLD)
+        {
+            this->numSilentSamples = 0;
+            return;
+        }
+
+        this->numSilentSamples += buffer.getNumSamples();
+
+        const double sampleRate = this->getSampleRate();
+        const double minSilenceSeconds =
+            jmax(INSTRUMENT_MIN_SILENCE_SECONDS, this->tailLengthSeconds.get());
+
+        if (sampleRate > 0.0 && this->numSilentSamples > minSilenceSeconds * sampleRate)
+        {
+            this->suspended = true;
+        }
+    }
+
+private:
+
+    void resetState() noexcept
+    {
+        this->suspended = false;
+        this->numSilentSamples = 0;
+        this->numHeldNotes = 0;
+        this->numSustainedChannels = 0;
+        zeromem(this->heldNotes, sizeof(this->heldNotes));
+        zeromem(this->sustainedChannels, sizeof(this->sustainedChannels));
+    }
+
+    void updateHeldNotes(const MidiBuffer &midiMessages) noexcept
+    {
+        MidiBuffer::Iterator it(midiMessages);
+        MidiMessage message;
+        int samplePosition;
+
+        while (it.getNextEvent(message, samplePosition))
+        {
+            const int channel = jlimit(1, 16, message.getChannel()) - 1;
+
+            if (message.isNoteOn())
+            {
+                this->setNoteHeld(channel, message.getNoteNumber(), true);
+            }
+            else if (message.isNoteOff())
+            {
+                this->setNoteHeld(channel, message.getNoteNumber(), false);
+            }
+            else if (message.isAllNotesOff() || message.isAllSoundOff())
+            {
+                for (int key = 0; key < 128; ++key)
+                {
+                    this->setNoteHeld(channel, key, false);
+                }
+            }
+            else if (message.isSustainPedalOn() || message.isSustainPedalOff())
+            {
+                const bool isOn = message.isSustainPedalOn();
+                if (this->sustainedChannels[channel] != isOn)
+                {
+                    this->sustainedChannels[channel] = isOn;
+                    this->numSustainedChannels += isOn ? 1 : -1;
+                }
+            }
+        }
+    }
+
+    inline void setNoteHeld(int channel, int key, bool isHeld) noexcept
+    {
+        if (this->heldNotes[channel][key] != isHeld)
+        {
+            this->heldNotes[channel][key] = isHeld;
+            this->numHeldNotes += isHeld ? 1 : -1;
+        }
+    }
+
+    LiveInputQueue &liveInput;
+    bool isDeviceCallback;
+
+    Atomic<double> tailLengthSeconds;
+    Atomic<bool> suspended;
+    Atomic<bool> muted;
+
+    // only accessed from the audio thread
+    int64 numSilentSamples;
+    bool heldNotes[16][128];
+    int numHeldNotes;
+    bool sustainedChannels[16];
+    int numSustainedChannels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SuspendableGraph)
+};
+
+class Instrument::TimedProcessorPlayer final : public AudioProcessorPlayer
+{
+public:
+
+    explicit TimedProcessorPlayer(SuspendableGraph &graph) :
+        graph(graph),
+        sampleRate(44100.0) {}
+
+    void audioDeviceAboutToStart(AudioIODevice *device) override
+    {
+        this->sampleRate = device->getCurrentSampleRate();
+        AudioProcessorPlayer::audioDeviceAboutToStart(device);
+    }
+
+    void audioDeviceIOCallback(const float **inputChannelData, int numInputChannels,
+        float **outputChannelData, int numOutputChannels, int numSamples) override
+    {
+        TRACE_SPAN("Instrument graph");
+
+        const int64 startTicks = Time::getHighResolutionTicks();
+
+        this->graph.setDeviceCallback(true);
+        AudioProcessorPlayer::audioDeviceIOCallback(inputChannelData, numInputChannels,
+            outputChannelData, numOutputChannels, numSamples);
+        this->graph.setDeviceCallback(false);
+
+        const int64 ticks = Time::getHighResolutionTicks() - startTicks;
+        const double budgetMs = numSamples * 1000.0 / this->sampleRate.get();
+        this->stats.addMeasurement(Time::highResolutionTicksToSeconds(ticks) * 1000.0, budgetMs);
+    }
+
+    SuspendableGraph &graph;
+
+    AudioLoadStats stats;
+    Atomic<double> sampleRate;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimedProcessorPlayer)
+};
+
+// Shared by all instruments, and only alive while there are any
+class Instrument::LoadingPool final : public ThreadPool
+{
+public:
+
+    LoadingPool() :
+        ThreadPool(jlimit(1, INSTRUMENT_MAX_LOADING_THREADS, SystemStats::getNumCpus() - 1)) {}
+};
+
+// Decodes the saved state of a node off the message thread;
+// the plugins of the built-in format are also created and restored here,
+// directly and not via the format manager, which would wait for the message
+// thread, and all other formats get their instances created on the message
+// thread, as usual
+class Instrument::NodeLoadingJob final : public ThreadPoolJob
+{
+public:
+
+    typedef Function<void(AudioPluginInstance *)> Callback;
+
+    NodeLoadingJob(Instrument &instrument, const PluginDescription &description,
+        const String &encodedState, Callback callback) :
+        ThreadPoolJob("Instrument node: " + description.name),
+        owner(&instrument),
+        instrument(&instrument),
+        description(description),
+        encodedState(encodedState),
+        sampleRate(instrument.processorGraph->getSampleRate()),
+        blockSize(instrument.processorGraph->getBlockSize()),
+        callback(callback) {}
+
+    JobStatus runJob() override
+    {
+        MemoryBlock state;
+        if (this->encodedState.isNotEmpty())
+        {
+            state.fromBase64Encoding(this->encodedState);
+        }
+
+        const auto done = this->callback;
+
+        if (this->description.pluginFormatName == HELIO_BUILT_IN_PLUGIN_FORMAT_NAME)
+        {
+            AudioPluginInstance *instance = BuiltInSynthFormat::createInstance(this->description);
+
+            if (instance != nullptr && state.getSize() > 0)
+            {
+                instance->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            }
+
+            MessageManager::callAsync([done, instance]() { done(instance); });
+            return jobHasFinished;
+        }
+
+        const auto target = this->instrument;
+        const auto desc = this->description;
+        const double rate = this->sampleRate;
+        const int size = this->blockSize;
+
+        MessageManager::callAsync([target, desc, rate, size, state, done]()
+        {
+            if (target == nullptr) { return; }
+
+            target->formatManager.createPluginInstanceAsync(desc, rate, size,
+                [state, done](AudioPluginInstance *instance, const String &error)
+                {
+                    if (instance != nullptr && state.getSize() > 0)
+                    {
+                        instance->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+                    }
+
+                    done(instance);
+                });
+        });
+
+        return jobHasFinished;
+    }
+
+    class Selector final : public ThreadPool::JobSelector
+    {
+    public:
+
+        explicit Selector(const Instrument *owner) : owner(owner) {}
+
+        bool isJobSuitable(ThreadPoolJob *job) override
+        {
+            const auto *loadingJob = dynamic_cast<NodeLoadingJob *>(job);
+            return loadingJob != nullptr && loadingJob->owner == this->owner;
+        }
+
+    private:
+
+        const Instrument *owner;
+    };
+
+private:
+
+    // only compared with, never dereferenced: the instrument
+    // doesn't wait for its running jobs, and might be gone already
+    const Instrument *owner;
+
+    // only dereferenced on the message thread
+    const WeakReference<Instrument> instrument;
+
+    const PluginDescription description;
+    const String encodedState;
+    const double sampleRate;
+    const int blockSize;
+    const Callback callback;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NodeLoadingJob)
+};
+
 Instrument::Instrument(AudioPluginFormatManager &formatManager, String name) :
     formatManager(formatManager),
     instrumentName(std::move(name)),
-    instrumentID()
+    instrumentID(),
+    loadingGeneration(0),
+    numNodesToLoad(0),
+    numNodesLoaded(0)
 {
-    this->processorGraph = new AudioProcessorGraph();
+    this->liveInput = new LiveInputQueue();
+    this->processorGraph = new SuspendableGraph(*this->liveInput);
+    this->processorPlayer = new TimedProcessorPlayer(*this->processorGraph);
     this->initializeDefaultNodes();
-    this->processorPlayer.setProcessor(this->processorGraph);
+    this->processorPlayer->setProcessor(this->processorGraph);
 }
 
 Instrument::~Instrument()
 {
+    this->cancelLoading();
     this->masterReference.clear();
-    this->processorPlayer.setProcessor(nullptr);
+    this->processorPlayer->setProcessor(nullptr);
     
     PluginWindow::closeAllCurrentlyOpenWindows();
     this->processorGraph->clear();
     this->processorGraph = nullptr;
 }
 
+AudioProcessorGraph *Instrument::getProcessorGraph() noexcept
+{
+    return this->processorGraph;
+}
+
+bool Instrument::isSuspended() const noexcept
+{
+    return this->processorGraph->isIdle();
+}
+
+bool Instrument::isLoading() const noexcept
+{
+    return this->numNodesLoaded < this->numNodesToLoad;
+}
+
+float Instrument::getLoadingProgress() const noexcept
+{
+    return (this->numNodesToLoad > 0) ?
+        float(this->numNodesLoaded) / float(this->numNodesToLoad) : 1.f;
+}
+
+void Instrument::addLiveInput(const MidiMessage &message, int64 samplePosition) noexcept
+{
+    this->liveInput->push(message, samplePosition);
+}
+
+void Instrument::setLiveInputClock(const AudioEngine *engine) noexcept
+{
+    this->liveInput->setClock(engine);
+}
+
+AudioProcessorPlayer &Instrument::getProcessorPlayer() noexcept
+{
+    return *this->processorPlayer;
+}
+
+const AudioLoadStats &Instrument::getLoadStats() const noexcept
+{
+    return this->processorPlayer->stats;
+}
 
 String Instrument::getName() const
 {
@@ -199,6 +676,7 @@ AudioProcessorGraph::Node::Ptr Instrument::addNode(Instrument *instrument, doubl
     {
         node->properties.set(Serialization::UI::positionX, x);
         node->properties.set(Serialization::UI::positionY, y);
+        this->updateTailLength();
         this->sendChangeMessage();
     }
 
@@ -209,6 +687,7 @@ void Instrument::removeNode(AudioProcessorGraph::NodeID id)
 {
     PluginWindow::closeCurrentlyOpenWindowsFor(id);
     this->processorGraph->removeNode(id);
+    this->updateTailLength();
     this->sendChangeMessage();
 }
 
@@ -332,6 +811,7 @@ void Instrument::removeConnection(AudioProcessorGraph::Connection connection)
 
 void Instrument::reset()
 {
+    this->cancelLoading();
     PluginWindow::closeAllCurrentlyOpenWindows();
     this->processorGraph->clear();
     this->sendChangeMessage();
@@ -345,6 +825,15 @@ void Instrument::reset()
 ValueTree Instrument::serialize() const
 {
     using namespace Serialization;
+
+    if (this->isLoading())
+    {
+        ValueTree tree(this->loadingState.createCopy());
+        tree.setProperty(Audio::instrumentId, this->instrumentID.toString(), nullptr);
+        tree.setProperty(Audio::instrumentName, this->instrumentName, nullptr);
+        return tree;
+    }
+
     ValueTree tree(Audio::instrument);
     tree.setProperty(Audio::instrumentId, this->instrumentID.toString(), nullptr);
     tree.setProperty(Audio::instrumentName, this->instrumentName, nullptr);
@@ -408,11 +897,32 @@ void Instrument::deserialize(const ValueTree &tree)
         });
     }
     
+    int numNodes = 0;
+    forEachValueTreeChildWithType(root, e, Serialization::Audio::node)
+    {
+        ++numNodes;
+    }
+
+    if (numNodes == 0)
+    { return; }
+
+    // The nodes are loaded in parallel and arrive in any order,
+    // so the graph is only connected when the last one is there
+    this->loadingState = root.createCopy();
+    this->startLoading(numNodes);
+
     forEachValueTreeChildWithType(root, e, Serialization::Audio::node)
     {
         this->deserializeNodeAsync(e,
             [this, connectionDescriptions](AudioProcessorGraph::Node::Ptr)
             {
+                ++this->numNodesLoaded;
+                if (this->isLoading())
+                {
+                    this->sendChangeMessage();
+                    return;
+                }
+
                 // Try to create as many connections as possible
                 for (const auto &connectionInfo : connectionDescriptions)
                 {
@@ -421,6 +931,9 @@ void Instrument::deserialize(const ValueTree &tree)
                 }
                                          
                 this->processorGraph->removeIllegalConnections();
+                this->updateTailLength();
+                this->processorGraph->setMuted(false);
+                this->loadingState = {};
                 this->sendChangeMessage();
             });
     }
@@ -462,47 +975,47 @@ void Instrument::deserializeNodeAsync(const ValueTree &tree, AddNodeCallback f)
         if (pd.isValid()) { break; }
     }
     
-    MemoryBlock nodeStateBlock;
     const String state = tree.getProperty(Audio::pluginState);
-    if (state.isNotEmpty())
-    {
-        nodeStateBlock.fromBase64Encoding(state);
-    }
-    
     const int nodeUid = tree.getProperty(Audio::nodeId);
     const String nodeHash = tree.getProperty(Audio::nodeHash);
     const double nodeX = tree.getProperty(UI::positionX);
     const double nodeY = tree.getProperty(UI::positionY);
-    
-    formatManager.
-    createPluginInstanceAsync(pd,
-        this->processorGraph->getSampleRate(),
-        this->processorGraph->getBlockSize(),
-        [this, nodeStateBlock, nodeUid, nodeHash, nodeX, nodeY, f]
-        (AudioPluginInstance *instance, const String &error)
+
+    const WeakReference<Instrument> instrument(this);
+    const int generation = this->loadingGeneration;
+
+    auto addRestoredNode = [instrument, generation, nodeUid, nodeHash, nodeX, nodeY, f]
+        (AudioPluginInstance *restoredInstance)
+    {
+        ScopedPointer<AudioPluginInstance> instance(restoredInstance);
+
+        // the instrument has been deleted or reset in the meantime
+        if (instrument == nullptr || instrument->loadingGeneration != generation)
         {
-            if (instance == nullptr)
-            {
-                f(nullptr);
-                return;
-            }
+            return;
+        }
 
-            AudioProcessorGraph::Node::Ptr node(this->processorGraph->addNode(instance, nodeUid));
+        AudioProcessorGraph::Node::Ptr node = nullptr;
+        if (instance != nullptr)
+        {
+            node = instrument->processorGraph->addNode(instance.release(), nodeUid);
+        }
 
-            if (nodeStateBlock.getSize() > 0)
-            {
-                node->getProcessor()->
-                    setStateInformation(nodeStateBlock.getData(),
-                        static_cast<int>(nodeStateBlock.getSize()));
-            }
+        if (node == nullptr)
+        {
+            f(nullptr);
+            return;
+        }
 
-            Uuid fallbackRandomHash;
-            const auto hash = nodeHash.isNotEmpty() ? nodeHash : fallbackRandomHash.toString();
-            node->properties.set(Audio::nodeHash, hash);
-            node->properties.set(UI::positionX, nodeX);
-            node->properties.set(UI::positionY, nodeY);
-            f(node);
-        });
+        Uuid fallbackRandomHash;
+        const auto hash = nodeHash.isNotEmpty() ? nodeHash : fallbackRandomHash.toString();
+        node->properties.set(Audio::nodeHash, hash);
+        node->properties.set(UI::positionX, nodeX);
+        node->properties.set(UI::positionY, nodeY);
+        f(node);
+    };
+
+    this->loadingPool->addJob(new NodeLoadingJob(*this, pd, state, addRestoredNode), true);
 }
 
 void Instrument::deserializeNode(const ValueTree &tree)
@@ -545,6 +1058,35 @@ void Instrument::deserializeNode(const ValueTree &tree)
     node->properties.set(UI::positionX, tree.getProperty(UI::positionX));
     node->properties.set(UI::positionY, tree.getProperty(UI::positionY));
     node->properties.set(Audio::nodeHash, hash.isNotEmpty() ? hash : fallbackRandomHash.toString());
+    this->updateTailLength();
+}
+
+//===----------------------------------------------------------------------===//
+// Staged loading
+//===----------------------------------------------------------------------===//
+
+void Instrument::startLoading(int numNodes)
+{
+    this->numNodesToLoad = numNodes;
+    this->numNodesLoaded = 0;
+    this->processorGraph->setMuted(true);
+    this->sendChangeMessage();
+}
+
+void Instrument::cancelLoading()
+{
+    // the nodes still on their way will be dropped on arrival
+    ++this->loadingGeneration;
+    this->numNodesToLoad = 0;
+    this->numNodesLoaded = 0;
+    this->loadingState = {};
+
+    // only the jobs that haven't started are removed, since the message
+    // thread never waits for the pool; the running ones just finish
+    NodeLoadingJob::Selector selector(this);
+    this->loadingPool->removeAllJobs(false, 0, &selector);
+
+    this->processorGraph->setMuted(false);
 }
 
 void Instrument::initializeDefaultNodes()
@@ -601,4 +1143,20 @@ void Instrument::configureNode(AudioProcessorGraph::Node::Ptr node,
     node->properties.set(Serialization::Audio::nodeHash, nodeHash);
     node->properties.set(Serialization::UI::positionX, x);
     node->properties.set(Serialization::UI::positionY, y);
+    this->updateTailLength();
+}
+
+void Instrument::updateTailLength()
+{
+    double tailLength = 0.0;
+
+    for (int i = 0; i < this->processorGraph->getNumNodes(); ++i)
+    {
+        if (const auto *processor = this->processorGraph->getNode(i)->getProcessor())
+        {
+            tailLength = jmax(tailLength, processor->getTailLengthSeconds());
+        }
+    }
+
+    this->processorGraph->setTailLength(tailLength);
 }
@@ -18,9 +18,12 @@
 #pragma once
 
 class AudioCore;
+class AudioEngine;
 class FilterInGraph;
 class Instrument;
 
+#include "AudioLoadStats.h"
+
 
 class Instrument :
     public Serializable,
@@ -44,11 +47,32 @@ public:
     void addNodeToFreeSpace(const PluginDescription &pluginDescription, InitializationCallback initCallback);
 
     // gets connected to the audio-core device
-    AudioProcessorPlayer &getProcessorPlayer() noexcept
-    { return this->processorPlayer; }
+    AudioProcessorPlayer &getProcessorPlayer() noexcept;
+
+    // the time spent in the graph on each audio callback
+    const AudioLoadStats &getLoadStats() const noexcept;
+
+    AudioProcessorGraph *getProcessorGraph() noexcept;
 
-    AudioProcessorGraph *getProcessorGraph() noexcept
-    { return this->processorGraph; }
+    // True while the graph is skipped as silent and idle
+    bool isSuspended() const noexcept;
+
+    // True until all nodes of the deserialized graph are created and
+    // have their states restored; the graph is muted all this time,
+    // so the notes sent to the instrument meanwhile are dropped
+    bool isLoading() const noexcept;
+    float getLoadingProgress() const noexcept;
+
+    //===------------------------------------------------------------------===//
+    // Live input
+    //===------------------------------------------------------------------===//
+
+    // Queues a message from a midi device, timestamped in samples on the
+    // engine's clock, for the next audio block; never blocks, but expects
+    // one producer at a time, which is the midi input router's job.
+    // Only short messages are queued, and sysex is dropped
+    void addLiveInput(const MidiMessage &message, int64 samplePosition) noexcept;
+    void setLiveInputClock(const AudioEngine *engine) noexcept;
 
     //===------------------------------------------------------------------===//
     // Nodes
@@ -121,20 +145,49 @@ private:
     
     AudioProcessorGraph::Node::Ptr addDefaultNode(const PluginDescription &, double x, double y);
     void configureNode(AudioProcessorGraph::Node::Ptr, const PluginDescription &, double x, double y);
+    void updateTailLength();
 
     friend class Transport;
     friend class AudioCore;
+    friend class InstrumentTreeItem;
     
 private:
 
     AudioPluginFormatManager &formatManager;
-    AudioProcessorPlayer processorPlayer;
-    ScopedPointer<AudioProcessorGraph> processorGraph;
+
+    class LiveInputQueue;
+    ScopedPointer<LiveInputQueue> liveInput;
+
+    class TimedProcessorPlayer;
+    ScopedPointer<TimedProcessorPlayer> processorPlayer;
+
+    class SuspendableGraph;
+    ScopedPointer<SuspendableGraph> processorGraph;
 
     ValueTree serializeNode(AudioProcessorGraph::Node::Ptr node) const;
     void deserializeNode(const ValueTree &tree);
     void deserializeNodeAsync(const ValueTree &tree, AddNodeCallback f);
 
+    //===------------------------------------------------------------------===//
+    // Staged loading
+    //===------------------------------------------------------------------===//
+
+    class LoadingPool;
+    class NodeLoadingJob;
+    SharedResourcePointer<LoadingPool> loadingPool;
+
+    void startLoading(int numNodes);
+    void cancelLoading();
+
+    // only accessed from the message thread; the callbacks of the nodes
+    // loaded for the previous deserialization are told by the generation
+    int loadingGeneration;
+    int numNodesToLoad;
+    int numNodesLoaded;
+
+    // the graph is incomplete while loading, so this is saved instead
+    ValueTree loadingState;
+
 private:
 
     WeakReference<Instrument>::Master masterReference;
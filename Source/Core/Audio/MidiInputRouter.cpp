@@ -0,0 +1,185 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "MidiInputRouter.h"
+#include "AudioEngine.h"
+#include "Instrument.h"
+
+MidiInputRouter::MidiInputRouter(const AudioEngine &engine) :
+    engine(engine),
+    selectedInstrument(nullptr) {}
+
+Instrument *MidiInputRouter::getSelectedInstrument() const noexcept
+{
+    return this->selectedInstrument;
+}
+
+void MidiInputRouter::setSelectedInstrument(Instrument *instrument)
+{
+    const SpinLock::ScopedLockType lock(this->routingLock);
+    if (this->selectedInstrument != instrument)
+    {
+        this->releaseNotes(this->selectedInstrument);
+        this->selectedInstrument = instrument;
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Rules
+//===----------------------------------------------------------------------===//
+
+Array<MidiInputRouter::Rule> MidiInputRouter::getRules() const
+{
+    const SpinLock::ScopedLockType lock(this->routingLock);
+    return this->rules;
+}
+
+bool MidiInputRouter::hasRule(const String &deviceName, int channel, const Instrument *instrument) const
+{
+    const SpinLock::ScopedLockType lock(this->routingLock);
+    for (const auto &rule : this->rules)
+    {
+        if (rule.deviceName == deviceName && rule.channel == channel && rule.instrument == instrument)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void MidiInputRouter::addRule(const String &deviceName, int channel, Instrument *instrument)
+{
+    jassert(instrument != nullptr);
+    jassert(channel >= 0 && channel <= 16);
+
+    const SpinLock::ScopedLockType lock(this->routingLock);
+    this->rules.add({ deviceName, channel, instrument });
+}
+
+void MidiInputRouter::removeRule(const String &deviceName, int channel, Instrument *instrument)
+{
+    const SpinLock::ScopedLockType lock(this->routingLock);
+    for (int i = this->rules.size(); --i >= 0;)
+    {
+        const auto &rule = this->rules.getReference(i);
+        if (rule.deviceName == deviceName && rule.channel == channel && rule.instrument == instrument)
+        {
+            this->rules.remove(i);
+        }
+    }
+
+    this->releaseNotes(instrument);
+}
+
+void MidiInputRouter::clearRules()
+{
+    const SpinLock::ScopedLockType lock(this->routingLock);
+    for (const auto &rule : this->rules)
+    {
+        this->releaseNotes(rule.instrument);
+    }
+
+    this->rules.clear();
+}
+
+void MidiInputRouter::removeInstrument(Instrument *instrument)
+{
+    const SpinLock::ScopedLockType lock(this->routingLock);
+    for (int i = this->rules.size(); --i >= 0;)
+    {
+        if (this->rules.getReference(i).instrument == instrument)
+        {
+            this->rules.remove(i);
+        }
+    }
+
+    if (this->selectedInstrument == instrument)
+    {
+        this->selectedInstrument = nullptr;
+    }
+}
+
+// Expects the routing lock to be held, as the instrument's queue
+// takes one producer at a time
+void MidiInputRouter::releaseNotes(Instrument *instrument) const
+{
+    if (instrument == nullptr)
+    {
+        return;
+    }
+
+    const int64 samplePosition = this->engine.getSamplePositionAt(Time::getMillisecondCounterHiRes());
+    for (int channel = 1; channel <= 16; ++channel)
+    {
+        instrument->addLiveInput(MidiMessage::controllerEvent(channel, 64, 0), samplePosition);
+        instrument->addLiveInput(MidiMessage::allNotesOff(channel), samplePosition);
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// MidiInputCallback
+//===----------------------------------------------------------------------===//
+
+void MidiInputRouter::handleIncomingMidiMessage(MidiInput *source, const MidiMessage &message)
+{
+    if (message.isSysEx() || message.isActiveSense())
+    {
+        return;
+    }
+
+    // the input devices timestamp their messages in seconds of the hi-res counter
+    const int64 samplePosition = this->engine.getSamplePositionAt(message.getTimeStamp() * 1000.0);
+    const String deviceName = (source != nullptr) ? source->getName() : String::empty;
+    const int channel = message.getChannel();
+
+    const SpinLock::ScopedLockType lock(this->routingLock);
+
+    bool hasMatches = false;
+    for (int i = 0; i < this->rules.size(); ++i)
+    {
+        const auto &rule = this->rules.getReference(i);
+        if ((rule.deviceName.isNotEmpty() && rule.deviceName != deviceName) ||
+            (rule.channel != 0 && rule.channel != channel))
+        {
+            continue;
+        }
+
+        // several rules may target the same instrument, which needs the message once
+        bool isDuplicate = false;
+        for (int j = 0; j < i && !isDuplicate; ++j)
+        {
+            const auto &previous = this->rules.getReference(j);
+            isDuplicate = previous.instrument == rule.instrument &&
+                (previous.deviceName.isEmpty() || previous.deviceName == deviceName) &&
+                (previous.channel == 0 || previous.channel == channel);
+        }
+
+        if (!isDuplicate)
+        {
+            rule.instrument->addLiveInput(message, samplePosition);
+        }
+
+        hasMatches = true;
+    }
+
+    if (!hasMatches && this->selectedInstrument != nullptr)
+    {
+        this->selectedInstrument->addLiveInput(message, samplePosition);
+    }
+}
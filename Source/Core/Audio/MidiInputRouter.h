@@ -0,0 +1,82 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+class AudioEngine;
+class Instrument;
+
+// The single midi input callback for all devices.
+//
+// Each message is timestamped in samples on the audio engine's clock and
+// handed over to the instruments matched by the routing rules, or, if none
+// of the rules match, to the selected instrument only, i.e. the instrument
+// of the track being edited; the instruments pick the messages up from
+// their lock-free queues on the next audio block.
+//
+// Whenever an instrument stops receiving the input, it gets all notes
+// and the sustain released, so that no keys held at that moment get stuck.
+//
+// The routing is only locked against the midi threads of other devices
+// and the changes made from the message thread, never the audio thread.
+class MidiInputRouter final : public MidiInputCallback
+{
+public:
+
+    explicit MidiInputRouter(const AudioEngine &engine);
+
+    // Sends the input from the device, or from any device, if the name
+    // is empty, on the channel, or on any channel, if it is 0,
+    // to the instrument; all matching rules apply
+    struct Rule final
+    {
+        String deviceName;
+        int channel;
+        Instrument *instrument;
+    };
+
+    Instrument *getSelectedInstrument() const noexcept;
+    void setSelectedInstrument(Instrument *instrument);
+
+    Array<Rule> getRules() const;
+    bool hasRule(const String &deviceName, int channel, const Instrument *instrument) const;
+    void addRule(const String &deviceName, int channel, Instrument *instrument);
+    void removeRule(const String &deviceName, int channel, Instrument *instrument);
+    void clearRules();
+
+    // Forgets the instrument in the rules and the selection,
+    // must be called before the instrument is deleted
+    void removeInstrument(Instrument *instrument);
+
+    //===------------------------------------------------------------------===//
+    // MidiInputCallback
+    //===------------------------------------------------------------------===//
+
+    void handleIncomingMidiMessage(MidiInput *source, const MidiMessage &message) override;
+
+private:
+
+    void releaseNotes(Instrument *instrument) const;
+
+    const AudioEngine &engine;
+
+    SpinLock routingLock;
+    Array<Rule> rules;
+    Instrument *selectedInstrument;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiInputRouter)
+};
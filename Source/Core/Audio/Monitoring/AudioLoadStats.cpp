@@ -0,0 +1,93 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "AudioLoadStats.h"
+
+#define AUDIO_LOAD_SMOOTHING 0.1f
+#define AUDIO_LOAD_PEAK_DECAY 0.995f
+#define AUDIO_LOAD_FIRST_BUCKET_US 32.0
+
+AudioLoadStats::AudioLoadStats() :
+    numMeasurements(0),
+    numOverruns(0),
+    averageLoad(0.f),
+    peakLoad(0.f)
+{
+    for (auto &bucket : this->histogram)
+    {
+        bucket = 0;
+    }
+}
+
+void AudioLoadStats::addMeasurement(double processingMs, double budgetMs) noexcept
+{
+    // Only the audio thread writes here, so plain loads and stores will do
+    const float load = budgetMs > 0.0 ? float(processingMs / budgetMs) : 0.f;
+    const float average = this->averageLoad.get();
+    this->averageLoad = average + AUDIO_LOAD_SMOOTHING * (load - average);
+    this->peakLoad = jmax(load, this->peakLoad.get() * AUDIO_LOAD_PEAK_DECAY);
+
+    if (load > 1.f)
+    {
+        ++this->numOverruns;
+    }
+
+    int bucket = 0;
+    double bucketLimitUs = AUDIO_LOAD_FIRST_BUCKET_US;
+    while (bucket < AUDIO_LOAD_HISTOGRAM_SIZE - 1 && processingMs * 1000.0 > bucketLimitUs)
+    {
+        bucketLimitUs *= 2.0;
+        ++bucket;
+    }
+
+    ++this->histogram[bucket];
+    ++this->numMeasurements;
+}
+
+int AudioLoadStats::getNumMeasurements() const noexcept
+{
+    return this->numMeasurements.get();
+}
+
+int AudioLoadStats::getNumOverruns() const noexcept
+{
+    return this->numOverruns.get();
+}
+
+float AudioLoadStats::getAverageLoad() const noexcept
+{
+    return this->averageLoad.get();
+}
+
+float AudioLoadStats::getPeakLoad() const noexcept
+{
+    return this->peakLoad.get();
+}
+
+int AudioLoadStats::getHistogramValue(int bucket) const noexcept
+{
+    jassert(bucket >= 0 && bucket < AUDIO_LOAD_HISTOGRAM_SIZE);
+    return this->histogram[bucket].get();
+}
+
+String AudioLoadStats::getHistogramBucketName(int bucket)
+{
+    const int limitUs = int(AUDIO_LOAD_FIRST_BUCKET_US) << jmin(bucket, AUDIO_LOAD_HISTOGRAM_SIZE - 2);
+    const String limit = limitUs < 1000 ? String(limitUs) + "us" : String(limitUs / 1000) + "ms";
+    return (bucket < AUDIO_LOAD_HISTOGRAM_SIZE - 1) ? ("<" + limit) : (">" + limit);
+}
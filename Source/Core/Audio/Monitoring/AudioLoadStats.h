@@ -0,0 +1,56 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define AUDIO_LOAD_HISTOGRAM_SIZE 12
+
+// Processing time statistics of an audio callback, relative to its deadline
+// (i.e. the duration of the buffer it's processing). Measurements are only
+// added from the audio thread, and can be read from any thread without locks.
+class AudioLoadStats final
+{
+public:
+
+    AudioLoadStats();
+
+    void addMeasurement(double processingMs, double budgetMs) noexcept;
+
+    int getNumMeasurements() const noexcept;
+    int getNumOverruns() const noexcept;
+
+    // 1.0 means the whole buffer duration
+    float getAverageLoad() const noexcept;
+    float getPeakLoad() const noexcept;
+
+    // Buckets are powers of two of microseconds,
+    // from 32us and less up to more than 32ms
+    int getHistogramValue(int bucket) const noexcept;
+    static String getHistogramBucketName(int bucket);
+
+private:
+
+    Atomic<int> numMeasurements;
+    Atomic<int> numOverruns;
+
+    Atomic<float> averageLoad;
+    Atomic<float> peakLoad;
+
+    Atomic<int> histogram[AUDIO_LOAD_HISTOGRAM_SIZE];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioLoadStats)
+};
@@ -19,6 +19,7 @@
 #include "AudioMonitor.h"
 #include "AudioCore.h"
 #include "AudiobusOutput.h"
+#include "PerformanceTrace.h"
 
 #define AUDIO_MONITOR_SPECTRUM_SIZE                 512
 #define AUDIO_MONITOR_DEFAULT_SAMPLERATE            44100
@@ -69,7 +70,8 @@ private:
 AudioMonitor::AudioMonitor() :
     fft(),
     spectrumSize(AUDIO_MONITOR_SPECTRUM_SIZE),
-    sampleRate(AUDIO_MONITOR_DEFAULT_SAMPLERATE)
+    sampleRate(AUDIO_MONITOR_DEFAULT_SAMPLERATE),
+    cycleProcessingTicks(0)
 {
     zeromem(this->spectrum, sizeof(float) * AUDIO_MONITOR_MAX_CHANNELS * AUDIO_MONITOR_MAX_SPECTRUMSIZE);
     this->asyncClippingWarning = new ClippingWarningAsyncCallback(*this);
@@ -96,6 +98,9 @@ void AudioMonitor::audioDeviceIOCallback(const float **inputChannelData,
                                          int numOutputChannels,
                                          int numSamples)
 {
+    TRACE_SPAN("Audio monitor");
+    const int64 startTicks = Time::getHighResolutionTicks();
+
     const int numChannels =
     jmin(AUDIO_MONITOR_MAX_CHANNELS, numOutputChannels);
     
@@ -141,6 +146,14 @@ void AudioMonitor::audioDeviceIOCallback(const float **inputChannelData,
     {
         FloatVectorOperations::clear(outputChannelData[i], numSamples);
     }
+
+    // The monitor is called once per device callback, so whatever
+    // the engine has reported since the last call is one cycle's worth
+    const int64 ticks = this->cycleProcessingTicks.exchange(0) +
+        (Time::getHighResolutionTicks() - startTicks);
+
+    const double budgetMs = numSamples * 1000.0 / this->sampleRate.get();
+    this->loadStats.addMeasurement(Time::highResolutionTicksToSeconds(ticks) * 1000.0, budgetMs);
 }
 
 void AudioMonitor::audioDeviceStopped()
@@ -172,6 +185,20 @@ float AudioMonitor::getInterpolatedSpectrumAtFrequency(float frequency) const
                  (AudioCore::fastLog10(f2) - AudioCore::fastLog10(f1))) * (y2 - y1);
 }
 
+//===----------------------------------------------------------------------===//
+// Load data
+//===----------------------------------------------------------------------===//
+
+void AudioMonitor::addProcessingTime(int64 ticks) noexcept
+{
+    this->cycleProcessingTicks += ticks;
+}
+
+const AudioLoadStats &AudioMonitor::getLoadStats() const noexcept
+{
+    return this->loadStats;
+}
+
 //===----------------------------------------------------------------------===//
 // Clipping data
 //===----------------------------------------------------------------------===//
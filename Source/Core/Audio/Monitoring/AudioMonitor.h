@@ -18,6 +18,7 @@
 #pragma once
 
 #include "SpectrumAnalyzer.h"
+#include "AudioLoadStats.h"
 
 #define AUDIO_MONITOR_MAX_CHANNELS      2
 #define AUDIO_MONITOR_MAX_SPECTRUMSIZE  512
@@ -69,6 +70,16 @@ public:
     //===------------------------------------------------------------------===//
     
     float getInterpolatedSpectrumAtFrequency(float frequency) const;
+
+    //===------------------------------------------------------------------===//
+    // Load data
+    //===------------------------------------------------------------------===//
+
+    // The audio engine reports the wall time of its blocks, which is
+    // added up with the monitor's own time into the device callback load;
+    // the instruments run in parallel, so their times can't be summed up
+    void addProcessingTime(int64 ticks) noexcept;
+    const AudioLoadStats &getLoadStats() const noexcept;
     
 private:
 
@@ -81,6 +92,9 @@ private:
     Atomic<int> spectrumSize;
     Atomic<double> sampleRate;
 
+    Atomic<int64> cycleProcessingTicks;
+    AudioLoadStats loadStats;
+
     ListenerList<ClippingListener> clippingListeners;
 
     ScopedPointer<AsyncUpdater> asyncClippingWarning;
@@ -0,0 +1,146 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "PerformanceTrace.h"
+
+// The slot is being written by someone
+#define TRACE_SPAN_BUSY (-1)
+
+struct TraceSpan final
+{
+    // Zero for an empty slot, busy while the slot is being written,
+    // otherwise the write index + 1, so that the reader can tell
+    // if the slot has changed while copying
+    Atomic<int64> sequence;
+
+    // all fields are atomic, since the reader may copy them
+    // at the same time a writer overwrites the slot
+    Atomic<const char *> name;
+    Atomic<Thread::ThreadID> threadId;
+    Atomic<int64> startTicks;
+    Atomic<int64> endTicks;
+};
+
+static TraceSpan traceSpans[PERFORMANCE_TRACE_CAPACITY];
+static Atomic<int64> traceWriteIndex(0);
+static Atomic<int> traceEnabled(0);
+
+void PerformanceTrace::setEnabled(bool shouldBeEnabled) noexcept
+{
+    traceEnabled = shouldBeEnabled ? 1 : 0;
+}
+
+bool PerformanceTrace::isEnabled() noexcept
+{
+    return traceEnabled.get() != 0;
+}
+
+void PerformanceTrace::addSpan(const char *name, int64 startTicks, int64 endTicks) noexcept
+{
+    const int64 index = traceWriteIndex++;
+    auto &span = traceSpans[index % PERFORMANCE_TRACE_CAPACITY];
+
+    // a writer that has wrapped around the whole buffer may still be
+    // writing to this slot, and then this span is dropped, not waited for
+    const int64 previousSequence = span.sequence.get();
+    if (previousSequence == TRACE_SPAN_BUSY ||
+        !span.sequence.compareAndSetBool(TRACE_SPAN_BUSY, previousSequence))
+    {
+        return;
+    }
+
+    span.name = name;
+    span.threadId = Thread::getCurrentThreadId();
+    span.startTicks = startTicks;
+    span.endTicks = endTicks;
+    span.sequence = index + 1;
+}
+
+bool PerformanceTrace::saveAsChromeTrace(const File &file)
+{
+    struct SpanCopy final
+    {
+        const char *name;
+        Thread::ThreadID threadId;
+        int64 startTicks;
+        int64 endTicks;
+    };
+
+    Array<SpanCopy> spans;
+    spans.ensureStorageAllocated(PERFORMANCE_TRACE_CAPACITY);
+
+    for (const auto &span : traceSpans)
+    {
+        const int64 sequence = span.sequence.get();
+        if (sequence <= 0)
+        {
+            continue;
+        }
+
+        const SpanCopy copy = { span.name.get(), span.threadId.get(),
+            span.startTicks.get(), span.endTicks.get() };
+        if (span.sequence.get() == sequence)
+        {
+            spans.add(copy);
+        }
+    }
+
+    if (spans.isEmpty())
+    {
+        return false;
+    }
+
+    int64 firstTicks = spans.getFirst().startTicks;
+    for (const auto &span : spans)
+    {
+        firstTicks = jmin(firstTicks, span.startTicks);
+    }
+
+    // Chrome wants small thread ids, and microseconds for timestamps
+    Array<Thread::ThreadID> threads;
+    const double usPerTick = 1000000.0 / double(Time::getHighResolutionTicksPerSecond());
+
+    FileOutputStream stream(file);
+    if (!stream.openedOk())
+    {
+        return false;
+    }
+
+    stream.setPosition(0);
+    stream.truncate();
+    stream << "{\"traceEvents\":[";
+
+    bool isFirstEvent = true;
+    for (const auto &span : spans)
+    {
+        threads.addIfNotAlreadyThere(span.threadId);
+        const int tid = threads.indexOf(span.threadId) + 1;
+        const double ts = double(span.startTicks - firstTicks) * usPerTick;
+        const double dur = double(span.endTicks - span.startTicks) * usPerTick;
+
+        stream << (isFirstEvent ? "\n" : ",\n")
+            << "{\"name\":\"" << span.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+            << ",\"ts\":" << String(ts, 3) << ",\"dur\":" << String(dur, 3) << "}";
+
+        isFirstEvent = false;
+    }
+
+    stream << "\n]}\n";
+    stream.flush();
+    return stream.getStatus().wasOk();
+}
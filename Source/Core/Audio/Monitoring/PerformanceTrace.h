@@ -0,0 +1,69 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define PERFORMANCE_TRACE_CAPACITY (1 << 16)
+
+// Collects the timings of the code blocks marked with TRACE_SPAN into a ring
+// buffer, which can be saved as a Chrome trace file (see chrome://tracing).
+// Recording a span is wait-free, so it's safe to use on the audio thread;
+// when tracing is disabled, a span costs a single atomic read.
+class PerformanceTrace final
+{
+public:
+
+    static void setEnabled(bool shouldBeEnabled) noexcept;
+    static bool isEnabled() noexcept;
+
+    // Span names are expected to be string literals
+    static void addSpan(const char *name, int64 startTicks, int64 endTicks) noexcept;
+
+    static bool saveAsChromeTrace(const File &file);
+
+    class ScopedSpan final
+    {
+    public:
+
+        explicit ScopedSpan(const char *name) noexcept :
+            name(PerformanceTrace::isEnabled() ? name : nullptr),
+            startTicks(this->name != nullptr ? Time::getHighResolutionTicks() : 0) {}
+
+        ~ScopedSpan() noexcept
+        {
+            if (this->name != nullptr)
+            {
+                PerformanceTrace::addSpan(this->name,
+                    this->startTicks, Time::getHighResolutionTicks());
+            }
+        }
+
+    private:
+
+        const char *const name;
+        const int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedSpan)
+    };
+
+private:
+
+    JUCE_DECLARE_NON_COPYABLE(PerformanceTrace)
+};
+
+#define TRACE_SPAN(name) \
+    const PerformanceTrace::ScopedSpan JUCE_JOIN_MACRO(traceSpan, __LINE__)(name)
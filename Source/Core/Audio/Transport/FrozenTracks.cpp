@@ -0,0 +1,381 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "FrozenTracks.h"
+#include "Transport.h"
+#include "Instrument.h"
+#include "RendererThread.h"
+#include "MidiTrack.h"
+#include "MidiSequence.h"
+#include "DocumentHelpers.h"
+#include "App.h"
+#include "Workspace.h"
+#include "AudioCore.h"
+
+// Wait a bit after the last change before rendering again,
+// so that the track is not re-rendered on every edit
+#define FROZEN_TRACKS_RENDER_DELAY_MS 2000
+
+#define FROZEN_TRACKS_READ_AHEAD_SAMPLES 32768
+
+FrozenTracks::FrozenTracks(Transport &parentTransport) :
+    transport(parentTransport),
+    trackBeingRendered(nullptr),
+    readAheadThread("Frozen tracks reader"),
+    isAddedToDevice(false)
+{
+    this->renderer = new RendererThread(parentTransport);
+    this->formatManager.registerBasicFormats();
+    this->sourcePlayer.setSource(&this->mixer);
+}
+
+FrozenTracks::~FrozenTracks()
+{
+    this->cancelRendering();
+    this->stopTimer();
+    this->renderer = nullptr;
+
+    if (this->isAddedToDevice)
+    {
+        App::Workspace().getAudioCore().getDevice().removeAudioCallback(&this->sourcePlayer);
+    }
+
+    this->sourcePlayer.setSource(nullptr);
+    this->mixer.removeAllInputs();
+    this->readAheadThread.stopThread(500);
+
+    for (auto *frozenTrack : this->tracks)
+    {
+        this->dropAudio(*frozenTrack);
+    }
+
+    this->masterReference.clear();
+}
+
+//===----------------------------------------------------------------------===//
+// Message thread
+//===----------------------------------------------------------------------===//
+
+void FrozenTracks::freeze(const MidiTrack *track)
+{
+    if (this->findTrack(track) != nullptr)
+    {
+        return;
+    }
+
+    auto frozenTrack = new FrozenTrack();
+    frozenTrack->track = track;
+    frozenTrack->isReady = false;
+    frozenTrack->isMuted = track->isTrackMuted();
+    frozenTrack->file = File(DocumentHelpers::getTemporaryFolder())
+        .getChildFile("Frozen").getChildFile(track->getTrackId().toString() + ".wav");
+
+    {
+        const ScopedLock lock(this->tracksLock);
+        this->tracks.add(frozenTrack);
+    }
+
+    this->startTimer(FROZEN_TRACKS_RENDER_DELAY_MS);
+}
+
+void FrozenTracks::unfreeze(const MidiTrack *track)
+{
+    if (auto *frozenTrack = this->findTrack(track))
+    {
+        if (this->trackBeingRendered == track)
+        {
+            this->cancelRendering();
+        }
+
+        this->dropAudio(*frozenTrack);
+
+        const ScopedLock lock(this->tracksLock);
+        this->tracks.removeObject(frozenTrack);
+    }
+}
+
+void FrozenTracks::unfreezeAllExcept(const Array<MidiTrack *> &tracksToKeep)
+{
+    for (int i = this->tracks.size(); --i >= 0;)
+    {
+        const auto *track = this->tracks.getUnchecked(i)->track;
+        if (!tracksToKeep.contains(const_cast<MidiTrack *>(track)))
+        {
+            this->unfreeze(track);
+        }
+    }
+}
+
+void FrozenTracks::updateMuteState(const MidiTrack *track)
+{
+    if (auto *frozenTrack = this->findTrack(track))
+    {
+        const ScopedLock lock(this->tracksLock);
+        frozenTrack->isMuted = track->isTrackMuted();
+    }
+}
+
+void FrozenTracks::invalidate(const MidiTrack *track)
+{
+    if (auto *frozenTrack = this->findTrack(track))
+    {
+        if (this->trackBeingRendered == track)
+        {
+            this->cancelRendering();
+        }
+
+        const bool wasStreamed = frozenTrack->isReady;
+        this->dropAudio(*frozenTrack);
+        this->startTimer(FROZEN_TRACKS_RENDER_DELAY_MS);
+
+        // the track's events have to be played live again
+        if (wasStreamed)
+        {
+            this->transport.onTrackFreezeChanged(track);
+        }
+    }
+}
+
+void FrozenTracks::invalidateAll()
+{
+    for (auto *frozenTrack : this->tracks)
+    {
+        this->invalidate(frozenTrack->track);
+    }
+}
+
+bool FrozenTracks::isFrozen(const MidiTrack *track) const
+{
+    return this->findTrack(track) != nullptr;
+}
+
+void FrozenTracks::cancelRendering()
+{
+    if (this->trackBeingRendered == nullptr)
+    {
+        return;
+    }
+
+    this->renderer->stop();
+    this->trackBeingRendered = nullptr;
+    this->reattachRenderedInstrument();
+
+    // the track is still not ready, so try again later
+    this->startTimer(FROZEN_TRACKS_RENDER_DELAY_MS);
+}
+
+bool FrozenTracks::isStreamed(const MidiTrack *track) const
+{
+    const auto *frozenTrack = this->findTrack(track);
+    return frozenTrack != nullptr && frozenTrack->isReady;
+}
+
+FrozenTracks::FrozenTrack *FrozenTracks::findTrack(const MidiTrack *track) const
+{
+    for (auto *frozenTrack : this->tracks)
+    {
+        if (frozenTrack->track == track)
+        {
+            return frozenTrack;
+        }
+    }
+
+    return nullptr;
+}
+
+void FrozenTracks::dropAudio(FrozenTrack &frozenTrack)
+{
+    if (frozenTrack.transportSource != nullptr)
+    {
+        this->mixer.removeInputSource(frozenTrack.transportSource);
+    }
+
+    {
+        const ScopedLock lock(this->tracksLock);
+        frozenTrack.isReady = false;
+        frozenTrack.transportSource = nullptr;
+        frozenTrack.readerSource = nullptr;
+    }
+
+    frozenTrack.file.deleteFile();
+}
+
+//===----------------------------------------------------------------------===//
+// Rendering
+//===----------------------------------------------------------------------===//
+
+void FrozenTracks::timerCallback()
+{
+    // the renderer needs the instruments for itself
+    if (this->trackBeingRendered != nullptr ||
+        this->transport.isPlaying() ||
+        this->transport.isRendering())
+    {
+        return;
+    }
+
+    for (auto *frozenTrack : this->tracks)
+    {
+        if (!frozenTrack->isReady)
+        {
+            this->startRendering(*frozenTrack);
+            return;
+        }
+    }
+
+    this->stopTimer();
+}
+
+void FrozenTracks::startRendering(FrozenTrack &frozenTrack)
+{
+    frozenTrack.file.getParentDirectory().createDirectory();
+
+    const auto track = frozenTrack.track;
+    this->trackBeingRendered = track;
+
+    // only the track's own instrument is taken off the device,
+    // the others keep playing live input and the like
+    if (auto *instrument = this->transport.findInstrumentFor(track))
+    {
+        this->instrumentBeingRendered = instrument->getIdAndHash();
+        App::Workspace().getAudioCore().mute(instrument);
+    }
+
+    WeakReference<FrozenTracks> weakThis(this);
+    this->renderer->startRecording(frozenTrack.file, track->getSequence(),
+        [weakThis, track](bool succeeded)
+        {
+            if (weakThis != nullptr)
+            {
+                weakThis->onRenderFinished(track, succeeded);
+            }
+        });
+}
+
+void FrozenTracks::onRenderFinished(const MidiTrack *track, bool succeeded)
+{
+    if (this->trackBeingRendered != track)
+    {
+        return; // cancelled in the meantime
+    }
+
+    this->trackBeingRendered = nullptr;
+    this->reattachRenderedInstrument();
+
+    auto *frozenTrack = this->findTrack(track);
+    if (!succeeded || frozenTrack == nullptr)
+    {
+        return;
+    }
+
+    AudioFormatReader *reader = this->formatManager.createReaderFor(frozenTrack->file);
+    if (reader == nullptr)
+    {
+        return;
+    }
+
+    const double sampleRate = reader->sampleRate;
+    auto readerSource = new AudioFormatReaderSource(reader, true);
+    auto transportSource = new AudioTransportSource();
+    transportSource->setSource(readerSource,
+        FROZEN_TRACKS_READ_AHEAD_SAMPLES, &this->readAheadThread, sampleRate);
+
+    {
+        const ScopedLock lock(this->tracksLock);
+        frozenTrack->readerSource = readerSource;
+        frozenTrack->transportSource = transportSource;
+        frozenTrack->isReady = true;
+    }
+
+    this->mixer.addInputSource(transportSource, false);
+
+    if (!this->readAheadThread.isThreadRunning())
+    {
+        this->readAheadThread.startThread(3);
+    }
+
+    if (!this->isAddedToDevice)
+    {
+        App::Workspace().getAudioCore().getDevice().addAudioCallback(&this->sourcePlayer);
+        this->isAddedToDevice = true;
+    }
+
+    // from now on, the track's events are not sent to the instrument
+    this->transport.onTrackFreezeChanged(track);
+
+    // and maybe there are more tracks to render
+    this->startTimer(FROZEN_TRACKS_RENDER_DELAY_MS);
+}
+
+void FrozenTracks::reattachRenderedInstrument()
+{
+    if (this->instrumentBeingRendered.isEmpty())
+    {
+        return;
+    }
+
+    // the instrument might have been removed in the meantime
+    auto &audioCore = App::Workspace().getAudioCore();
+    if (auto *instrument = audioCore.findInstrumentById(this->instrumentBeingRendered))
+    {
+        audioCore.unmute(instrument);
+    }
+
+    this->instrumentBeingRendered.clear();
+}
+
+//===----------------------------------------------------------------------===//
+// Player thread
+//===----------------------------------------------------------------------===//
+
+void FrozenTracks::startStreaming(double timeMs)
+{
+    const ScopedLock lock(this->tracksLock);
+    for (auto *frozenTrack : this->tracks)
+    {
+        if (frozenTrack->isReady && !frozenTrack->isMuted)
+        {
+            frozenTrack->transportSource->setPosition(timeMs / 1000.0);
+            frozenTrack->transportSource->start();
+        }
+    }
+}
+
+void FrozenTracks::seekStreaming(double timeMs)
+{
+    const ScopedLock lock(this->tracksLock);
+    for (auto *frozenTrack : this->tracks)
+    {
+        if (frozenTrack->isReady)
+        {
+            frozenTrack->transportSource->setPosition(timeMs / 1000.0);
+        }
+    }
+}
+
+void FrozenTracks::stopStreaming()
+{
+    const ScopedLock lock(this->tracksLock);
+    for (auto *frozenTrack : this->tracks)
+    {
+        if (frozenTrack->isReady)
+        {
+            frozenTrack->transportSource->stop();
+        }
+    }
+}
@@ -0,0 +1,107 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+class Transport;
+class RendererThread;
+class MidiTrack;
+
+// Frozen tracks are pre-rendered to audio files, which are then streamed
+// during the playback instead of sending their events to the instruments.
+//
+// A track is only rendered while the transport is idle, since the renderer
+// needs the track's instrument all to itself: the instrument is detached from
+// the device during the render, and the render is cancelled when the playback
+// or the export starts. Until the render is ready, or after the track
+// (or its instrument, or the tempo) has changed, it is played live.
+class FrozenTracks final : private Timer
+{
+public:
+
+    explicit FrozenTracks(Transport &transport);
+    ~FrozenTracks() override;
+
+    //===------------------------------------------------------------------===//
+    // Message thread
+    //===------------------------------------------------------------------===//
+
+    void freeze(const MidiTrack *track);
+    void unfreeze(const MidiTrack *track);
+    void unfreezeAllExcept(const Array<MidiTrack *> &tracksToKeep);
+    void updateMuteState(const MidiTrack *track);
+
+    // Drop the rendered audio, which is going to be re-rendered later
+    void invalidate(const MidiTrack *track);
+    void invalidateAll();
+
+    bool isFrozen(const MidiTrack *track) const;
+
+    // Stops the current render, if any; it will start over when idle
+    void cancelRendering();
+
+    // True if the track's audio is ready, and its events should not be played
+    bool isStreamed(const MidiTrack *track) const;
+
+    //===------------------------------------------------------------------===//
+    // Player thread
+    //===------------------------------------------------------------------===//
+
+    void startStreaming(double timeMs);
+    void seekStreaming(double timeMs);
+    void stopStreaming();
+
+private:
+
+    struct FrozenTrack final
+    {
+        const MidiTrack *track;
+        File file;
+        bool isReady;
+        bool isMuted;
+        ScopedPointer<AudioFormatReaderSource> readerSource;
+        ScopedPointer<AudioTransportSource> transportSource;
+    };
+
+    FrozenTrack *findTrack(const MidiTrack *track) const;
+    void dropAudio(FrozenTrack &frozenTrack);
+
+    void timerCallback() override;
+    void startRendering(FrozenTrack &frozenTrack);
+    void onRenderFinished(const MidiTrack *track, bool succeeded);
+    void reattachRenderedInstrument();
+
+    Transport &transport;
+
+    CriticalSection tracksLock;
+    OwnedArray<FrozenTrack> tracks;
+    const MidiTrack *trackBeingRendered;
+    String instrumentBeingRendered;
+
+    ScopedPointer<RendererThread> renderer;
+    AudioFormatManager formatManager;
+
+    TimeSliceThread readAheadThread;
+    MixerAudioSource mixer;
+    AudioSourcePlayer sourcePlayer;
+    bool isAddedToDevice;
+
+    WeakReference<FrozenTracks>::Master masterReference;
+    friend class WeakReference<FrozenTracks>;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrozenTracks)
+};
@@ -19,8 +19,10 @@
 #include <float.h>
 
 #include "PlayerThread.h"
+#include "FrozenTracks.h"
 #include "Instrument.h"
 #include "MidiSequence.h"
+#include "PerformanceTrace.h"
 
 #define MINIMUM_STOP_CHECK_TIME_MS 1000
 
@@ -75,6 +77,11 @@ void PlayerThread::run()
     
     sequences.seekToTime(startPositionInTime);
     double prevTimeStamp = startPositionInTime;
+
+    // Frozen tracks are rendered from the very beginning,
+    // so they are positioned by the real time, not by the beat
+    const double startTimeMs = currentTimeMs;
+    FrozenTracks &frozenTracks = *this->transport.frozenTracks;
     
     // This hack is here to keep track of still playing events
     // to be able to send noteOff's when playback interrupts.
@@ -98,8 +105,10 @@ void PlayerThread::run()
         }
     };
 
-    auto sendHoldingNotesOffAndMidiStop = [&holdingNotes, &uniqueInstruments]()
+    auto sendHoldingNotesOffAndMidiStop = [&holdingNotes, &uniqueInstruments, &frozenTracks]()
     {
+        frozenTracks.stopStreaming();
+
         for (const auto &holding : holdingNotes)
         {
             MidiMessage noteOff(MidiMessage::noteOff(holding.channel, holding.key, 0.f));
@@ -129,6 +138,7 @@ void PlayerThread::run()
     
     // And here we go.
     sendMidiStart();
+    frozenTracks.startStreaming(startTimeMs);
     
     while (1)
     {
@@ -159,6 +169,7 @@ void PlayerThread::run()
                 //Logger::writeToLog("Seek to time " + String(startPositionInTime));
                 sequences.seekToTime(startPositionInTime);
                 prevTimeStamp = startPositionInTime;
+                frozenTracks.seekStreaming(startTimeMs);
                 continue;
             }
             else
@@ -220,9 +231,12 @@ void PlayerThread::run()
         {
             sequences.seekToTime(startPositionInTime);
             prevTimeStamp = startPositionInTime;
+            frozenTracks.seekStreaming(startTimeMs);
         }
         else
         {
+            TRACE_SPAN("Player dispatch");
+
             const int key = wrapper.message.getNoteNumber();
             const int channel = wrapper.message.getChannel();
             wrapper.message.setTimeStamp(Time::getMillisecondCounterHiRes() * 0.001);
@@ -240,13 +254,13 @@ void PlayerThread::run()
                 // Sends this to everybody (need to do that for drum-machines) - TODO test
                 sendTempoChangeToEverybody(wrapper.message);
             }
-            else
+            else if (!wrapper.isFrozen)
             {
                 //Logger::writeToLog(String(wrapper.message.getNoteNumber()));
                 wrapper.listener->addMessageToQueue(wrapper.message);
             }
             
-            if (wrapper.message.isNoteOn())
+            if (wrapper.message.isNoteOn() && !wrapper.isFrozen)
             {
                 holdingNotes.add(HoldingNote({key, channel, wrapper.listener}));
             }
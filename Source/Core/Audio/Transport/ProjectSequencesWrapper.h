@@ -18,18 +18,38 @@
 #pragma once
 
 #include "Instrument.h"
+#include "MidiSequence.h"
 #include <float.h>
 
-class MidiSequence;
-
+// One instance of a sequence, played at the clip's offset;
+// all clips of a sequence share its exported messages,
+// and the offset is only applied when iterating over them.
+// Wrappers are never changed once created, so the snapshots
+// built after an edit can reuse them for the tracks that didn't change
 struct SequenceWrapper : public ReferenceCountedObject
 {
-    MidiMessageSequence sequence;
-    int currentIndex;
+    MidiSequence::MidiStream::Ptr stream;
+    double timeOffset;
     MidiMessageCollector *listener;
     Instrument *instrument;
     const MidiSequence *layer;
+    bool isFrozen; // played from the pre-rendered audio instead
     typedef ReferenceCountedObjectPtr<SequenceWrapper> Ptr;
+
+    inline int getNumEvents() const noexcept
+    {
+        return this->stream->messages.getNumEvents();
+    }
+
+    inline MidiMessageSequence::MidiEventHolder *getEventPointer(int index) const noexcept
+    {
+        return this->stream->messages.getEventPointer(index);
+    }
+
+    inline double getTimeStamp(int index) const noexcept
+    {
+        return this->getEventPointer(index)->message.getTimeStamp() + this->timeOffset;
+    }
 };
 
 struct MessageWrapper : public ReferenceCountedObject
@@ -37,50 +57,54 @@ struct MessageWrapper : public ReferenceCountedObject
     MidiMessage message;
     MidiMessageCollector *listener;
     Instrument *instrument;
+    const MidiSequence *layer;
+    bool isFrozen;
     typedef ReferenceCountedObjectPtr<MessageWrapper> Ptr;
 };
 
+// Everything to be played as of some moment; the transport publishes
+// a new snapshot after the project changes, and never modifies it after that,
+// so the player and the renderer can read it without any locking
+struct PlaybackSnapshot final : public ReferenceCountedObject
+{
+    ReferenceCountedArray<SequenceWrapper> sequences;
+    Array<Instrument *> uniqueInstruments;
+    typedef ReferenceCountedObjectPtr<PlaybackSnapshot> Ptr;
+
+    void addWrapper(SequenceWrapper *const newWrapper)
+    {
+        this->uniqueInstruments.addIfNotAlreadyThere(newWrapper->instrument);
+        this->sequences.add(newWrapper);
+    }
+};
+
 // TODO: add modifiers like random delays and so forth
 
+// A playback cursor over a snapshot; each thread iterates its own copy
 class ProjectSequences
 {
-private:
-    
-    Array<Instrument *> uniqueInstruments;
-    ReferenceCountedArray<SequenceWrapper> sequences;
-
 public:
     
-    ProjectSequences() {}
+    ProjectSequences() :
+        snapshot(new PlaybackSnapshot()) {}
     
-    ProjectSequences(const ProjectSequences &other) :
-    sequences(other.sequences),
-    uniqueInstruments(other.uniqueInstruments) {}
-    
-    inline Array<Instrument *> getUniqueInstruments() const noexcept
+    explicit ProjectSequences(PlaybackSnapshot *snapshotToPlay) :
+        snapshot(snapshotToPlay)
     {
-        const SpinLock::ScopedLockType lock(this->instrumentsLock);
-        return this->uniqueInstruments;
-    }
-    
-    SequenceWrapper *addWrapper(SequenceWrapper *const newWrapper) noexcept
-    {
-        const SpinLock::ScopedLockType lock(this->sequencesLock);
-        this->uniqueInstruments.addIfNotAlreadyThere(newWrapper->instrument);
-        return this->sequences.add(newWrapper);
+        jassert(snapshotToPlay != nullptr);
+        this->indices.insertMultiple(0, 0, this->snapshot->sequences.size());
     }
+
+    ProjectSequences(const ProjectSequences &other) = default;
     
-    inline void clear()
+    inline const Array<Instrument *> &getUniqueInstruments() const noexcept
     {
-        const SpinLock::ScopedLockType lock(this->sequencesLock);
-        this->uniqueInstruments.clear();
-        this->sequences.clear();
+        return this->snapshot->uniqueInstruments;
     }
     
-    inline bool empty() const
+    inline bool empty() const noexcept
     {
-        const SpinLock::ScopedLockType lock(this->sequencesLock);
-        return (this->sequences.size() == 0);
+        return (this->snapshot->sequences.size() == 0);
     }
     
     double getSampleRate() const
@@ -88,10 +112,8 @@ public:
         if (this->empty())
         { return 0.0; }
 
-        const SpinLock::ScopedLockType lock(this->sequencesLock);
-
         // TODO: something more reasonable?
-        return this->sequences[0]->instrument->getProcessorGraph()->getSampleRate();
+        return this->snapshot->sequences[0]->instrument->getProcessorGraph()->getSampleRate();
     }
 
     int getNumOutputChannels() const
@@ -99,10 +121,8 @@ public:
         if (this->empty())
         { return 0; }
 
-        const SpinLock::ScopedLockType lock(this->sequencesLock);
-
         // TODO: something more reasonable?
-        return this->sequences[0]->instrument->getProcessorGraph()->getTotalNumOutputChannels();
+        return this->snapshot->sequences[0]->instrument->getProcessorGraph()->getTotalNumOutputChannels();
     }
 
     int getNumInputChannels() const
@@ -110,20 +130,15 @@ public:
         if (this->empty())
         { return 0; }
 
-        const SpinLock::ScopedLockType lock(this->sequencesLock);
-
         // TODO: something more reasonable?
-        return this->sequences[0]->instrument->getProcessorGraph()->getTotalNumInputChannels();
+        return this->snapshot->sequences[0]->instrument->getProcessorGraph()->getTotalNumInputChannels();
     }
 
-    ReferenceCountedArray<SequenceWrapper> getAllFor(const MidiSequence *midiLayer)
+    ReferenceCountedArray<SequenceWrapper> getAllFor(const MidiSequence *midiLayer) const
     {
-        const SpinLock::ScopedLockType lock(this->sequencesLock);
-
         ReferenceCountedArray<SequenceWrapper> result;
-        for (int i = 0; i < this->sequences.size(); ++i)
+        for (auto *seq : this->snapshot->sequences)
         {
-            SequenceWrapper::Ptr seq(this->sequences[i]);
             if (midiLayer == nullptr || midiLayer == seq->layer)
             {
                 result.add(seq);
@@ -135,43 +150,35 @@ public:
 
     void seekToTime(double position)
     {
-        const SpinLock::ScopedLockType lock(this->sequencesLock);
-        
-        for (int i = 0; i < this->sequences.size(); ++i)
+        for (int i = 0; i < this->indices.size(); ++i)
         {
-            SequenceWrapper *wrapper = this->sequences.getUnchecked(i);
-            wrapper->currentIndex = this->getNextIndexAtTime(wrapper->sequence, (position - DBL_MIN));
+            const SequenceWrapper *wrapper = this->snapshot->sequences.getUnchecked(i);
+            this->indices.setUnchecked(i, this->getNextIndexAtTime(*wrapper, (position - DBL_MIN)));
         }
     }
     
     void seekToZeroIndexes()
     {
-        const SpinLock::ScopedLockType lock(this->sequencesLock);
-
-        for (int i = 0; i < this->sequences.size(); ++i)
-        {
-            this->sequences.getUnchecked(i)->currentIndex = 0;
-        }
+        this->indices.fill(0);
     }
     
     bool getNextMessage(MessageWrapper &target)
     {
-        const SpinLock::ScopedLockType lock(this->sequencesLock);
-
         double minTimeStamp = DBL_MAX;
         int targetSequenceIndex = -1;
 
-        for (int i = 0; i < this->sequences.size(); ++i)
+        for (int i = 0; i < this->indices.size(); ++i)
         {
-            SequenceWrapper *wrapper = this->sequences.getUnchecked(i);
+            const SequenceWrapper *wrapper = this->snapshot->sequences.getUnchecked(i);
+            const int currentIndex = this->indices.getUnchecked(i);
 
-            if (wrapper->currentIndex < wrapper->sequence.getNumEvents())
+            if (currentIndex < wrapper->getNumEvents())
             {
-                MidiMessage &message = wrapper->sequence.getEventPointer(wrapper->currentIndex)->message;
+                const double timeStamp = wrapper->getTimeStamp(currentIndex);
 
-                if (message.getTimeStamp() < minTimeStamp)
+                if (timeStamp < minTimeStamp)
                 {
-                    minTimeStamp = message.getTimeStamp();
+                    minTimeStamp = timeStamp;
                     targetSequenceIndex = i;
                 }
             }
@@ -180,36 +187,47 @@ public:
         if (targetSequenceIndex < 0)
         { return false; }
 
-        SequenceWrapper *foundWrapper = this->sequences.getUnchecked(targetSequenceIndex);
-        MidiMessage &foundMessage = foundWrapper->sequence.getEventPointer(foundWrapper->currentIndex)->message;
-        foundWrapper->currentIndex++;
+        const SequenceWrapper *foundWrapper = this->snapshot->sequences.getUnchecked(targetSequenceIndex);
+        int &foundIndex = this->indices.getReference(targetSequenceIndex);
+        const MidiMessage &foundMessage = foundWrapper->getEventPointer(foundIndex)->message;
+        foundIndex++;
                 
         target.message = foundMessage;
+        target.message.addToTimeStamp(foundWrapper->timeOffset);
         target.listener = foundWrapper->listener;
         target.instrument = foundWrapper->instrument;
+        target.layer = foundWrapper->layer;
+        target.isFrozen = foundWrapper->isFrozen;
 
         return true;
     }
     
 private:
     
-    int getNextIndexAtTime(const MidiMessageSequence &sequence, double timeStamp) const
+    // The messages are sorted by time, so this is just a binary search
+    int getNextIndexAtTime(const SequenceWrapper &wrapper, double timeStamp) const
     {
-        int i = 0;
-        for (; i < sequence.getNumEvents(); ++i)
+        int start = 0;
+        int end = wrapper.getNumEvents();
+
+        while (start < end)
         {
-            const double eventTs = sequence.getEventPointer(i)->message.getTimeStamp();
-            if (eventTs >= timeStamp)
+            const int middle = (start + end) / 2;
+            if (wrapper.getTimeStamp(middle) < timeStamp)
+            {
+                start = middle + 1;
+            }
+            else
             {
-                break;
+                end = middle;
             }
         }
         
-        return i;
+        return start;
     }
 
-    SpinLock instrumentsLock;
-    SpinLock sequencesLock;
+    PlaybackSnapshot::Ptr snapshot;
+    Array<int> indices; // the next message of each sequence
     
     JUCE_LEAK_DETECTOR(ProjectSequences)
 };
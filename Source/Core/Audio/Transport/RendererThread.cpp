@@ -22,12 +22,14 @@
 #include "App.h"
 #include "Workspace.h"
 #include "AudioCore.h"
+#include "PerformanceTrace.h"
 
 RendererThread::RendererThread(Transport &parentTrasport) :
     Thread("RendererThread"),
     transport(parentTrasport),
     writer(nullptr),
-    percentsDone(0.f) {}
+    percentsDone(0.f),
+    layerToRender(nullptr) {}
 
 RendererThread::~RendererThread()
 {
@@ -41,17 +43,25 @@ float RendererThread::getPercentsComplete() const
 }
 
 
-void RendererThread::startRecording(const File &file)
+void RendererThread::startRecording(const File &file,
+    const MidiSequence *layer, CompletionCallback callback)
 {
     this->transport.rebuildSequencesIfNeeded();
     const ProjectSequences sequences = this->transport.getSequences();
     
     if (sequences.empty())
     {
+        if (callback != nullptr)
+        {
+            MessageManager::callAsync([callback]() { callback(false); });
+        }
+
         return;
     }
 
     this->stop();
+    this->layerToRender = layer;
+    this->completionCallback = callback;
 
     double sampleRate = sequences.getSampleRate();
     int numChannels = sequences.getNumOutputChannels();
@@ -91,8 +101,20 @@ void RendererThread::startRecording(const File &file)
             Logger::writeToLog(file.getFullPathName());
             fileStream.release(); // (passes responsibility for deleting the stream to the writer object that is now using it)
             this->startThread(9);
+            return;
         }
     }
+
+    this->notifyCompletion(false);
+}
+
+void RendererThread::notifyCompletion(bool succeeded) const
+{
+    if (this->completionCallback != nullptr)
+    {
+        const auto callback = this->completionCallback;
+        MessageManager::callAsync([callback, succeeded]() { callback(succeeded); });
+    }
 }
 
 void RendererThread::stop()
@@ -129,7 +151,7 @@ struct RenderBuffer
 void RendererThread::run()
 {
     // step 0. init.
-    this->transport.rebuildSequencesIfNeeded();
+    // (the snapshot was rebuilt on the message thread in startRecording)
     ProjectSequences sequences = this->transport.getSequences();
     const int bufferSize = 512;
     const double TPQN = MS_PER_BEAT; // ticks-per-quarter-note
@@ -155,7 +177,18 @@ void RendererThread::run()
 
     // step 1. create a list of unique instruments with audio buffers for them.
     OwnedArray<RenderBuffer> subBuffers;
-    Array<Instrument *> uniqueInstruments(sequences.getUniqueInstruments());
+    Array<Instrument *> uniqueInstruments;
+    if (this->layerToRender != nullptr)
+    {
+        for (const auto *wrapper : sequences.getAllFor(this->layerToRender))
+        {
+            uniqueInstruments.addIfNotAlreadyThere(wrapper->instrument);
+        }
+    }
+    else
+    {
+        uniqueInstruments.addArray(sequences.getUniqueInstruments());
+    }
 
     for (int i = 0; i < uniqueInstruments.size(); ++i)
     {
@@ -205,6 +238,8 @@ void RendererThread::run()
         {
             break;
         }
+
+        TRACE_SPAN("Render block");
         
         // step 3a. fill up the midi buffers.
         while (hasNextMessage &&
@@ -223,7 +258,8 @@ void RendererThread::run()
                     subBuffer->midiBuffer.addEvent(nextMessage.message, messageFrame);
                 }
             }
-            else
+            else if (this->layerToRender == nullptr ||
+                this->layerToRender == nextMessage.layer)
             {
                 for (auto subBuffer : subBuffers)
                 {
@@ -308,8 +344,15 @@ void RendererThread::run()
     
     if (! this->threadShouldExit())
     {
-        // dirty hack
-        App::Workspace().getAudioCore().unmute();
-        App::Workspace().getAudioCore().unmute();
+        // a single sequence render only detaches its own instruments,
+        // and the caller puts them back on completion
+        if (this->layerToRender == nullptr)
+        {
+            // dirty hack
+            App::Workspace().getAudioCore().unmute();
+            App::Workspace().getAudioCore().unmute();
+        }
+
+        this->notifyCompletion(true);
     }
 }
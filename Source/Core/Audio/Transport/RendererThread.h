@@ -28,7 +28,14 @@ public:
     
     float getPercentsComplete() const;
 
-    void startRecording(const File &file);
+    typedef Function<void(bool succeeded)> CompletionCallback;
+
+    // Renders either the whole project, or only the given sequence
+    // (plus the tempo track); the callback is called on the message thread
+    void startRecording(const File &file,
+        const MidiSequence *layerToRender = nullptr,
+        CompletionCallback completionCallback = nullptr);
+
     void stop();
     bool isRecording() const;
 
@@ -49,6 +56,10 @@ private:
 
     ReadWriteLock percentsLock;
     float percentsDone;
+
+    const MidiSequence *layerToRender;
+    CompletionCallback completionCallback;
+    void notifyCompletion(bool succeeded) const;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RendererThread)
 };
@@ -21,14 +21,17 @@
 #include "OrchestraPit.h"
 #include "PlayerThread.h"
 #include "RendererThread.h"
+#include "FrozenTracks.h"
 #include "MidiSequence.h"
 #include "MidiEvent.h"
 #include "MidiTrack.h"
+#include "Pattern.h"
 #include "App.h"
 #include "Workspace.h"
 #include "AudioCore.h"
 #include "HybridRoll.h"
 #include "SerializationKeys.h"
+#include "PerformanceTrace.h"
 
 class PlayerThreadPool final
 {
@@ -133,6 +136,9 @@ Transport::Transport(OrchestraPit &orchestraPit) :
     seekPosition(0.0),
     trackStartMs(0.0),
     trackEndMs(0.0),
+    currentSnapshot(new PlaybackSnapshot()),
+    publishedSnapshot(nullptr),
+    numSnapshotReaders(0),
     sequencesAreOutdated(true),
     totalTime(MS_PER_BEAT * 8.0),
     loopedMode(false),
@@ -141,14 +147,17 @@ Transport::Transport(OrchestraPit &orchestraPit) :
     projectFirstBeat(0.f),
     projectLastBeat(DEFAULT_NUM_BARS * BEATS_PER_BAR)
 {
+    this->publishedSnapshot = this->currentSnapshot.get();
     this->player = new PlayerThreadPool(*this);
     this->renderer = new RendererThread(*this);
+    this->frozenTracks = new FrozenTracks(*this);
     this->orchestra.addOrchestraListener(this);
 }
 
 Transport::~Transport()
 {
     this->orchestra.removeOrchestraListener(this);
+    this->frozenTracks = nullptr;
     this->renderer = nullptr;
     this->player = nullptr;
     this->transportListeners.clear();
@@ -249,28 +258,21 @@ void Transport::probeSoundAt(double absTrackPosition, const MidiSequence *limitT
     this->rebuildSequencesIfNeeded();
     
     const double targetFlatTime = round(this->getTotalTime() * absTrackPosition);
-    const auto sequencesToProbe(this->sequences.getAllFor(limitToLayer));
+    const auto sequencesToProbe(this->getSequences().getAllFor(limitToLayer));
     
+    Array<int> soundingNotes;
     for (auto && i : sequencesToProbe)
     {
         SequenceWrapper::Ptr seq(i);
 
-        for (int j = 0; j < seq->sequence.getNumEvents(); ++j)
+        soundingNotes.clearQuick();
+        seq->stream->notes.findNotesAt(targetFlatTime - seq->timeOffset, soundingNotes);
+
+        for (const int noteIndex : soundingNotes)
         {
-            MidiMessageSequence::MidiEventHolder *noteOnHolder = seq->sequence.getEventPointer(j);
-            
-            if (MidiMessageSequence::MidiEventHolder *noteOffHolder = noteOnHolder->noteOffObject)
-            {
-                const double noteOn(noteOnHolder->message.getTimeStamp());
-                const double noteOff(noteOffHolder->message.getTimeStamp());
-                
-                if (noteOn <= targetFlatTime && noteOff > targetFlatTime)
-                {
-                    MidiMessage messageTimestampedAsNow(noteOnHolder->message);
-                    messageTimestampedAsNow.setTimeStamp(Time::getMillisecondCounterHiRes() * 0.001);
-                    seq->listener->addMessageToQueue(messageTimestampedAsNow);
-                }
-            }
+            MidiMessage messageTimestampedAsNow(seq->getEventPointer(noteIndex)->message);
+            messageTimestampedAsNow.setTimeStamp(Time::getMillisecondCounterHiRes() * 0.001);
+            seq->listener->addMessageToQueue(messageTimestampedAsNow);
         }
     }
 }
@@ -278,8 +280,6 @@ void Transport::probeSoundAt(double absTrackPosition, const MidiSequence *limitT
 // Only used in a key signature dialog to test how scales sound
 void Transport::probeSequence(const MidiMessageSequence &sequence)
 {
-    this->sequences.clear();
-    this->sequencesAreOutdated = true; // will update on the next playback
     this->loopedMode = false;
 
     MidiMessageSequence fixedSequence(sequence);
@@ -290,11 +290,20 @@ void Transport::probeSequence(const MidiMessageSequence &sequence)
     Instrument *targetInstrument = this->orchestra.getInstruments().getLast();
     auto wrapper = new SequenceWrapper();
     wrapper->layer = nullptr;
-    wrapper->sequence = fixedSequence;
-    wrapper->currentIndex = 0;
+    wrapper->stream = new MidiSequence::MidiStream();
+    wrapper->stream->messages = fixedSequence;
+    wrapper->timeOffset = 0.0;
+    wrapper->isFrozen = false;
     wrapper->instrument = targetInstrument;
     wrapper->listener = &targetInstrument->getProcessorPlayer().getMidiMessageCollector();
-    this->sequences.addWrapper(wrapper);
+
+    PlaybackSnapshot::Ptr snapshot(new PlaybackSnapshot());
+    snapshot->addWrapper(wrapper);
+    this->publishSnapshot(snapshot);
+    this->sequencesAreOutdated = true; // will update on the next playback
+
+    // the freeze render has the instrument detached from the device
+    this->frozenTracks->cancelRendering();
 
     if (this->player->isPlaying())
     {
@@ -307,6 +316,7 @@ void Transport::probeSequence(const MidiMessageSequence &sequence)
 
 void Transport::startPlayback()
 {
+    this->frozenTracks->cancelRendering();
     this->rebuildSequencesIfNeeded();
     if (this->player->isPlaying())
     {
@@ -321,6 +331,7 @@ void Transport::startPlayback()
 
 void Transport::startPlaybackLooped(double absLoopStart, double absLoopEnd)
 {
+    this->frozenTracks->cancelRendering();
     this->rebuildSequencesIfNeeded();
     
     if (this->player->isPlaying())
@@ -381,7 +392,9 @@ void Transport::startRender(const String &fileName)
     {
         return;
     }
-    
+
+    // two renderers can't share the instruments
+    this->frozenTracks->cancelRendering();
     App::Workspace().getAudioCore().mute();
     
     File file(File::getCurrentWorkingDirectory().getChildFile(fileName));
@@ -408,6 +421,22 @@ bool Transport::isRendering() const
     return this->renderer->isRecording();
 }
 
+void Transport::freezeTrack(const MidiTrack *track)
+{
+    this->frozenTracks->freeze(track);
+}
+
+void Transport::unfreezeTrack(const MidiTrack *track)
+{
+    this->frozenTracks->unfreeze(track);
+    this->onTrackFreezeChanged(track);
+}
+
+bool Transport::isTrackFrozen(const MidiTrack *track) const
+{
+    return this->frozenTracks->isFrozen(track);
+}
+
 float Transport::getRenderingPercentsComplete() const
 {
     return this->renderer->getPercentsComplete();
@@ -435,6 +464,11 @@ void Transport::sendMidiMessage(const String &layerId, const MidiMessage &messag
     collector->addMessageToQueue(messageTimestampedAsNow);
 }
 
+Instrument *Transport::findInstrumentFor(const MidiTrack *track) const
+{
+    return this->linksCache[track->getTrackId().toString()];
+}
+
 void Transport::allNotesAndControllersOff() const
 {
     const int c = 1;
@@ -503,7 +537,7 @@ void Transport::instrumentAdded(Instrument *instrument)
     this->stopPlayback();
     
     // invalidate sequences as they use pointers to the players too
-    this->sequencesAreOutdated = true;
+    this->invalidateAllSequences();
 
     for (int i = 0; i < this->tracksCache.size(); ++i)
     {
@@ -520,7 +554,7 @@ void Transport::instrumentRemoved(Instrument *instrument)
 
 void Transport::instrumentRemovedPostAction()
 {
-    this->sequencesAreOutdated = true;
+    this->invalidateAllSequences();
 
     for (int i = 0; i < this->tracksCache.size(); ++i)
     {
@@ -543,13 +577,13 @@ void Transport::onChangeMidiEvent(const MidiEvent &oldEvent, const MidiEvent &ne
         this->stopPlayback();
     }
     
+    this->invalidateSequencesFor(newEvent.getSequence()->getTrack());
+
     // a hack
     if (newEvent.getControllerNumber() == MidiTrack::tempoController)
     {
         this->seekToPosition(this->getSeekPosition());
     }
-    
-    this->sequencesAreOutdated = true;
 }
 
 void Transport::onAddMidiEvent(const MidiEvent &event)
@@ -558,13 +592,13 @@ void Transport::onAddMidiEvent(const MidiEvent &event)
     // and getControllerNumber == 0 (not an automation)
     this->stopPlayback();
     
+    this->invalidateSequencesFor(event.getSequence()->getTrack());
+
     // a hack
     if (event.getControllerNumber() == MidiTrack::tempoController)
     {
         this->seekToPosition(this->getSeekPosition());
     }
-    
-    this->sequencesAreOutdated = true;
 }
 
 void Transport::onRemoveMidiEvent(const MidiEvent &event)
@@ -572,39 +606,65 @@ void Transport::onRemoveMidiEvent(const MidiEvent &event)
     // todo stop playback only if the event is in future and getControllerNumber == 0 (not an automation)
     this->stopPlayback();
     
-    this->sequencesAreOutdated = true;
+    this->invalidateSequencesFor(event.getSequence()->getTrack());
 }
 
 void Transport::onPostRemoveMidiEvent(MidiSequence *const layer)
 {
     this->stopPlayback();
     
+    this->invalidateSequencesFor(layer->getTrack());
+
     // a hack to re-calculate length and current time
     if (layer->getTrack()->getTrackControllerNumber() == MidiTrack::tempoController)
     {
         this->seekToPosition(this->getSeekPosition());
     }
-    
-    this->sequencesAreOutdated = true;
+}
+
+void Transport::onAddClip(const Clip &clip)
+{
+    this->stopPlayback();
+    this->invalidateSequencesFor(clip.getPattern()->getTrack());
+}
+
+void Transport::onChangeClip(const Clip &oldClip, const Clip &newClip)
+{
+    this->stopPlayback();
+    this->invalidateSequencesFor(newClip.getPattern()->getTrack());
+}
+
+void Transport::onRemoveClip(const Clip &clip)
+{
+    this->stopPlayback();
+    this->invalidateSequencesFor(clip.getPattern()->getTrack());
+}
+
+void Transport::onPostRemoveClip(Pattern *const pattern)
+{
+    this->invalidateSequencesFor(pattern->getTrack());
 }
 
 void Transport::onChangeTrackProperties(MidiTrack *const track)
 {
+    this->frozenTracks->updateMuteState(track);
+
     // Stop playback only when instrument changes:
     const auto trackId = track->getTrackId().toString();
     if (!linksCache.contains(trackId) ||
         this->linksCache[trackId]->getInstrumentID() != track->getTrackInstrumentId())
     {
         this->stopPlayback();
-        this->sequencesAreOutdated = true;
         this->updateLinkForTrack(track);
+        this->invalidateSequencesFor(track);
     }
 }
 
 void Transport::onReloadProjectContent(const Array<MidiTrack *> &tracks)
 {
     this->stopPlayback();
-    this->sequencesAreOutdated = true;
+    this->frozenTracks->unfreezeAllExcept(tracks);
+    this->invalidateAllSequences();
     for (const auto &track : tracks)
     {
         this->updateLinkForTrack(track);
@@ -615,7 +675,7 @@ void Transport::onAddTrack(MidiTrack *const track)
 {
     this->stopPlayback();
     
-    this->sequencesAreOutdated = true;
+    this->invalidateSequencesFor(track);
     this->tracksCache.addIfNotAlreadyThere(track);
     this->updateLinkForTrack(track);
 }
@@ -624,7 +684,8 @@ void Transport::onRemoveTrack(MidiTrack *const track)
 {
     this->stopPlayback();
     
-    this->sequencesAreOutdated = true;
+    this->invalidateSequencesFor(track);
+    this->frozenTracks->unfreeze(track);
     this->tracksCache.removeAllInstancesOf(track);
     this->removeLinkForTrack(track);
 }
@@ -650,6 +711,7 @@ void Transport::onChangeProjectBeatRange(float firstBeat, float lastBeat)
     
     this->trackStartMs = double(firstBeat) * MS_PER_BEAT;
     this->trackEndMs = double(lastBeat) * MS_PER_BEAT;
+    this->invalidateAllSequences(); // the offsets depend on the track start
     this->setTotalTime(this->trackEndMs.get() - this->trackStartMs.get());
     
     // real track total time changed
@@ -675,7 +737,7 @@ void Transport::calcTimeAndTempoAt(const double targetAbsPosition,
                                    double &outTimeMs, double &outTempo)
 {
     this->rebuildSequencesIfNeeded();
-    this->sequences.seekToZeroIndexes();
+    ProjectSequences sequences(this->getSequences());
     
     const double TPQN = MS_PER_BEAT; // ticks-per-quarter-note
     const double targetTime = round(targetAbsPosition * this->getTotalTime());
@@ -689,7 +751,7 @@ void Transport::calcTimeAndTempoAt(const double targetAbsPosition,
     
     MessageWrapper wrapper;
     
-    while (this->sequences.getNextMessage(wrapper))
+    while (sequences.getNextMessage(wrapper))
     {
         const double nextAbsPosition = (wrapper.message.getTimeStamp() / this->getTotalTime());
         
@@ -718,11 +780,11 @@ void Transport::calcTimeAndTempoAt(const double targetAbsPosition,
 MidiMessage Transport::findFirstTempoEvent()
 {
     this->rebuildSequencesIfNeeded();
-    this->sequences.seekToZeroIndexes();
+    ProjectSequences sequences(this->getSequences());
     
     MessageWrapper wrapper;
     
-    while (this->sequences.getNextMessage(wrapper))
+    while (sequences.getNextMessage(wrapper))
     {
         if (wrapper.message.isTempoMetaEvent())
         {
@@ -740,37 +802,140 @@ MidiMessage Transport::findFirstTempoEvent()
 
 void Transport::rebuildSequencesIfNeeded()
 {
-    if (this->sequencesAreOutdated)
+    if (!this->sequencesAreOutdated ||
+        !MessageManager::getInstance()->isThisTheMessageThread())
     {
-        this->sequences.clear();
-        
-        for (int i = 0; i < this->tracksCache.size(); ++i)
+        return;
+    }
+
+    TRACE_SPAN("Rebuild sequences");
+    PlaybackSnapshot::Ptr snapshot(new PlaybackSnapshot());
+
+    for (const auto *track : this->tracksCache)
+    {
+        // only the changed tracks are re-created,
+        // the others are shared with the previous snapshot
+        auto cached = this->trackSequences.find(track);
+        if (cached == this->trackSequences.end())
         {
-            const auto layer = this->tracksCache.getUnchecked(i)->getSequence();
-            MidiMessageSequence sequence(layer->exportMidi());
-            sequence.addTimeToMessages(-this->trackStartMs.get());
-            
-            if (sequence.getNumEvents() > 0)
-            {
-                Instrument *targetInstrument = this->linksCache[layer->getTrackId()];
-                auto wrapper = new SequenceWrapper();
-                wrapper->layer = layer;
-                wrapper->sequence = sequence;
-                wrapper->currentIndex = 0;
-                wrapper->instrument = targetInstrument;
-                wrapper->listener = &targetInstrument->getProcessorPlayer().getMidiMessageCollector();
-                this->sequences.addWrapper(wrapper);
-            }
+            cached = this->trackSequences.insert({ track, this->createSequencesFor(track) }).first;
+        }
+
+        for (auto *wrapper : cached->second)
+        {
+            snapshot->addWrapper(wrapper);
+        }
+    }
+
+    this->publishSnapshot(snapshot);
+    this->sequencesAreOutdated = false;
+}
+
+ReferenceCountedArray<SequenceWrapper> Transport::createSequencesFor(const MidiTrack *track) const
+{
+    ReferenceCountedArray<SequenceWrapper> result;
+    const auto layer = track->getSequence();
+
+    // exported messages are cached by the sequence itself,
+    // and only re-exported when the sequence changes
+    const auto stream = layer->exportMidiStream();
+    if (stream->messages.getNumEvents() == 0)
+    {
+        return result;
+    }
+
+    Instrument *targetInstrument = this->linksCache[layer->getTrackId()];
+    const bool isFrozen = this->frozenTracks->isStreamed(track);
+    const auto addInstance = [&](double offsetMs)
+    {
+        auto wrapper = new SequenceWrapper();
+        wrapper->layer = layer;
+        wrapper->stream = stream;
+        wrapper->timeOffset = offsetMs - this->trackStartMs.get();
+        wrapper->isFrozen = isFrozen;
+        wrapper->instrument = targetInstrument;
+        wrapper->listener = &targetInstrument->getProcessorPlayer().getMidiMessageCollector();
+        result.add(wrapper);
+    };
+
+    // tracks without clips are played as is
+    const auto pattern = track->getPattern();
+    if (pattern == nullptr || pattern->size() == 0)
+    {
+        addInstance(0.0);
+        return result;
+    }
+
+    for (const auto *clip : *pattern)
+    {
+        addInstance(double(clip->getStartBeat()) * MS_PER_BEAT);
+    }
+
+    return result;
+}
+
+void Transport::invalidateSequencesFor(const MidiTrack *track)
+{
+    this->trackSequences.erase(track);
+    this->sequencesAreOutdated = true;
+
+    // the frozen audio depends on the tempo track as well
+    if (track->getTrackControllerNumber() == MidiTrack::tempoController)
+    {
+        this->frozenTracks->invalidateAll();
+    }
+    else
+    {
+        this->frozenTracks->invalidate(track);
+    }
+}
+
+void Transport::invalidateAllSequences()
+{
+    this->trackSequences.clear();
+    this->sequencesAreOutdated = true;
+    this->frozenTracks->invalidateAll();
+}
+
+void Transport::onTrackFreezeChanged(const MidiTrack *track)
+{
+    this->trackSequences.erase(track);
+    this->sequencesAreOutdated = true;
+}
+
+void Transport::publishSnapshot(PlaybackSnapshot *newSnapshot)
+{
+    jassert(newSnapshot != nullptr);
+    this->retiredSnapshots.add(this->currentSnapshot);
+    this->currentSnapshot = newSnapshot;
+    this->publishedSnapshot = newSnapshot;
+    this->reclaimRetiredSnapshots();
+}
+
+void Transport::reclaimRetiredSnapshots()
+{
+    // someone might have read the old pointer, but not referenced it yet
+    if (this->numSnapshotReaders.get() != 0)
+    {
+        return;
+    }
+
+    // the ones still used by the player or the renderer will be freed next time
+    for (int i = this->retiredSnapshots.size(); --i >= 0;)
+    {
+        if (this->retiredSnapshots.getUnchecked(i)->getReferenceCount() == 1)
+        {
+            this->retiredSnapshots.remove(i);
         }
-        
-        this->sequencesAreOutdated = false;
     }
 }
 
-ProjectSequences Transport::getSequences()
+ProjectSequences Transport::getSequences() const
 {
-    const SpinLock::ScopedLockType l(this->sequencesLock);
-    return this->sequences;
+    ++this->numSnapshotReaders;
+    const PlaybackSnapshot::Ptr snapshot(this->publishedSnapshot.get());
+    --this->numSnapshotReaders;
+    return ProjectSequences(snapshot);
 }
 
 void Transport::updateLinkForTrack(const MidiTrack *track)
@@ -22,6 +22,7 @@ class OrchestraPit;
 class PlayerThread;
 class PlayerThreadPool;
 class RendererThread;
+class FrozenTracks;
 
 #include "TransportListener.h"
 #include "ProjectSequencesWrapper.h"
@@ -68,6 +69,11 @@ public:
     void stopRender();
     
     float getRenderingPercentsComplete() const;
+
+    // Frozen tracks are pre-rendered in background, and played as audio
+    void freezeTrack(const MidiTrack *track);
+    void unfreezeTrack(const MidiTrack *track);
+    bool isTrackFrozen(const MidiTrack *track) const;
     
     void calcTimeAndTempoAt(const double absPosition,
                             double &outTimeMs,
@@ -80,6 +86,7 @@ public:
     //===------------------------------------------------------------------===//
     
     void sendMidiMessage(const String &layerId, const MidiMessage &message) const;
+    Instrument *findInstrumentFor(const MidiTrack *track) const;
     void allNotesAndControllersOff() const;
     void allNotesControllersAndSoundOff() const;
     
@@ -101,6 +108,11 @@ public:
     void onRemoveMidiEvent(const MidiEvent &event) override;
     void onPostRemoveMidiEvent(MidiSequence *const layer) override;
 
+    void onAddClip(const Clip &clip) override;
+    void onChangeClip(const Clip &oldClip, const Clip &newClip) override;
+    void onRemoveClip(const Clip &clip) override;
+    void onPostRemoveClip(Pattern *const pattern) override;
+
     void onAddTrack(MidiTrack *const track) override;
     void onRemoveTrack(MidiTrack *const track) override;
     void onChangeTrackProperties(MidiTrack *const track) override;
@@ -143,17 +155,38 @@ private:
 
     ScopedPointer<PlayerThreadPool> player;
     ScopedPointer<RendererThread> renderer;
+    ScopedPointer<FrozenTracks> frozenTracks;
 
     friend class RendererThread;
     friend class PlayerThread;
+    friend class FrozenTracks;
 
 private:
 
-    ProjectSequences getSequences();
+    // Safe to call from any thread, never blocks
+    ProjectSequences getSequences() const;
+
+    // Only has effect on the message thread, others keep playing
+    // whatever snapshot was published before
     void rebuildSequencesIfNeeded();
-    
-    SpinLock sequencesLock;
-    ProjectSequences sequences;
+
+    void publishSnapshot(PlaybackSnapshot *newSnapshot);
+    void reclaimRetiredSnapshots();
+
+    ReferenceCountedArray<SequenceWrapper> createSequencesFor(const MidiTrack *track) const;
+    void invalidateSequencesFor(const MidiTrack *track);
+    void invalidateAllSequences();
+    void onTrackFreezeChanged(const MidiTrack *track);
+
+    // The published snapshot is read by the player threads through a raw pointer;
+    // the replaced ones are kept in the retired list until no one references them,
+    // and the readers counter tells if some thread may be just about to do that
+    PlaybackSnapshot::Ptr currentSnapshot;
+    Atomic<PlaybackSnapshot *> publishedSnapshot;
+    mutable Atomic<int> numSnapshotReaders;
+    ReferenceCountedArray<PlaybackSnapshot> retiredSnapshots;
+
+    SparseHashMap<const MidiTrack *, ReferenceCountedArray<SequenceWrapper>> trackSequences;
     bool sequencesAreOutdated;
     
     Array<const MidiTrack *> tracksCache;
@@ -24,6 +24,17 @@
 
 // todo multiple clipboards?
 
+static const char *kClipboardHeader = "HelioClipboard::";
+
+InternalClipboard::InternalClipboard() :
+    mirrorPool(1) {}
+
+InternalClipboard::~InternalClipboard()
+{
+    this->mirrorPool.removeAllJobs(true, 1000);
+    this->masterReference.clear();
+}
+
 void InternalClipboard::copy(const ClipboardOwner &owner, bool mirrorToSystemClipboard /*= false*/)
 {
     App::Helio()->getClipboard()->copyFrom(owner, mirrorToSystemClipboard);
@@ -52,20 +63,79 @@ String InternalClipboard::getCurrentContentAsString()
     return {};
 }
 
+String InternalClipboard::encode(const ValueTree &tree)
+{
+    MemoryOutputStream memOut;
+    {
+        GZIPCompressorOutputStream zippedOut(&memOut, 1, false);
+        tree.writeToStream(zippedOut);
+    }
+
+    return kClipboardHeader + memOut.getMemoryBlock().toBase64Encoding();
+}
+
+ValueTree InternalClipboard::decode(const String &text)
+{
+    if (!text.startsWith(kClipboardHeader))
+    {
+        return {};
+    }
+
+    MemoryBlock data;
+    if (!data.fromBase64Encoding(text.substring(int(strlen(kClipboardHeader)))))
+    {
+        return {};
+    }
+
+    MemoryInputStream memIn(data, false);
+    GZIPDecompressorInputStream zippedIn(memIn);
+    return ValueTree::readFromStream(zippedIn);
+}
+
 void InternalClipboard::copyFrom(const ClipboardOwner &owner, bool mirrorToSystemClipboard /*= false*/)
 {
     this->clipboard = owner.clipboardCopy();
+    ++this->mirrorVersion;
 
     if (mirrorToSystemClipboard)
     {
-        SystemClipboard::copyTextToClipboard(this->getCurrentContentAsString());
+        this->mirrorToSystemClipboardAsync();
     }
 }
 
 void InternalClipboard::pasteTo(ClipboardOwner &owner)
 {
+    // nothing copied here yet, but there might be something
+    // copied from another instance of the app
+    if (!this->clipboard.isValid())
+    {
+        this->clipboard = decode(SystemClipboard::getTextFromClipboard());
+    }
+
     if (this->clipboard.isValid())
     {
         owner.clipboardPaste(this->clipboard);
     }
 }
+
+void InternalClipboard::mirrorToSystemClipboardAsync()
+{
+    // the copied tree is never modified afterwards,
+    // so it's fine to read it on the worker thread
+    const ValueTree content(this->clipboard);
+    const int version = this->mirrorVersion.get();
+    WeakReference<InternalClipboard> weakThis(this);
+
+    this->mirrorPool.addJob([content, version, weakThis]()
+    {
+        const String text(encode(content));
+
+        MessageManager::callAsync([text, version, weakThis]()
+        {
+            if (weakThis != nullptr && weakThis->mirrorVersion.get() == version)
+            {
+                SystemClipboard::copyTextToClipboard(text);
+            }
+        });
+    });
+}
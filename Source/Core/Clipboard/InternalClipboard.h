@@ -23,12 +23,20 @@ class InternalClipboard final
 {
 public:
 
+    InternalClipboard();
+    ~InternalClipboard();
+
     static void copy(const ClipboardOwner &owner, bool mirrorToSystemClipboard = false);
     static void paste(ClipboardOwner &owner);
     
     static ValueTree getCurrentContent();
     static String getCurrentContentAsString();
 
+    // The system clipboard only takes text, so the content is mirrored
+    // as a gzipped binary tree in base64, prefixed with a header
+    static String encode(const ValueTree &tree);
+    static ValueTree decode(const String &text);
+
 public:
 
     void copyFrom(const ClipboardOwner &owner, bool mirrorToSystemClipboard = false);
@@ -36,6 +44,16 @@ public:
 
 private:
 
+    void mirrorToSystemClipboardAsync();
+
     ValueTree clipboard;
 
+    // Encoding is done in background, and only the latest copy gets mirrored
+    ThreadPool mirrorPool;
+    Atomic<int> mirrorVersion;
+
+    WeakReference<InternalClipboard>::Master masterReference;
+    friend class WeakReference<InternalClipboard>;
+
+    JUCE_DECLARE_NON_COPYABLE(InternalClipboard)
 };
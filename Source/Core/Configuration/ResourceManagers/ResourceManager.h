@@ -29,13 +29,13 @@ public:
 
     virtual File getDownloadedResourceFile() const
     {
-        static String assumedFileName = this->resourceName + ".helio";
+        const String assumedFileName = this->resourceName + ".helio";
         return DocumentHelpers::getConfigSlot(assumedFileName);
     }
 
     virtual File getUsersResourceFile() const
     {
-        static String assumedFileName = this->resourceName + ".json";
+        const String assumedFileName = this->resourceName + ".json";
         return DocumentHelpers::getDocumentSlot(assumedFileName);
     }
 
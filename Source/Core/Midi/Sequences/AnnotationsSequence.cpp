@@ -33,8 +33,6 @@ AnnotationsSequence::AnnotationsSequence(MidiTrack &track,
 
 void AnnotationsSequence::importMidi(const MidiMessageSequence &sequence)
 {
-    this->clearUndoHistory();
-    this->checkpoint();
     this->reset();
 
     for (int i = 0; i < sequence.getNumEvents(); ++i)
@@ -46,13 +44,11 @@ void AnnotationsSequence::importMidi(const MidiMessageSequence &sequence)
             const String text = message.getTextFromTextMetaEvent();
             const double startTimestamp = message.getTimeStamp() / MIDI_IMPORT_SCALE;
             const float beat = float(startTimestamp);
-            
-            // bottleneck warning!
-            const AnnotationEvent annotation(this, beat, text, Colours::white);
-            this->silentImport(annotation);
+            this->midiEvents.add(new AnnotationEvent(this, beat, text, Colours::white)); // sorted later
         }
     }
 
+    this->sort();
     this->updateBeatRange(false);
     this->invalidateSequenceCache();
 }
@@ -169,15 +165,18 @@ bool AnnotationsSequence::insertGroup(Array<AnnotationEvent> &group, bool undoab
     }
     else
     {
+        Array<MidiEvent *> newEvents;
+        newEvents.ensureStorageAllocated(group.size());
+
         for (int i = 0; i < group.size(); ++i)
         {
             const AnnotationEvent &eventParams = group.getUnchecked(i);
             const auto ownedEvent = new AnnotationEvent(this, eventParams);
             jassert(ownedEvent->isValid());
-            this->midiEvents.addSorted(*ownedEvent, ownedEvent);
-            this->notifyEventAdded(*ownedEvent);
+            newEvents.add(ownedEvent);
         }
         
+        this->insertOwnedEvents(newEvents);
         this->updateBeatRange(true);
     }
     
@@ -34,8 +34,6 @@ AutomationSequence::AutomationSequence(MidiTrack &track,
 
 void AutomationSequence::importMidi(const MidiMessageSequence &sequence)
 {
-    this->clearUndoHistory();
-    this->checkpoint();
     this->reset();
     
     for (int i = 0; i < sequence.getNumEvents(); ++i)
@@ -48,11 +46,11 @@ void AutomationSequence::importMidi(const MidiMessageSequence &sequence)
             const int controllerValue = message.getControllerValue();
             const float beat = float(startTimestamp);
             
-            const AutomationEvent event(this, beat, float(controllerValue));
-            this->silentImport(event);
+            this->midiEvents.add(new AutomationEvent(this, beat, float(controllerValue))); // sorted later
         }
     }
     
+    this->sort();
     this->updateBeatRange(false);
     this->invalidateSequenceCache();
 }
@@ -167,14 +165,16 @@ bool AutomationSequence::insertGroup(Array<AutomationEvent> &group, bool undoabl
     }
     else
     {
+        Array<MidiEvent *> newEvents;
+        newEvents.ensureStorageAllocated(group.size());
+
         for (int i = 0; i < group.size(); ++i)
         {
             const AutomationEvent &eventParams = group.getUnchecked(i);
-            auto ownedEvent = new AutomationEvent(this, eventParams);
-            this->midiEvents.addSorted(*ownedEvent, ownedEvent);
-            this->notifyEventAdded(*ownedEvent);
+            newEvents.add(new AutomationEvent(this, eventParams));
         }
         
+        this->insertOwnedEvents(newEvents);
         this->updateBeatRange(true);
     }
     
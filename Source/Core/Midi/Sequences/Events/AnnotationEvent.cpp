@@ -91,6 +91,13 @@ AnnotationEvent AnnotationEvent::copyWithNewId() const noexcept
     return ae;
 }
 
+AnnotationEvent AnnotationEvent::withId(const MidiEvent::Id &newId) const noexcept
+{
+    AnnotationEvent ae(*this);
+    ae.id = newId;
+    return ae;
+}
+
 
 //===----------------------------------------------------------------------===//
 // Accessors
@@ -35,6 +35,7 @@ public:
     Array<MidiMessage> toMidiMessages() const override;
     
     AnnotationEvent copyWithNewId() const noexcept;
+    AnnotationEvent withId(const MidiEvent::Id &newId) const noexcept;
     AnnotationEvent withDeltaBeat(float beatOffset) const noexcept;
     AnnotationEvent withBeat(float newBeat) const noexcept;
     AnnotationEvent withDescription(const String &newDescription) const noexcept;
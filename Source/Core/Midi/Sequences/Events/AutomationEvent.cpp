@@ -171,6 +171,13 @@ AutomationEvent AutomationEvent::copyWithNewId() const noexcept
     return ae;
 }
 
+AutomationEvent AutomationEvent::withId(const MidiEvent::Id &newId) const noexcept
+{
+    AutomationEvent ae(*this);
+    ae.id = newId;
+    return ae;
+}
+
 AutomationEvent AutomationEvent::withBeat(float newBeat) const noexcept
 {
     AutomationEvent ae(*this);
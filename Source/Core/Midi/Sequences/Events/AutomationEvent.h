@@ -36,6 +36,7 @@ public:
     Array<MidiMessage> toMidiMessages() const override;
     
     AutomationEvent copyWithNewId() const noexcept;
+    AutomationEvent withId(const MidiEvent::Id &newId) const noexcept;
     AutomationEvent withBeat(float newBeat) const noexcept;
     AutomationEvent withDeltaBeat(float deltaBeat) const noexcept;
     AutomationEvent withInvertedControllerValue() const noexcept;
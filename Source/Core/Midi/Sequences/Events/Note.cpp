@@ -71,6 +71,13 @@ Note Note::copyWithNewId(WeakReference<MidiSequence> owner) const noexcept
     return n;
 }
 
+Note Note::withId(const MidiEvent::Id &newId) const noexcept
+{
+    Note n(*this);
+    n.id = newId;
+    return n;
+}
+
 Note Note::withBeat(float newBeat) const noexcept
 {
     Note other(*this);
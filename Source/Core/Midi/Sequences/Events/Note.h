@@ -37,6 +37,7 @@ public:
     Array<MidiMessage> toMidiMessages() const override;
     
     Note copyWithNewId(WeakReference<MidiSequence> owner = nullptr) const noexcept;
+    Note withId(const MidiEvent::Id &newId) const noexcept;
     Note withBeat(float newBeat) const noexcept;
     Note withKeyBeat(Key newKey, float newBeat) const noexcept;
     Note withDeltaBeat(float deltaPosition) const noexcept;
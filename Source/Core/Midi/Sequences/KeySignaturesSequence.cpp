@@ -32,8 +32,6 @@ KeySignaturesSequence::KeySignaturesSequence(MidiTrack &track,
 
 void KeySignaturesSequence::importMidi(const MidiMessageSequence &sequence)
 {
-    this->clearUndoHistory();
-    this->checkpoint();
     this->reset();
 
     for (int i = 0; i < sequence.getNumEvents(); ++i)
@@ -58,14 +56,14 @@ void KeySignaturesSequence::importMidi(const MidiMessageSequence &sequence)
                     (isMajor ? flatsMajor[n] : flatsMinor[n]) :
                     (isMajor ? sharpsMajor[n] : sharpsMinor[n]);
                 const double startTimestamp = message.getTimeStamp() / MIDI_IMPORT_SCALE;
-                const KeySignatureEvent signature(this,
+                this->midiEvents.add(new KeySignatureEvent(this,
                     float(startTimestamp), KEY_C5 + rootKey,
-                    isMajor ? Scale::getNaturalMajorScale() : Scale::getNaturalMiniorScale());
-                this->silentImport(signature);
+                    isMajor ? Scale::getNaturalMajorScale() : Scale::getNaturalMiniorScale())); // sorted later
             }
         }
     }
 
+    this->sort();
     this->updateBeatRange(false);
     this->invalidateSequenceCache();
 }
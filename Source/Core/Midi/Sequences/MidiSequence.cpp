@@ -21,20 +21,22 @@
 #include "ProjectTreeItem.h"
 #include "UndoStack.h"
 #include "MidiTrack.h"
+#include "Note.h"
 
 struct EventIdGenerator
 {
-    static String generateId(uint8 length = 2)
+    // Each sequence has its own generator, seeded randomly only once,
+    // so that ids can be created for different tracks on different threads
+    static String generateId(Random &r, uint8 length = 2)
     {
-        String id;
-        Random r;
-        r.setSeedRandomly();
+        char id[UINT8_MAX + 1];
         static const char idChars[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
         for (size_t i = 0; i < length; ++i)
         {
-            id += idChars[r.nextInt(62)];
+            id[i] = idChars[r.nextInt(62)];
         }
-        return id;
+        id[length] = 0;
+        return String(id);
     }
 };
 
@@ -44,8 +46,9 @@ MidiSequence::MidiSequence(MidiTrack &parentTrack,
     eventDispatcher(dispatcher),
     lastStartBeat(0.f),
     lastEndBeat(0.f),
-    cachedSequence(),
-    cacheIsOutdated(false) {}
+    cachedStream(nullptr),
+    cacheIsOutdated(true),
+    rangeIndexIsOutdated(true) {}
 
 MidiSequence::~MidiSequence()
 {
@@ -95,16 +98,16 @@ void MidiSequence::clearUndoHistory()
 // Import/export
 //===----------------------------------------------------------------------===//
 
-MidiMessageSequence MidiSequence::exportMidi() const
+MidiSequence::MidiStream::Ptr MidiSequence::exportMidiStream() const
 {
     if (this->track.isTrackMuted())
     {
-        return MidiMessageSequence();
+        return new MidiStream();
     }
     
-    if (this->cacheIsOutdated)
+    if (this->cacheIsOutdated || this->cachedStream == nullptr)
     {
-        this->cachedSequence.clear();
+        MidiStream::Ptr stream(new MidiStream());
 
         for (auto event : this->midiEvents)
         {
@@ -112,19 +115,22 @@ MidiMessageSequence MidiSequence::exportMidi() const
 
             for (auto &message : track)
             {
-                this->cachedSequence.addEvent(message);
+                stream->messages.addEvent(message);
             }
-
-            // need to call it here?
-            //this->cachedSequence.updateMatchedPairs();
         }
 
-        this->cachedSequence.updateMatchedPairs();
-        //this->cachedSequence.sort(); // will be sorted by caller
+        stream->messages.updateMatchedPairs();
+        stream->notes.build(stream->messages);
+        this->cachedStream = stream;
         this->cacheIsOutdated = false;
     }
 
-    return this->cachedSequence;
+    return this->cachedStream;
+}
+
+MidiMessageSequence MidiSequence::exportMidi() const
+{
+    return this->exportMidiStream()->messages;
 }
 
 //===----------------------------------------------------------------------===//
@@ -162,6 +168,74 @@ float MidiSequence::getLengthInBeats() const noexcept
 }
 
 
+//===----------------------------------------------------------------------===//
+// Range queries
+//===----------------------------------------------------------------------===//
+
+static inline float getEventEndBeat(const MidiEvent *event) noexcept
+{
+    if (event->isTypeOf(MidiEvent::Note))
+    {
+        const auto *note = static_cast<const Note *>(event);
+        return note->getBeat() + note->getLength();
+    }
+
+    return event->getBeat();
+}
+
+void MidiSequence::updateRangeIndexIfNeeded() const
+{
+    // the size check is for the listeners querying the sequence
+    // in the middle of a group removal, before the next invalidation
+    if (!this->rangeIndexIsOutdated &&
+        this->maxEndBeats.size() == this->midiEvents.size())
+    {
+        return;
+    }
+
+    this->maxEndBeats.clearQuick();
+    this->maxEndBeats.ensureStorageAllocated(this->midiEvents.size());
+
+    float maxEndBeat = -FLT_MAX;
+    for (const auto *event : this->midiEvents)
+    {
+        maxEndBeat = jmax(maxEndBeat, getEventEndBeat(event));
+        this->maxEndBeats.add(maxEndBeat);
+    }
+
+    this->rangeIndexIsOutdated = false;
+}
+
+int MidiSequence::indexOfFirstEventAt(float beat) const noexcept
+{
+    const auto found = std::lower_bound(this->midiEvents.begin(), this->midiEvents.end(), beat,
+        [](const MidiEvent *const event, float b) { return event->getBeat() < b; });
+
+    return int(found - this->midiEvents.begin());
+}
+
+void MidiSequence::findEventsInRange(float startBeat, float endBeat, Array<MidiEvent *> &result) const
+{
+    this->updateRangeIndexIfNeeded();
+
+    // all events before the first one that ends after startBeat end before the range,
+    // except the zero-length ones starting right at it
+    const auto firstEndingAfter = std::upper_bound(this->maxEndBeats.begin(), this->maxEndBeats.end(), startBeat);
+    const int firstIndex = jmin(int(firstEndingAfter - this->maxEndBeats.begin()),
+        this->indexOfFirstEventAt(startBeat));
+
+    const int lastIndex = this->indexOfFirstEventAt(endBeat);
+
+    for (int i = firstIndex; i < lastIndex; ++i)
+    {
+        auto *event = this->midiEvents.getUnchecked(i);
+        if (event->getBeat() >= startBeat || getEventEndBeat(event) > startBeat)
+        {
+            result.add(event);
+        }
+    }
+}
+
 MidiTrack *MidiSequence::getTrack() const noexcept
 {
     return &this->track;
@@ -184,31 +258,32 @@ UndoStack *MidiSequence::getUndoStack()
 
 void MidiSequence::notifyEventChanged(const MidiEvent &e1, const MidiEvent &e2)
 {
-    this->cacheIsOutdated = true;
+    this->invalidateSequenceCache();
     this->eventDispatcher.dispatchChangeEvent(e1, e2);
 }
 
 void MidiSequence::notifyEventAdded(const MidiEvent &event)
 {
-    this->cacheIsOutdated = true;
+    this->invalidateSequenceCache();
     this->eventDispatcher.dispatchAddEvent(event);
 }
 
 void MidiSequence::notifyEventRemoved(const MidiEvent &event)
 {
-    this->cacheIsOutdated = true;
+    this->invalidateSequenceCache();
     this->eventDispatcher.dispatchRemoveEvent(event);
 }
 
 void MidiSequence::notifyEventRemovedPostAction()
 {
-    this->cacheIsOutdated = true;
+    this->invalidateSequenceCache();
     this->eventDispatcher.dispatchPostRemoveEvent(this);
 }
 
 void MidiSequence::invalidateSequenceCache()
 {
     this->cacheIsOutdated = true;
+    this->rangeIndexIsOutdated = true;
 }
 
 void MidiSequence::updateBeatRange(bool shouldNotifyIfChanged)
@@ -231,17 +306,72 @@ void MidiSequence::updateBeatRange(bool shouldNotifyIfChanged)
 String MidiSequence::createUniqueEventId() const noexcept
 {
     uint8 length = 2;
-    String eventId = EventIdGenerator::generateId(length);
+    String eventId = EventIdGenerator::generateId(this->eventIdGenerator, length);
     while (this->usedEventIds.contains(eventId))
     {
         length++;
-        eventId = EventIdGenerator::generateId(length);
+        eventId = EventIdGenerator::generateId(this->eventIdGenerator, length);
     }
     
     this->usedEventIds.insert({eventId});
     return eventId;
 }
 
+Array<MidiEvent::Id> MidiSequence::createUniqueEventIds(int numIds) const
+{
+    const size_t expectedNumIds = this->usedEventIds.size() + size_t(numIds);
+
+    // pick the length so that random collisions stay rare
+    uint8 length = 2;
+    for (double capacity = 62.0 * 62.0; capacity < double(expectedNumIds) * 4.0; capacity *= 62.0)
+    {
+        length++;
+    }
+
+    this->usedEventIds.reserve(expectedNumIds);
+
+    Array<MidiEvent::Id> ids;
+    ids.ensureStorageAllocated(numIds);
+
+    while (ids.size() < numIds)
+    {
+        const String eventId = EventIdGenerator::generateId(this->eventIdGenerator, length);
+        if (this->usedEventIds.insert(eventId).second)
+        {
+            ids.add(eventId);
+        }
+    }
+
+    return ids;
+}
+
+void MidiSequence::insertOwnedEvents(Array<MidiEvent *> &newEvents)
+{
+    const auto comparator = [](const MidiEvent *const a, const MidiEvent *const b)
+    {
+        return MidiEvent::compareElements(a, b) < 0;
+    };
+
+    std::sort(newEvents.begin(), newEvents.end(), comparator);
+
+    const int numOldEvents = this->midiEvents.size();
+    this->midiEvents.ensureStorageAllocated(numOldEvents + newEvents.size());
+
+    for (auto *event : newEvents)
+    {
+        this->midiEvents.add(event);
+    }
+
+    std::inplace_merge(this->midiEvents.begin(),
+        this->midiEvents.begin() + numOldEvents,
+        this->midiEvents.end(), comparator);
+
+    for (const auto *event : newEvents)
+    {
+        this->notifyEventAdded(*event);
+    }
+}
+
 //===----------------------------------------------------------------------===//
 // Helpers
 //===----------------------------------------------------------------------===//
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "MidiEvent.h"
+#include "NoteIntervalsIndex.h"
 
 class ProjectTreeItem;
 class ProjectEventDispatcher;
@@ -48,7 +49,23 @@ public:
     // Import/export
     //===------------------------------------------------------------------===//
 
+    // The exported messages are shared by all clips playing this sequence;
+    // each change creates a new stream instead of modifying the old one,
+    // so that it can still be played until the transport picks up the new one
+    struct MidiStream final : public ReferenceCountedObject
+    {
+        MidiMessageSequence messages;
+        NoteIntervalsIndex notes;
+        using Ptr = ReferenceCountedObjectPtr<MidiStream>;
+    };
+
+    MidiStream::Ptr exportMidiStream() const;
     MidiMessageSequence exportMidi() const;
+
+    // Replaces all events with the ones parsed from the sequence,
+    // sorting them only once in the end. Doesn't touch the undo stack
+    // and doesn't notify anybody, so that it can be called on a worker
+    // thread for a track that is not yet added to the project.
     virtual void importMidi(const MidiMessageSequence &sequence) = 0;
     
     //===------------------------------------------------------------------===//
@@ -69,6 +86,19 @@ public:
     float getLengthInBeats() const noexcept;
     MidiTrack *getTrack() const noexcept;
 
+    //===------------------------------------------------------------------===//
+    // Range queries
+    //===------------------------------------------------------------------===//
+
+    // Finds the events that start in, end in or overlap [startBeat, endBeat),
+    // in the sorted order; only notes have length, so any other event
+    // is found if it starts within the range
+    void findEventsInRange(float startBeat, float endBeat, Array<MidiEvent *> &result) const;
+
+    // The index of the first event starting at or after the beat,
+    // or size() if there's none
+    int indexOfFirstEventAt(float beat) const noexcept;
+
     //===------------------------------------------------------------------===//
     // OwnedArray wrapper
     //===------------------------------------------------------------------===//
@@ -103,7 +133,7 @@ public:
     void notifyEventRemoved(const MidiEvent &event);
     void notifyEventRemovedPostAction();
 
-    void invalidateSequenceCache();
+    virtual void invalidateSequenceCache();
     void updateBeatRange(bool shouldNotifyIfChanged);
 
     //===------------------------------------------------------------------===//
@@ -111,6 +141,9 @@ public:
     //===------------------------------------------------------------------===//
 
     String createUniqueEventId() const noexcept;
+
+    // Allocates a batch of ids at once, e.g. for pasting lots of events
+    Array<MidiEvent::Id> createUniqueEventIds(int numIds) const;
     String getTrackId() const noexcept;
     int getChannel() const noexcept;
 
@@ -132,14 +165,25 @@ protected:
     ProjectTreeItem *getProject();
     UndoStack *getUndoStack();
 
+    // Takes ownership of the new events and merges them into the sorted
+    // array in one pass, instead of searching a place for each of them
+    void insertOwnedEvents(Array<MidiEvent *> &newEvents);
+
     OwnedArray<MidiEvent> midiEvents;
     mutable SparseHashSet<MidiEvent::Id, StringHash> usedEventIds;
+    mutable Random eventIdGenerator;
 
 private:
 
-    mutable MidiMessageSequence cachedSequence;
+    mutable MidiStream::Ptr cachedStream;
     mutable bool cacheIsOutdated;
 
+    // The max end beat of the events up to each index; it never decreases,
+    // so the first event that can overlap a beat is a binary search away
+    mutable Array<float> maxEndBeats;
+    mutable bool rangeIndexIsOutdated;
+    void updateRangeIndexIfNeeded() const;
+
 private:
     
     WeakReference<MidiSequence>::Master masterReference;
@@ -0,0 +1,99 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "NoteIntervalsIndex.h"
+
+void NoteIntervalsIndex::build(const MidiMessageSequence &sequence)
+{
+    this->notes.clearQuick();
+
+    // the sequence is sorted by time, so are the notes
+    for (int i = 0; i < sequence.getNumEvents(); ++i)
+    {
+        const auto *noteOn = sequence.getEventPointer(i);
+        if (noteOn->noteOffObject != nullptr && noteOn->message.isNoteOn())
+        {
+            this->notes.add({ noteOn->message.getTimeStamp(),
+                noteOn->noteOffObject->message.getTimeStamp(), i });
+        }
+    }
+
+    this->maxEnds.clearQuick();
+    this->maxEnds.insertMultiple(0, 0.0, this->notes.size());
+    this->buildMaxEnds(0, this->notes.size());
+}
+
+void NoteIntervalsIndex::findNotesAt(double time, Array<int> &result) const
+{
+    this->findOverlaps(0, this->notes.size(), time, time, true, result);
+}
+
+void NoteIntervalsIndex::findNotesInRange(double startTime, double endTime, Array<int> &result) const
+{
+    this->findOverlaps(0, this->notes.size(), startTime, endTime, false, result);
+}
+
+double NoteIntervalsIndex::buildMaxEnds(int begin, int end)
+{
+    if (begin >= end)
+    {
+        return std::numeric_limits<double>::lowest();
+    }
+
+    const int middle = begin + (end - begin) / 2;
+    const double maxEnd = jmax(this->notes.getReference(middle).end,
+        this->buildMaxEnds(begin, middle),
+        this->buildMaxEnds(middle + 1, end));
+
+    this->maxEnds.set(middle, maxEnd);
+    return maxEnd;
+}
+
+void NoteIntervalsIndex::findOverlaps(int begin, int end, double startTime,
+    double endTime, bool includeEndTime, Array<int> &result) const
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    const int middle = begin + (end - begin) / 2;
+
+    // nothing in this range lasts until the query
+    if (this->maxEnds.getUnchecked(middle) <= startTime)
+    {
+        return;
+    }
+
+    this->findOverlaps(begin, middle, startTime, endTime, includeEndTime, result);
+
+    // everything to the right starts even later than the middle
+    const auto &note = this->notes.getReference(middle);
+    const bool startsInTime = includeEndTime ? (note.start <= endTime) : (note.start < endTime);
+    if (!startsInTime)
+    {
+        return;
+    }
+
+    if (note.end > startTime)
+    {
+        result.add(note.eventIndex);
+    }
+
+    this->findOverlaps(middle + 1, end, startTime, endTime, includeEndTime, result);
+}
@@ -0,0 +1,55 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// A static interval tree over the notes of an exported midi sequence,
+// answering which notes are sounding at some time, or within some range,
+// in O(log n + k). The notes are kept sorted by their start time, and each
+// element in the middle of a range stores the latest end time within it,
+// so the ranges ending before the query are skipped as a whole.
+class NoteIntervalsIndex final
+{
+public:
+
+    NoteIntervalsIndex() = default;
+
+    // Expects the sequence to have its note-offs matched
+    void build(const MidiMessageSequence &sequence);
+
+    // Both append the indices of the note-on events in the sequence
+    void findNotesAt(double time, Array<int> &result) const;
+    void findNotesInRange(double startTime, double endTime, Array<int> &result) const;
+
+private:
+
+    struct Note final
+    {
+        double start;
+        double end;
+        int eventIndex;
+    };
+
+    double buildMaxEnds(int begin, int end);
+    void findOverlaps(int begin, int end, double startTime,
+        double endTime, bool includeEndTime, Array<int> &result) const;
+
+    Array<Note> notes;
+    Array<double> maxEnds;
+
+    JUCE_LEAK_DETECTOR(NoteIntervalsIndex)
+};
@@ -0,0 +1,262 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "NotesCache.h"
+#include "ProjectTreeItem.h"
+#include "PianoSequence.h"
+#include "MidiTrack.h"
+#include "Note.h"
+
+NotesCache::NotesCache(ProjectTreeItem &parentProject) :
+    project(parentProject),
+    isOutdated(true) {}
+
+NotesCache::~NotesCache() {}
+
+const OwnedArray<NotesCache::Columns> &NotesCache::getColumns() const
+{
+    this->rebuildIfNeeded();
+    return this->columns;
+}
+
+const NotesCache::Columns *NotesCache::findColumns(const MidiSequence *sequence) const
+{
+    this->rebuildIfNeeded();
+    const auto found = this->columnsBySequence.find(sequence);
+    return (found != this->columnsBySequence.end()) ? found->second : nullptr;
+}
+
+void NotesCache::rebuildIfNeeded() const
+{
+    if (!this->isOutdated)
+    {
+        return;
+    }
+
+    this->columns.clear();
+    this->columnsBySequence.clear();
+    this->rows.clear();
+
+    const auto tracks = this->project.getTracks();
+
+    size_t numEvents = 0;
+    for (const auto *track : tracks)
+    {
+        numEvents += size_t(track->getSequence()->size());
+    }
+
+    this->rows.reserve(numEvents);
+
+    for (const auto *track : tracks)
+    {
+        this->addTrack(track);
+    }
+
+    this->isOutdated = false;
+}
+
+void NotesCache::addTrack(const MidiTrack *track) const
+{
+    const auto *sequence = dynamic_cast<const PianoSequence *>(track->getSequence());
+    if (sequence == nullptr || this->columnsBySequence.contains(sequence))
+    {
+        return;
+    }
+
+    auto *newColumns = this->columns.add(new Columns());
+    newColumns->sequence = sequence;
+    this->columnsBySequence[sequence] = newColumns;
+
+    const int numNotes = sequence->size();
+    newColumns->notes.ensureStorageAllocated(numNotes);
+    newColumns->keys.ensureStorageAllocated(numNotes);
+    newColumns->beats.ensureStorageAllocated(numNotes);
+    newColumns->lengths.ensureStorageAllocated(numNotes);
+    newColumns->velocities.ensureStorageAllocated(numNotes);
+
+    for (const auto *event : *sequence)
+    {
+        this->addNote(*newColumns, static_cast<const Note &>(*event));
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Rows
+//===----------------------------------------------------------------------===//
+
+void NotesCache::addNote(Columns &target, const Note &note) const
+{
+    this->rows[&note] = target.size();
+    target.notes.add(&note);
+    target.keys.add(note.getKey());
+    target.beats.add(note.getBeat());
+    target.lengths.add(note.getLength());
+    target.velocities.add(note.getVelocity());
+}
+
+void NotesCache::updateNote(const Note &note)
+{
+    const auto row = this->rows.find(&note);
+    const auto target = this->columnsBySequence.find(note.getSequence());
+    if (row == this->rows.end() || target == this->columnsBySequence.end())
+    {
+        return;
+    }
+
+    auto &columns = *target->second;
+    const int i = row->second;
+    columns.keys.setUnchecked(i, note.getKey());
+    columns.beats.setUnchecked(i, note.getBeat());
+    columns.lengths.setUnchecked(i, note.getLength());
+    columns.velocities.setUnchecked(i, note.getVelocity());
+}
+
+void NotesCache::removeNote(const Note &note)
+{
+    const auto row = this->rows.find(&note);
+    const auto target = this->columnsBySequence.find(note.getSequence());
+    if (row == this->rows.end() || target == this->columnsBySequence.end())
+    {
+        return;
+    }
+
+    auto &columns = *target->second;
+    const int i = row->second;
+    const int last = columns.size() - 1;
+    this->rows.erase(row);
+
+    // move the last row into the gap
+    if (i != last)
+    {
+        const Note *lastNote = columns.notes.getUnchecked(last);
+        columns.notes.setUnchecked(i, lastNote);
+        columns.keys.setUnchecked(i, columns.keys.getUnchecked(last));
+        columns.beats.setUnchecked(i, columns.beats.getUnchecked(last));
+        columns.lengths.setUnchecked(i, columns.lengths.getUnchecked(last));
+        columns.velocities.setUnchecked(i, columns.velocities.getUnchecked(last));
+        this->rows[lastNote] = i;
+    }
+
+    columns.notes.removeLast();
+    columns.keys.removeLast();
+    columns.beats.removeLast();
+    columns.lengths.removeLast();
+    columns.velocities.removeLast();
+}
+
+//===----------------------------------------------------------------------===//
+// ProjectListener
+//===----------------------------------------------------------------------===//
+
+void NotesCache::onAddMidiEvent(const MidiEvent &event)
+{
+    if (this->isOutdated || !event.isTypeOf(MidiEvent::Note))
+    {
+        return;
+    }
+
+    const Note &note = static_cast<const Note &>(event);
+    if (this->rows.contains(&note))
+    {
+        this->updateNote(note);
+        return;
+    }
+
+    const auto target = this->columnsBySequence.find(note.getSequence());
+    if (target != this->columnsBySequence.end())
+    {
+        this->addNote(*target->second, note);
+    }
+}
+
+void NotesCache::onChangeMidiEvent(const MidiEvent &oldEvent, const MidiEvent &newEvent)
+{
+    // the new event is the one owned by the sequence, changed in place
+    if (!this->isOutdated && newEvent.isTypeOf(MidiEvent::Note))
+    {
+        this->updateNote(static_cast<const Note &>(newEvent));
+    }
+}
+
+void NotesCache::onRemoveMidiEvent(const MidiEvent &event)
+{
+    if (!this->isOutdated && event.isTypeOf(MidiEvent::Note))
+    {
+        this->removeNote(static_cast<const Note &>(event));
+    }
+}
+
+void NotesCache::onAddTrack(MidiTrack *const track)
+{
+    if (this->isOutdated)
+    {
+        return;
+    }
+
+    // some actions add a track empty, and deserialize its notes afterwards,
+    // which doesn't send any events, so rescan it on the next request
+    if (track->getSequence()->size() == 0)
+    {
+        this->isOutdated = true;
+        return;
+    }
+
+    this->addTrack(track);
+}
+
+void NotesCache::onRemoveTrack(MidiTrack *const track)
+{
+    if (this->isOutdated)
+    {
+        return;
+    }
+
+    const auto target = this->columnsBySequence.find(track->getSequence());
+    if (target == this->columnsBySequence.end())
+    {
+        return;
+    }
+
+    Columns *removedColumns = target->second;
+    for (const auto *note : removedColumns->notes)
+    {
+        this->rows.erase(note);
+    }
+
+    this->columnsBySequence.erase(target);
+    this->columns.removeObject(removedColumns);
+}
+
+void NotesCache::onChangeTrackProperties(MidiTrack *const track)
+{
+    // a track filled silently still gets its properties changed afterwards
+    if (!this->isOutdated)
+    {
+        const auto target = this->columnsBySequence.find(track->getSequence());
+        if (target != this->columnsBySequence.end() &&
+            target->second->size() != track->getSequence()->size())
+        {
+            this->isOutdated = true;
+        }
+    }
+}
+
+void NotesCache::onReloadProjectContent(const Array<MidiTrack *> &tracks)
+{
+    this->isOutdated = true;
+}
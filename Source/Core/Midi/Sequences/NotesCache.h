@@ -0,0 +1,95 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+class ProjectTreeItem;
+class Note;
+
+#include "ProjectListener.h"
+
+// A read-optimized copy of the parameters of all notes in the project,
+// stored column by column, so that scanning the whole project by some
+// parameter only touches the memory of that parameter.
+//
+// The rows are kept in no particular order: a changed note is updated
+// in place, an added one is appended, and a removed one is replaced
+// with the last row, so that each project event costs a hash lookup.
+// The notes are keyed by their addresses, which don't change
+// while they live in their sequences.
+class NotesCache final : public ProjectListener
+{
+public:
+
+    explicit NotesCache(ProjectTreeItem &project);
+    ~NotesCache() override;
+
+    struct Columns final
+    {
+        const MidiSequence *sequence;
+
+        Array<const Note *> notes;
+        Array<int> keys;
+        Array<float> beats;
+        Array<float> lengths;
+        Array<float> velocities;
+
+        inline int size() const noexcept
+        { return this->notes.size(); }
+    };
+
+    // The columns of all piano sequences in the project
+    const OwnedArray<Columns> &getColumns() const;
+    const Columns *findColumns(const MidiSequence *sequence) const;
+
+    //===------------------------------------------------------------------===//
+    // ProjectListener
+    //===------------------------------------------------------------------===//
+
+    void onAddMidiEvent(const MidiEvent &event) override;
+    void onChangeMidiEvent(const MidiEvent &oldEvent, const MidiEvent &newEvent) override;
+    void onRemoveMidiEvent(const MidiEvent &event) override;
+
+    void onAddTrack(MidiTrack *const track) override;
+    void onRemoveTrack(MidiTrack *const track) override;
+    void onChangeTrackProperties(MidiTrack *const track) override;
+
+    void onChangeProjectBeatRange(float firstBeat, float lastBeat) override {}
+    void onChangeViewBeatRange(float firstBeat, float lastBeat) override {}
+    void onReloadProjectContent(const Array<MidiTrack *> &tracks) override;
+
+private:
+
+    void rebuildIfNeeded() const;
+    void addTrack(const MidiTrack *track) const;
+
+    void addNote(Columns &columns, const Note &note) const;
+    void updateNote(const Note &note);
+    void removeNote(const Note &note);
+
+    ProjectTreeItem &project;
+
+    // All the structures are rebuilt lazily on the first request
+    // after the project is loaded or reset, or after a track was filled
+    // silently, e.g. deserialized by an undo action, without any events
+    mutable OwnedArray<Columns> columns;
+    mutable SparseHashMap<const MidiSequence *, Columns *> columnsBySequence;
+    mutable SparseHashMap<const Note *, int> rows;
+    mutable bool isOutdated;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NotesCache)
+};
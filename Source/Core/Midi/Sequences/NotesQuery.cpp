@@ -0,0 +1,239 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "NotesQuery.h"
+#include "ProjectTreeItem.h"
+#include "ProjectTimeline.h"
+#include "KeySignatureEvent.h"
+#include "TimeSignaturesSequence.h"
+#include "MidiTrack.h"
+
+NotesQuery::NotesQuery(const ProjectTreeItem &parentProject) :
+    project(parentProject),
+    minKey(INT_MIN),
+    maxKey(INT_MAX),
+    minVelocity(-FLT_MAX),
+    maxVelocity(FLT_MAX),
+    startBeat(-FLT_MAX),
+    endBeat(FLT_MAX),
+    onlyOutOfScale(false) {}
+
+//===----------------------------------------------------------------------===//
+// Filters
+//===----------------------------------------------------------------------===//
+
+NotesQuery &NotesQuery::withinTracks(const Array<MidiSequence *> &newSequences)
+{
+    this->sequences.clearQuick();
+    for (const auto *sequence : newSequences)
+    {
+        this->sequences.add(sequence);
+    }
+
+    return *this;
+}
+
+NotesQuery &NotesQuery::withKeysBetween(int newMinKey, int newMaxKey)
+{
+    this->minKey = newMinKey;
+    this->maxKey = newMaxKey;
+    return *this;
+}
+
+NotesQuery &NotesQuery::withVelocitiesBetween(float newMinVelocity, float newMaxVelocity)
+{
+    this->minVelocity = newMinVelocity;
+    this->maxVelocity = newMaxVelocity;
+    return *this;
+}
+
+NotesQuery &NotesQuery::startingWithin(float newStartBeat, float newEndBeat)
+{
+    this->startBeat = newStartBeat;
+    this->endBeat = newEndBeat;
+    return *this;
+}
+
+NotesQuery &NotesQuery::outOfScale()
+{
+    this->onlyOutOfScale = true;
+    this->keySignatures.clearQuick();
+
+    // the scales are checked for each note, so turn them into bit masks once;
+    // the key signatures are sorted by beat, just like any other events
+    const auto *sequence = this->project.getTimeline()->getKeySignatures()->getSequence();
+    for (const auto *event : *sequence)
+    {
+        const auto &signature = static_cast<const KeySignatureEvent &>(*event);
+
+        int mask = 0;
+        for (int key = 0; key < CHROMATIC_SCALE_SIZE; ++key)
+        {
+            if (signature.getScale().hasKey(key))
+            {
+                mask |= (1 << key);
+            }
+        }
+
+        this->keySignatures.add({ signature.getBeat(), signature.getRootKey(), mask });
+    }
+
+    return *this;
+}
+
+//===----------------------------------------------------------------------===//
+// Results
+//===----------------------------------------------------------------------===//
+
+void NotesQuery::findNotes(Array<const Note *> &result) const
+{
+    Array<int> rows;
+    for (const auto *columns : this->project.getNotesCache().getColumns())
+    {
+        if (this->shouldScan(*columns))
+        {
+            rows.clearQuick();
+            this->findMatchingRows(*columns, rows);
+
+            for (const int row : rows)
+            {
+                result.add(columns->notes.getUnchecked(row));
+            }
+        }
+    }
+}
+
+int NotesQuery::countNotes() const
+{
+    int numNotes = 0;
+    Array<int> rows;
+    for (const auto *columns : this->project.getNotesCache().getColumns())
+    {
+        if (this->shouldScan(*columns))
+        {
+            rows.clearQuick();
+            this->findMatchingRows(*columns, rows);
+            numNotes += rows.size();
+        }
+    }
+
+    return numNotes;
+}
+
+void NotesQuery::countNotesPerTrack(Array<const MidiSequence *> &resultSequences, Array<int> &counts) const
+{
+    Array<int> rows;
+    for (const auto *columns : this->project.getNotesCache().getColumns())
+    {
+        if (this->shouldScan(*columns))
+        {
+            rows.clearQuick();
+            this->findMatchingRows(*columns, rows);
+            resultSequences.add(columns->sequence);
+            counts.add(rows.size());
+        }
+    }
+}
+
+void NotesQuery::countNotesPerBar(Array<int> &counts) const
+{
+    // the bars follow the time signatures, and the index finds them by beat
+    const auto *timeSignatures = dynamic_cast<const TimeSignaturesSequence *>
+        (this->project.getTimeline()->getTimeSignatures()->getSequence());
+
+    if (timeSignatures == nullptr)
+    {
+        return;
+    }
+
+    const int firstBar = timeSignatures->getBarByBeat(0.f);
+
+    Array<int> rows;
+    for (const auto *columns : this->project.getNotesCache().getColumns())
+    {
+        if (this->shouldScan(*columns))
+        {
+            rows.clearQuick();
+            this->findMatchingRows(*columns, rows);
+
+            for (const int row : rows)
+            {
+                const float beat = columns->beats.getUnchecked(row);
+                const int bar = jmax(0, timeSignatures->getBarByBeat(beat) - firstBar);
+
+                while (counts.size() <= bar)
+                {
+                    counts.add(0);
+                }
+
+                counts.getReference(bar)++;
+            }
+        }
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Scanning
+//===----------------------------------------------------------------------===//
+
+bool NotesQuery::shouldScan(const Columns &columns) const
+{
+    return this->sequences.isEmpty() || this->sequences.contains(columns.sequence);
+}
+
+void NotesQuery::findMatchingRows(const Columns &columns, Array<int> &result) const
+{
+    const int numRows = columns.size();
+    const int *keys = columns.keys.begin();
+    const float *beats = columns.beats.begin();
+    const float *velocities = columns.velocities.begin();
+
+    const bool checksScale = this->onlyOutOfScale && !this->keySignatures.isEmpty();
+    if (this->onlyOutOfScale && !checksScale)
+    {
+        return;
+    }
+
+    for (int i = 0; i < numRows; ++i)
+    {
+        if (keys[i] < this->minKey || keys[i] > this->maxKey ||
+            velocities[i] < this->minVelocity || velocities[i] >= this->maxVelocity ||
+            beats[i] < this->startBeat || beats[i] >= this->endBeat)
+        {
+            continue;
+        }
+
+        if (checksScale && !this->isOutOfScale(keys[i], beats[i]))
+        {
+            continue;
+        }
+
+        result.add(i);
+    }
+}
+
+bool NotesQuery::isOutOfScale(int key, float beat) const noexcept
+{
+    // the last key signature starting at or before the beat
+    const auto found = std::upper_bound(this->keySignatures.begin(), this->keySignatures.end(), beat,
+        [](float b, const KeySignatureSpan &span) { return b < span.startBeat; });
+
+    const auto &span = (found == this->keySignatures.begin()) ? *found : *(found - 1);
+    const int chromaticKey = ((key - span.rootKey) % CHROMATIC_SCALE_SIZE + CHROMATIC_SCALE_SIZE) % CHROMATIC_SCALE_SIZE;
+    return (span.inScaleKeysMask & (1 << chromaticKey)) == 0;
+}
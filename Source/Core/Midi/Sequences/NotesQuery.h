@@ -0,0 +1,102 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+class ProjectTreeItem;
+class MidiSequence;
+class Note;
+
+#include "NotesCache.h"
+
+// Filters and aggregates the notes of the whole project, or of some tracks,
+// by scanning the columns of the project's notes cache. All filters are
+// combined, and a query with no filters matches every note, e.g.:
+//
+//     Array<const Note *> quietNotes;
+//     NotesQuery(project).withVelocitiesBetween(0.f, 0.15f).findNotes(quietNotes);
+//
+class NotesQuery final
+{
+public:
+
+    explicit NotesQuery(const ProjectTreeItem &project);
+
+    //===------------------------------------------------------------------===//
+    // Filters
+    //===------------------------------------------------------------------===//
+
+    NotesQuery &withinTracks(const Array<MidiSequence *> &sequences);
+
+    // Both limits are inclusive
+    NotesQuery &withKeysBetween(int minKey, int maxKey);
+
+    // [minVelocity, maxVelocity)
+    NotesQuery &withVelocitiesBetween(float minVelocity, float maxVelocity);
+
+    // Notes starting within [startBeat, endBeat)
+    NotesQuery &startingWithin(float startBeat, float endBeat);
+
+    // Notes out of the scale of the key signature at their beats;
+    // the first key signature also applies to the notes before it,
+    // and nothing is out of scale in a project without key signatures
+    NotesQuery &outOfScale();
+
+    //===------------------------------------------------------------------===//
+    // Results
+    //===------------------------------------------------------------------===//
+
+    void findNotes(Array<const Note *> &result) const;
+    int countNotes() const;
+
+    // Both are aligned with the given arrays: the counts per sequence,
+    // and the counts per bar, starting from the bar at beat 0;
+    // the bars are of the time signatures in effect
+    void countNotesPerTrack(Array<const MidiSequence *> &sequences, Array<int> &counts) const;
+    void countNotesPerBar(Array<int> &counts) const;
+
+private:
+
+    struct KeySignatureSpan final
+    {
+        float startBeat;
+        int rootKey;
+        int inScaleKeysMask;
+    };
+
+    using Columns = NotesCache::Columns;
+
+    void findMatchingRows(const Columns &columns, Array<int> &result) const;
+    bool isOutOfScale(int key, float beat) const noexcept;
+    bool shouldScan(const Columns &columns) const;
+
+    const ProjectTreeItem &project;
+
+    Array<const MidiSequence *> sequences;
+
+    int minKey;
+    int maxKey;
+    float minVelocity;
+    float maxVelocity;
+    float startBeat;
+    float endBeat;
+
+    bool onlyOutOfScale;
+    Array<KeySignatureSpan> keySignatures;
+
+    JUCE_LEAK_DETECTOR(NotesQuery)
+};
@@ -37,9 +37,8 @@ PianoSequence::PianoSequence(MidiTrack &track,
 
 void PianoSequence::importMidi(const MidiMessageSequence &sequence)
 {
-    this->clearUndoHistory();
-    this->checkpoint();
     this->reset();
+    this->midiEvents.ensureStorageAllocated(sequence.getNumEvents() / 2);
 
     for (int i = 0; i < sequence.getNumEvents(); ++i)
     {
@@ -64,14 +63,13 @@ void PianoSequence::importMidi(const MidiMessageSequence &sequence)
                 {
                     const float length = float(endTimestamp - startTimestamp);
 
-                    // bottleneck warning
-                    const Note note(this, key, beat, length, velocity);
-                    this->silentImport(note);
+                    this->midiEvents.add(new Note(this, key, beat, length, velocity)); // sorted later
                 }
             }
         }
     }
 
+    this->sort();
     this->updateBeatRange(false);
     this->invalidateSequenceCache();
 }
@@ -189,14 +187,16 @@ bool PianoSequence::insertGroup(Array<Note> &group, bool undoable)
     }
     else
     {
+        Array<MidiEvent *> newEvents;
+        newEvents.ensureStorageAllocated(group.size());
+
         for (int i = 0; i < group.size(); ++i)
         {
             const Note &eventParams = group.getUnchecked(i);
-            const auto ownedNote = new Note(this, eventParams);
-            this->midiEvents.addSorted(*ownedNote, ownedNote);
-            this->notifyEventAdded(*ownedNote);
+            newEvents.add(new Note(this, eventParams));
         }
 
+        this->insertOwnedEvents(newEvents);
         this->updateBeatRange(true);
     }
 
@@ -25,7 +25,8 @@
 
 TimeSignaturesSequence::TimeSignaturesSequence(MidiTrack &track,
     ProjectEventDispatcher &dispatcher) noexcept :
-    MidiSequence(track, dispatcher) {}
+    MidiSequence(track, dispatcher),
+    metersAreOutdated(true) {}
 
 //===----------------------------------------------------------------------===//
 // Import/export
@@ -33,8 +34,6 @@ TimeSignaturesSequence::TimeSignaturesSequence(MidiTrack &track,
 
 void TimeSignaturesSequence::importMidi(const MidiMessageSequence &sequence)
 {
-    this->clearUndoHistory();
-    this->checkpoint();
     this->reset();
 
     for (int i = 0; i < sequence.getNumEvents(); ++i)
@@ -48,11 +47,11 @@ void TimeSignaturesSequence::importMidi(const MidiMessageSequence &sequence)
             message.getTimeSignatureInfo(numerator, denominator);
             const double startTimestamp = message.getTimeStamp() / MIDI_IMPORT_SCALE;
             const float beat = float(startTimestamp);
-            const TimeSignatureEvent signature(this, beat, numerator, denominator);
-            this->silentImport(signature);
+            this->midiEvents.add(new TimeSignatureEvent(this, beat, numerator, denominator)); // sorted later
         }
     }
 
+    this->sort();
     this->updateBeatRange(false);
     this->invalidateSequenceCache();
 }
@@ -244,6 +243,104 @@ bool TimeSignaturesSequence::changeGroup(Array<TimeSignatureEvent> &groupBefore,
     return true;
 }
 
+//===----------------------------------------------------------------------===//
+// Bar grid
+//===----------------------------------------------------------------------===//
+
+// Tolerates float errors when counting the bars up to the next meter
+#define TIME_SIGNATURES_BAR_EPSILON 0.0001f
+
+const TimeSignaturesSequence::Meter &TimeSignaturesSequence::getMeterByBeat(float beat) const
+{
+    this->rebuildMetersIfNeeded();
+
+    const auto found = std::upper_bound(this->meters.begin(), this->meters.end(), beat,
+        [](float b, const Meter &meter) { return b < meter.startBeat; });
+
+    return (found == this->meters.begin()) ? *found : *(found - 1);
+}
+
+const TimeSignaturesSequence::Meter &TimeSignaturesSequence::getMeterByBar(int bar) const
+{
+    this->rebuildMetersIfNeeded();
+
+    const auto found = std::upper_bound(this->meters.begin(), this->meters.end(), bar,
+        [](int b, const Meter &meter) { return b < meter.firstBar; });
+
+    return (found == this->meters.begin()) ? *found : *(found - 1);
+}
+
+int TimeSignaturesSequence::getBarByBeat(float beat) const
+{
+    const auto &meter = this->getMeterByBeat(beat);
+    const float barsInMeter = (beat - meter.startBeat) / meter.barLength;
+    return meter.firstBar + int(floorf(barsInMeter + TIME_SIGNATURES_BAR_EPSILON));
+}
+
+float TimeSignaturesSequence::getBeatByBar(int bar) const
+{
+    const auto &meter = this->getMeterByBar(bar);
+    return meter.startBeat + float(bar - meter.firstBar) * meter.barLength;
+}
+
+Range<float> TimeSignaturesSequence::getBarRange(int bar) const
+{
+    const auto &meter = this->getMeterByBar(bar);
+    const float barStart = meter.startBeat + float(bar - meter.firstBar) * meter.barLength;
+    float barEnd = barStart + meter.barLength;
+
+    const auto *nextMeter = &meter + 1;
+    if (nextMeter != this->meters.end())
+    {
+        barEnd = jmin(barEnd, nextMeter->startBeat);
+    }
+
+    return { barStart, barEnd };
+}
+
+void TimeSignaturesSequence::invalidateSequenceCache()
+{
+    MidiSequence::invalidateSequenceCache();
+    this->metersAreOutdated = true;
+}
+
+void TimeSignaturesSequence::rebuildMetersIfNeeded() const
+{
+    if (!this->metersAreOutdated)
+    {
+        return;
+    }
+
+    this->meters.clearQuick();
+    this->metersAreOutdated = false;
+
+    if (this->midiEvents.isEmpty())
+    {
+        const float beatLength = float(BEATS_PER_BAR) / float(TIME_SIGNATURE_DEFAULT_DENOMINATOR);
+        this->meters.add({ 0.f, beatLength * TIME_SIGNATURE_DEFAULT_NUMERATOR, beatLength, 0, nullptr });
+        return;
+    }
+
+    this->meters.ensureStorageAllocated(this->midiEvents.size());
+
+    for (const auto *event : this->midiEvents)
+    {
+        const auto *signature = static_cast<const TimeSignatureEvent *>(event);
+        const float beatLength = float(BEATS_PER_BAR) / float(jmax(1, signature->getDenominator()));
+        const float barLength = beatLength * float(jmax(1, signature->getNumerator()));
+
+        int firstBar = 0;
+        if (!this->meters.isEmpty())
+        {
+            // The incomplete bar before the signature change still counts
+            const auto &previous = this->meters.getReference(this->meters.size() - 1);
+            const float numBars = (signature->getBeat() - previous.startBeat) / previous.barLength;
+            firstBar = previous.firstBar + int(ceilf(numBars - TIME_SIGNATURES_BAR_EPSILON));
+        }
+
+        this->meters.add({ signature->getBeat(), barLength, beatLength, firstBar, signature });
+    }
+}
 
 //===----------------------------------------------------------------------===//
 // Serializable
@@ -51,6 +51,34 @@ public:
         Array<TimeSignatureEvent> &signaturesAfter,
         bool undoable);
 
+    //===------------------------------------------------------------------===//
+    // Bar grid
+    //===------------------------------------------------------------------===//
+
+    // A span of bars sharing the same time signature; all lengths are in beats.
+    // The first meter also extends back to the negative infinity,
+    // and the last bar of each meter may be incomplete
+    struct Meter final
+    {
+        float startBeat;
+        float barLength;
+        float beatLength;
+        int firstBar;
+        const TimeSignatureEvent *signature; // nullptr for the default meter
+    };
+
+    // The meters are indexed lazily after any change in the sequence,
+    // so that all lookups below are binary searches
+    const Meter &getMeterByBeat(float beat) const;
+    const Meter &getMeterByBar(int bar) const;
+    int getBarByBeat(float beat) const;
+    float getBeatByBar(int bar) const;
+
+    // Both the returned bar's boundaries, clamped at the meter change
+    Range<float> getBarRange(int bar) const;
+
+    void invalidateSequenceCache() override;
+
     //===------------------------------------------------------------------===//
     // Serializable
     //===------------------------------------------------------------------===//
@@ -61,5 +89,10 @@ public:
 
 private:
 
+    void rebuildMetersIfNeeded() const;
+
+    mutable Array<Meter> meters;
+    mutable bool metersAreOutdated;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimeSignaturesSequence);
 };
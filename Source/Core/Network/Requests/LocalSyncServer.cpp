@@ -0,0 +1,414 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+
+#if HELIO_UNIT_TESTS
+
+#include "LocalSyncServer.h"
+#include "HelioApiRoutes.h"
+#include "SerializationKeys.h"
+
+using namespace VCS;
+
+#define LOCAL_SYNC_SERVER_FIRST_PORT 17070
+#define LOCAL_SYNC_SERVER_NUM_PORTS 100
+#define LOCAL_SYNC_SERVER_MAX_HEADER_SIZE (64 * 1024)
+#define LOCAL_SYNC_SERVER_STOP_TIMEOUT_MS 2000
+
+LocalSyncServer::LocalSyncServer(const String &historyId) :
+    Thread("Local Sync Server"),
+    port(0),
+    historyId(historyId),
+    version(0) {}
+
+LocalSyncServer::~LocalSyncServer()
+{
+    this->signalThreadShouldExit();
+    this->listener.close();
+    this->stopThread(LOCAL_SYNC_SERVER_STOP_TIMEOUT_MS);
+}
+
+bool LocalSyncServer::start()
+{
+    for (int i = 0; i < LOCAL_SYNC_SERVER_NUM_PORTS; ++i)
+    {
+        if (this->listener.createListener(LOCAL_SYNC_SERVER_FIRST_PORT + i, "127.0.0.1"))
+        {
+            this->port = LOCAL_SYNC_SERVER_FIRST_PORT + i;
+            this->startThread();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+String LocalSyncServer::getSyncUrl() const
+{
+    return "http://127.0.0.1:" + String(this->port) +
+        HelioFM::Api::V1::vcs.replace(":project", this->historyId);
+}
+
+void LocalSyncServer::setTruncatesDownloads(bool shouldTruncate)
+{
+    this->truncatesDownloads = shouldTruncate ? 1 : 0;
+}
+
+StringArray LocalSyncServer::getRevisionIds() const
+{
+    const ScopedLock lock(this->dataLock);
+    return this->committedIds;
+}
+
+String LocalSyncServer::getHeadRevisionId() const
+{
+    const ScopedLock lock(this->dataLock);
+    return this->headRevisionId;
+}
+
+void LocalSyncServer::run()
+{
+    while (!this->threadShouldExit())
+    {
+        ScopedPointer<StreamingSocket> connection(this->listener.waitForNextConnection());
+        if (connection != nullptr && !this->threadShouldExit())
+        {
+            this->handleConnection(*connection);
+        }
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Routing
+//===----------------------------------------------------------------------===//
+
+void LocalSyncServer::handleConnection(StreamingSocket &connection)
+{
+    Request request;
+    if (!readRequest(connection, request))
+    {
+        sendResponse(connection, 400, {});
+        return;
+    }
+
+    const String &path = request.path;
+    const bool isPost = (request.method == "POST");
+
+    if (path.endsWith("/negotiate") && isPost)
+    {
+        this->handleNegotiate(connection, request);
+    }
+    else if (path.endsWith("/commit") && isPost)
+    {
+        this->handleCommit(connection, request);
+    }
+    else if (path.contains("/revisions/"))
+    {
+        const String resource = path.fromFirstOccurrenceOf("/revisions/", false, false);
+        const String revisionId = resource.upToFirstOccurrenceOf("/", false, false);
+
+        if (resource.endsWith("/upload"))
+        {
+            if (isPost)
+            {
+                this->handleUploadChunk(connection, revisionId, request);
+            }
+            else
+            {
+                this->handleUploadOffset(connection, revisionId);
+            }
+        }
+        else
+        {
+            this->handleDownload(connection, revisionId, request);
+        }
+    }
+    else
+    {
+        sendResponse(connection, 404, {});
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Endpoints
+//===----------------------------------------------------------------------===//
+
+static StringArray getIds(const var &array)
+{
+    StringArray ids;
+    if (const auto *items = array.getArray())
+    {
+        for (const auto &id : *items)
+        {
+            ids.add(id.toString());
+        }
+    }
+
+    return ids;
+}
+
+static var toJsonArray(const StringArray &ids)
+{
+    Array<var> items;
+    for (const auto &id : ids)
+    {
+        items.add(id);
+    }
+
+    return items;
+}
+
+void LocalSyncServer::handleNegotiate(StreamingSocket &connection, const Request &request)
+{
+    using namespace Serialization::Api::V1;
+
+    const var payload(JSON::parse(request.body.toString()));
+    const StringArray clientIds(getIds(payload.getProperty(revisions, {})));
+
+    const ScopedLock lock(this->dataLock);
+
+    // nothing was pushed yet, just like the real server does
+    if (this->committedIds.isEmpty())
+    {
+        sendJson(connection, 404, var(new DynamicObject()));
+        return;
+    }
+
+    StringArray missing;
+    for (const auto &id : clientIds)
+    {
+        if (!this->committedIds.contains(id))
+        {
+            missing.add(id);
+        }
+    }
+
+    StringArray available;
+    for (const auto &id : this->committedIds)
+    {
+        if (!clientIds.contains(id))
+        {
+            available.add(id);
+        }
+    }
+
+    DynamicObject::Ptr response(new DynamicObject());
+    response->setProperty(missingRevisions, toJsonArray(missing));
+    response->setProperty(availableRevisions, toJsonArray(available));
+    response->setProperty(headRevision, this->headRevisionId);
+    response->setProperty(Serialization::Api::V1::historyId, this->historyId);
+    response->setProperty(Serialization::Api::V1::version, this->version);
+    sendJson(connection, 200, var(response.get()));
+}
+
+void LocalSyncServer::handleUploadOffset(StreamingSocket &connection, const String &revisionId)
+{
+    const ScopedLock lock(this->dataLock);
+
+    DynamicObject::Ptr response(new DynamicObject());
+    response->setProperty(Serialization::Api::V1::offset,
+        int64(this->uploads[revisionId].getSize()));
+
+    sendJson(connection, 200, var(response.get()));
+}
+
+void LocalSyncServer::handleUploadChunk(StreamingSocket &connection,
+    const String &revisionId, const Request &request)
+{
+    // "Content-Range: bytes a-b/total"
+    const String range(request.headers.getValue("Content-Range", {}));
+    const int64 chunkStart = range.fromFirstOccurrenceOf("bytes ", false, false)
+        .upToFirstOccurrenceOf("-", false, false).getLargeIntValue();
+
+    const ScopedLock lock(this->dataLock);
+
+    MemoryBlock data(this->uploads[revisionId]);
+    if (chunkStart != int64(data.getSize()))
+    {
+        sendResponse(connection, 416, {});
+        return;
+    }
+
+    data.append(request.body.getData(), request.body.getSize());
+    this->uploads.set(revisionId, data);
+    sendJson(connection, 200, var(new DynamicObject()));
+}
+
+void LocalSyncServer::handleDownload(StreamingSocket &connection,
+    const String &revisionId, const Request &request)
+{
+    MemoryBlock data;
+
+    {
+        const ScopedLock lock(this->dataLock);
+        if (!this->committedIds.contains(revisionId))
+        {
+            sendResponse(connection, 404, {});
+            return;
+        }
+
+        data = this->uploads[revisionId];
+    }
+
+    const int64 totalSize = int64(data.getSize());
+
+    if (this->truncatesDownloads.get() != 0)
+    {
+        const MemoryBlock half(data.getData(), data.getSize() / 2);
+        sendResponse(connection, 200, half, {}, false);
+        return;
+    }
+
+    // "Range: bytes=a-"
+    const String range(request.headers.getValue("Range", {}));
+    const int64 rangeStart = range.fromFirstOccurrenceOf("bytes=", false, false)
+        .upToFirstOccurrenceOf("-", false, false).getLargeIntValue();
+
+    if (rangeStart > 0 && rangeStart < totalSize)
+    {
+        const MemoryBlock rest(static_cast<const char *>(data.getData()) + rangeStart,
+            size_t(totalSize - rangeStart));
+
+        const String contentRange = "Content-Range: bytes " + String(rangeStart) + "-" +
+            String(totalSize - 1) + "/" + String(totalSize);
+
+        sendResponse(connection, 206, rest, StringArray(contentRange));
+        return;
+    }
+
+    sendResponse(connection, 200, data);
+}
+
+void LocalSyncServer::handleCommit(StreamingSocket &connection, const Request &request)
+{
+    using namespace Serialization::Api::V1;
+
+    const var payload(JSON::parse(request.body.toString()));
+    const StringArray ids(getIds(payload.getProperty(revisions, {})));
+
+    const ScopedLock lock(this->dataLock);
+
+    for (const auto &id : ids)
+    {
+        if (!this->uploads.contains(id))
+        {
+            sendResponse(connection, 400, {});
+            return;
+        }
+    }
+
+    this->committedIds.addArray(ids);
+    this->committedIds.removeDuplicates(false);
+    this->headRevisionId = payload.getProperty(headRevision, {}).toString();
+    this->version = payload.getProperty(Serialization::Api::V1::version, 0);
+    sendJson(connection, 200, var(new DynamicObject()));
+}
+
+//===----------------------------------------------------------------------===//
+// HTTP
+//===----------------------------------------------------------------------===//
+
+bool LocalSyncServer::readRequest(StreamingSocket &connection, Request &request)
+{
+    MemoryOutputStream header;
+    while (!header.toString().endsWith("\r\n\r\n"))
+    {
+        char c = 0;
+        if (header.getDataSize() > LOCAL_SYNC_SERVER_MAX_HEADER_SIZE ||
+            connection.read(&c, 1, true) != 1)
+        {
+            return false;
+        }
+
+        header.writeByte(c);
+    }
+
+    StringArray lines;
+    lines.addLines(header.toString().trim());
+    if (lines.isEmpty())
+    {
+        return false;
+    }
+
+    StringArray requestLine;
+    requestLine.addTokens(lines[0], " ", {});
+    request.method = requestLine[0];
+    request.path = requestLine[1].upToFirstOccurrenceOf("?", false, false);
+
+    for (int i = 1; i < lines.size(); ++i)
+    {
+        request.headers.set(lines[i].upToFirstOccurrenceOf(":", false, false).trim(),
+            lines[i].fromFirstOccurrenceOf(":", false, false).trim());
+    }
+
+    const int contentLength = request.headers.getValue("Content-Length", "0").getIntValue();
+    if (contentLength > 0)
+    {
+        request.body.setSize(size_t(contentLength));
+        if (connection.read(request.body.getData(), contentLength, true) != contentLength)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static String getStatusText(int statusCode)
+{
+    switch (statusCode)
+    {
+    case 200: return "OK";
+    case 206: return "Partial Content";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 416: return "Range Not Satisfiable";
+    default: return "Error";
+    }
+}
+
+void LocalSyncServer::sendResponse(StreamingSocket &connection, int statusCode,
+    const MemoryBlock &body, const StringArray &headers, bool sendsLength)
+{
+    String response("HTTP/1.1 " + String(statusCode) + " " + getStatusText(statusCode) + "\r\n");
+
+    for (const auto &header : headers)
+    {
+        response << header << "\r\n";
+    }
+
+    if (sendsLength)
+    {
+        response << "Content-Length: " << String(body.getSize()) << "\r\n";
+    }
+
+    response << "Connection: close\r\n\r\n";
+
+    MemoryBlock data(response.toRawUTF8(), response.getNumBytesAsUTF8());
+    data.append(body.getData(), body.getSize());
+    connection.write(data.getData(), int(data.getSize()));
+}
+
+void LocalSyncServer::sendJson(StreamingSocket &connection, int statusCode, const var &json)
+{
+    const String text(JSON::toString(json));
+    sendResponse(connection, statusCode, MemoryBlock(text.toRawUTF8(), text.getNumBytesAsUTF8()),
+        StringArray(String("Content-Type: application/json")));
+}
+
+#endif // HELIO_UNIT_TESTS
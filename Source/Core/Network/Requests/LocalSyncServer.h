@@ -0,0 +1,86 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#if HELIO_UNIT_TESTS
+
+namespace VCS
+{
+    // A minimal in-process stand-in for the sync endpoints,
+    // so that push and pull can be tested end-to-end without the backend:
+    // it serves the negotiate, upload, download and commit requests on localhost
+
+    class LocalSyncServer final : public Thread
+    {
+    public:
+
+        explicit LocalSyncServer(const String &historyId);
+        ~LocalSyncServer() override;
+
+        bool start();
+        String getSyncUrl() const;
+
+        // Downloads are sent without a length and cut in half,
+        // to check that the client doesn't accept truncated payloads
+        void setTruncatesDownloads(bool shouldTruncate);
+
+        StringArray getRevisionIds() const;
+        String getHeadRevisionId() const;
+
+    private:
+
+        void run() override;
+        void handleConnection(StreamingSocket &connection);
+
+        struct Request final
+        {
+            String method;
+            String path;
+            StringPairArray headers;
+            MemoryBlock body;
+        };
+
+        static bool readRequest(StreamingSocket &connection, Request &request);
+        static void sendResponse(StreamingSocket &connection, int statusCode,
+            const MemoryBlock &body, const StringArray &headers = {}, bool sendsLength = true);
+        static void sendJson(StreamingSocket &connection, int statusCode, const var &json);
+
+        void handleNegotiate(StreamingSocket &connection, const Request &request);
+        void handleUploadOffset(StreamingSocket &connection, const String &revisionId);
+        void handleUploadChunk(StreamingSocket &connection, const String &revisionId, const Request &request);
+        void handleDownload(StreamingSocket &connection, const String &revisionId, const Request &request);
+        void handleCommit(StreamingSocket &connection, const Request &request);
+
+        StreamingSocket listener;
+        int port;
+
+        const String historyId;
+        Atomic<int> truncatesDownloads;
+
+        CriticalSection dataLock;
+        StringArray committedIds;
+        String headRevisionId;
+        int64 version;
+
+        HashMap<String, MemoryBlock> uploads;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LocalSyncServer)
+    };
+} // namespace VCS
+
+#endif // HELIO_UNIT_TESTS
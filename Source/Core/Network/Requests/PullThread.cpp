@@ -38,110 +38,97 @@ ValueTree PullThread::createMergedStateData()
 
 void PullThread::run()
 {
-    const String saltedId = this->localId + "salt";
-    const String saltedIdHash = SHA256(saltedId.toUTF8()).toHexString();
-
     //===------------------------------------------------------------------===//
-    // Fetch remote history
+    // Find out which revisions we are missing
     //===------------------------------------------------------------------===//
 
     this->setState(SyncThread::fetchHistory);
 
-    ValueTree remoteState;
-
-    URL fetchUrl(this->url);
+    this->mergedVCS = new VersionControl(nullptr);
+    this->mergedVCS->deserialize(this->localState);
 
+    Negotiation negotiation;
+    if (!this->negotiate(this->mergedVCS->getRevisionIds(), negotiation) ||
+        this->lastStatusCode == 404)
     {
-        int statusCode = 0;
-        StringPairArray responseHeaders;
-
-        ScopedPointer<InputStream> downloadStream(
-            fetchUrl.createInputStream(true,
-                syncProgressCallback,
-                static_cast<void *>(this),
-                "useragent",
-                0,
-                &responseHeaders,
-                &statusCode));
-
-        if (downloadStream == nullptr || statusCode != 200)
-        {
-            //Logger::writeToLog("downloadStream " + String(statusCode));
-            //Logger::writeToLog(downloadStream->readEntireStreamAsString());
-            this->setState(SyncThread::fetchHistoryError);
-            return;
-        }
-
-        MemoryBlock fetchData;
-        downloadStream->readIntoMemoryBlock(fetchData);
-        remoteState = {}; // FIXME DocumentHelpers::createDecryptedXml(fetchData, this->localKey);
-
-        if (!remoteState.isValid())
-        {
-            //const String obfustatedKey = DocumentReader::obfuscateString(this->localKey.toBase64Encoding());
-            //Logger::writeToLog("Possible, wrong key: " + obfustatedKey);
-            this->setState(SyncThread::fetchHistoryError);
-            return;
-        }
+        this->setErrorState(SyncThread::fetchHistoryError);
+        return;
     }
 
-    Time::waitForMillisecondCounter(Time::getMillisecondCounter() + 350);
+    Logger::writeToLog("Local version: " + String(this->mergedVCS->getVersion()));
+    Logger::writeToLog("Remote version: " + String(negotiation.remoteVersion));
+    Logger::writeToLog("Missing locally: " + String(negotiation.missingLocally.size()));
+
+    this->setState(SyncThread::merge);
 
+    if (negotiation.missingLocally.isEmpty())
+    {
+        this->setState(SyncThread::upToDate);
+        return;
+    }
 
     //===------------------------------------------------------------------===//
-    // Do some checks
+    // Download and import missing revisions
     //===------------------------------------------------------------------===//
 
-    this->setState(SyncThread::merge);
-
-    this->mergedVCS = new VersionControl(nullptr);
-    this->mergedVCS->deserialize(this->localState);
+    this->setState(SyncThread::sync);
 
-    VersionControl remoteVCS(nullptr);
+    // the server should send parents first, but don't rely on that:
+    // a bundle without its parent waits until the parent arrives
+    Array<ValueTree> deferredBundles;
 
-    if (remoteState.isValid())
+    const int numRevisions = negotiation.missingLocally.size();
+    for (int i = 0; i < numRevisions; ++i)
     {
-        remoteVCS.deserialize(remoteState);
-    }
+        if (this->threadShouldExit())
+        {
+            return;
+        }
 
-    Logger::writeToLog("Local version: " + String(this->mergedVCS->getVersion()));
-    Logger::writeToLog("Remote version: " + String(remoteVCS.getVersion()));
-    Logger::writeToLog("Local hash: " + this->mergedVCS->calculateHash().toHexString());
-    Logger::writeToLog("Remote hash: " + remoteVCS.calculateHash().toHexString());
+        MemoryBlock data;
+        const String &revisionId = negotiation.missingLocally[i];
+        if (!this->downloadRevision(revisionId, data))
+        {
+            this->setErrorState(SyncThread::syncError);
+            return;
+        }
 
-    // итак, пулл разрешен только если серверная версия больше.
-    // если версии равны и равны хэши - up to date
-    // остальное - ошибка.
+        const ValueTree bundle(decodeBundle(data));
+        if (!bundle.hasType(Serialization::VCS::revisionBundle))
+        {
+            this->setState(SyncThread::syncError);
+            return;
+        }
 
-    if (this->mergedVCS->getVersion() == remoteVCS.getVersion() &&
-            this->mergedVCS->calculateHash() == remoteVCS.calculateHash())
-    {
-        this->setState(SyncThread::upToDate);
-        return;
+        if (!this->mergedVCS->importRevisionBundle(bundle))
+        {
+            deferredBundles.add(bundle);
+        }
+
+        this->setProgress(i + 1, numRevisions);
     }
 
-    if (remoteVCS.getVersion() > this->mergedVCS->getVersion())
+    bool hasImportedAny = true;
+    while (!deferredBundles.isEmpty() && hasImportedAny)
     {
-        Logger::writeToLog("Remote history is ok.");
+        hasImportedAny = false;
+        for (int i = deferredBundles.size(); i --> 0 ;)
+        {
+            if (this->mergedVCS->importRevisionBundle(deferredBundles.getReference(i)))
+            {
+                deferredBundles.remove(i);
+                hasImportedAny = true;
+            }
+        }
     }
-    else
+
+    if (!deferredBundles.isEmpty())
     {
         this->setState(SyncThread::mergeError);
         return;
     }
 
-
-    //===------------------------------------------------------------------===//
-    // Merge two trees
-    //===------------------------------------------------------------------===//
-
-    this->mergedVCS->mergeWith(remoteVCS);
-
-    // debug
-    //ScopedPointer<XmlElement> localXmlForDebug(this->mergedVCS->serialize());
-    //File debugFile(File::getSpecialLocation(File::currentExecutableFile).getParentDirectory().getChildFile("debug.vcs"));
-    //debugFile.replaceWithText(localXmlForDebug->createDocument("", false, true, "UTF-8", 512));
-
-    Time::waitForMillisecondCounter(Time::getMillisecondCounter() + 350);
+    this->mergedVCS->moveToRemoteHead(negotiation.remoteHeadId,
+        negotiation.remoteHistoryId, negotiation.remoteVersion);
     this->setState(SyncThread::allDone);
 }
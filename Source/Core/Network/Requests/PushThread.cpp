@@ -37,72 +37,26 @@ PushThread::PushThread(URL pushUrl,
 
 void PushThread::run()
 {
-    const String saltedId = this->localId + "salt";
-    const String saltedIdHash = SHA256(saltedId.toUTF8()).toHexString();
-    const String keyHash = SHA256(this->localKey.toString().toUTF8()).toHexString();
-    
     //===------------------------------------------------------------------===//
-    // Fetch remote history
+    // Find out which revisions the server is missing
     //===------------------------------------------------------------------===//
 
     this->setState(SyncThread::fetchHistory);
 
-    ValueTree remoteState;
-
-    URL fetchUrl(this->url);
-
-    // TODO like this:
-
-    //const HttpConnection connection(fetchUrl,
-    //    [this](int bytesSent, int bytesTotal) { this->setProgress(bytesSent, bytesTotal); });
-
-    //const auto response = connection.requestJson();
-
-    //if (response.result.failed() || (response.statusCode != 200 && response.statusCode != 404))
-    //{
-    //    this->setState(SyncThread::fetchHistoryError);
-    //    return;
-    //}
+    VersionControl localVCS(nullptr);
+    localVCS.deserialize(this->localState);
 
+    Negotiation negotiation;
+    if (!this->negotiate(localVCS.getRevisionIds(), negotiation))
     {
-        int statusCode = 0;
-        StringPairArray responseHeaders;
-
-        ScopedPointer<InputStream> downloadStream(
-            fetchUrl.createInputStream(true,
-                syncProgressCallback,
-                static_cast<void *>(this),
-                "useragent",
-                0,
-                &responseHeaders,
-                &statusCode));
-
-        // statusCode can be 404 when pushing new project
-        if (downloadStream == nullptr ||
-            (statusCode != 200 && statusCode != 404))
-        {
-            this->setState(SyncThread::fetchHistoryError);
-            return;
-        }
-
-        MemoryBlock fetchData;
-        downloadStream->readIntoMemoryBlock(fetchData);
-        //Logger::writeToLog(fetchData.toString());
-
-        remoteState = {}; // FIAME DocumentReader::createDecryptedXml(fetchData, this->localKey);
-
-        const bool fileExists = (fetchData.getSize() != 0) && (statusCode != 404);
-        const bool fileCanBeDecrypted = remoteState.isValid();
-        if (fileExists && !fileCanBeDecrypted)
-        {
-            Logger::writeToLog("Wrong key!");
-            this->setState(SyncThread::fetchHistoryError);
-            return;
-        }
+        this->setErrorState(SyncThread::fetchHistoryError);
+        return;
     }
 
-    Time::waitForMillisecondCounter(Time::getMillisecondCounter() + 350);
-
+    Logger::writeToLog("Local version: " + String(localVCS.getVersion()));
+    Logger::writeToLog("Remote version: " + String(negotiation.remoteVersion));
+    Logger::writeToLog("Missing remotely: " + String(negotiation.missingRemotely.size()));
+    Logger::writeToLog("Missing locally: " + String(negotiation.missingLocally.size()));
 
     //===------------------------------------------------------------------===//
     // Do some checks
@@ -110,122 +64,54 @@ void PushThread::run()
 
     this->setState(SyncThread::merge);
 
-    VersionControl localVCS(nullptr);
-    localVCS.deserialize(this->localState);
+    const String localHeadId = Revision::getUuid(localVCS.getHead().getHeadingRevision());
 
-    VersionControl remoteVCS(nullptr);
-
-    if (remoteState.isValid())
-    {
-        remoteVCS.deserialize(remoteState);
-    }
-    else
-    {
-        remoteVCS.reset();
-    }
-
-    Logger::writeToLog("Local version: " + String(localVCS.getVersion()));
-    Logger::writeToLog("Remote version: " + String(remoteVCS.getVersion()));
-    Logger::writeToLog("Local hash: " + localVCS.calculateHash().toHexString());
-    Logger::writeToLog("Remote hash: " + remoteVCS.calculateHash().toHexString());
-
-    if (localVCS.getVersion() == remoteVCS.getVersion() &&
-        localVCS.calculateHash() == remoteVCS.calculateHash())
+    if (negotiation.missingRemotely.isEmpty() &&
+        negotiation.remoteHeadId == localHeadId)
     {
         this->setState(SyncThread::upToDate);
         return;
     }
 
-    if ((localVCS.getVersion() > remoteVCS.getVersion()) ||
-        (localVCS.getVersion() == remoteVCS.getVersion() && localVCS.calculateHash() != remoteVCS.calculateHash()))
-    {
-        Logger::writeToLog("Remote history is ok.");
-    }
-    else
+    // the remote history has something we don't, pull it first
+    if (!negotiation.missingLocally.isEmpty())
     {
         this->setState(SyncThread::mergeError);
         return;
     }
 
-
     //===------------------------------------------------------------------===//
-    // Merge two trees
-    //===------------------------------------------------------------------===//
-
-    remoteVCS.mergeWith(localVCS);
-    remoteVCS.incrementVersion();
-
-    TemporaryFile tempFile("vcs");
-
-    {
-        const ValueTree stateToPush(remoteVCS.serialize());
-        MemoryBlock encryptedRemoteXml; // FIXME (DocumentReader::encryptXml(stateToPush, this->localKey));
-        tempFile.getFile().replaceWithData(encryptedRemoteXml.getData(), encryptedRemoteXml.getSize());
-    }
-
-    // debug
-    //ScopedPointer<XmlElement> localXmlForDebug(localVCS.serialize());
-    //File debugFile(File::getSpecialLocation(File::currentExecutableFile).getParentDirectory().getChildFile("debug.vcs"));
-    //debugFile.replaceWithText(localXmlForDebug->createDocument("", false, true, "UTF-8", 512));
-
-
-    //===------------------------------------------------------------------===//
-    // Push merged tree to the server
+    // Upload missing revisions, parents first
     //===------------------------------------------------------------------===//
 
     this->setState(SyncThread::sync);
 
-    URL pushUrl(this->url);
-    pushUrl = pushUrl.withFileToUpload("file", tempFile.getFile(), "application/octet-stream");
-
-    const bool loggedIn = false; // (App::Helio()->getSessionService()->getAuthorizationState() == SessionService::LoggedIn);
-
-    if (loggedIn)
+    const int numRevisions = negotiation.missingRemotely.size();
+    for (int i = 0; i < numRevisions; ++i)
     {
-        const String deviceId(Config::getDeviceId());
-        const String obfustatedKey = this->localKey.toBase64Encoding();
-    }
-
-    {
-        int statusCode = 0;
-        StringPairArray responseHeaders;
-
-        ScopedPointer<InputStream> pushStream(
-            pushUrl.createInputStream(true,
-                syncProgressCallback,
-                static_cast<void *>(this),
-                "useragent",
-                0,
-                &responseHeaders,
-                &statusCode));
-
-        if (pushStream == nullptr)
+        if (this->threadShouldExit())
         {
-            this->setState(SyncThread::syncError);
             return;
         }
 
-        const String rawResult = pushStream->readEntireStreamAsString().trim();
-        const String result = rawResult;
+        const String &revisionId = negotiation.missingRemotely[i];
+        const MemoryBlock data(encodeBundle(localVCS.createRevisionBundle(revisionId)));
 
-        Logger::writeToLog("Upload, raw result: " + rawResult);
-        Logger::writeToLog("Upload, result: " + result);
-
-        if (statusCode == 401)
-        {
-            this->setState(SyncThread::unauthorizedError);
-            return;
-        }
-        if (statusCode == 403)
-        {
-            this->setState(SyncThread::forbiddenError);
-            return;
-        }
-        else if (statusCode != 200)
+        if (!this->uploadRevision(revisionId, data))
         {
-            this->setState(SyncThread::syncError);
+            this->setErrorState(SyncThread::syncError);
             return;
         }
+
+        this->setProgress(i + 1, numRevisions);
+    }
+
+    // Client increments the local version on success
+    if (!this->commitRevisions(negotiation.missingRemotely,
+        localHeadId, this->title, localVCS.getVersion() + 1))
+    {
+        this->setErrorState(SyncThread::syncError);
+        return;
     }
 
     this->setState(SyncThread::allDone);
@@ -18,9 +18,15 @@
 #include "Common.h"
 #include "SyncThread.h"
 #include "Client.h"
+#include "DocumentHelpers.h"
+#include "SerializationKeys.h"
 
 using namespace VCS;
 
+#define SYNC_CHUNK_SIZE (64 * 1024)
+#define SYNC_CONNECTION_TIMEOUT_MS 10000
+#define SYNC_NUM_ATTEMPTS 3
+
 bool VCS::syncProgressCallback(void *context, int bytesSent, int totalBytes)
 {
     SyncThread *syncThread = static_cast<SyncThread *>(context);
@@ -37,6 +43,7 @@ SyncThread::SyncThread(URL pushUrl,
     localId(std::move(projectId)),
     localKey(std::move(projectKey)),
     localState(pushContent),
+    lastStatusCode(0),
     bytesSent(0),
     totalBytes(0) {}
 
@@ -63,3 +70,271 @@ void SyncThread::setProgress(int sent, int total)
     this->totalBytes = total;
     this->sendChangeMessage();
 }
+
+//===----------------------------------------------------------------------===//
+// Delta sync
+//===----------------------------------------------------------------------===//
+
+static var postJson(const URL &url, const var &payload, int &statusCode)
+{
+    const auto jsonPayload = JSON::toString(payload);
+    const auto postUrl = url.withPOSTData(MemoryBlock(jsonPayload.toRawUTF8(), jsonPayload.getNumBytesAsUTF8()));
+
+    ScopedPointer<InputStream> stream;
+    for (int i = 0; stream == nullptr && i < SYNC_NUM_ATTEMPTS; ++i)
+    {
+        stream = postUrl.createInputStream(true, nullptr, nullptr,
+            "Content-Type: application/json", SYNC_CONNECTION_TIMEOUT_MS, nullptr, &statusCode);
+    }
+
+    return (stream != nullptr) ? JSON::parse(stream->readEntireStreamAsString()) : var();
+}
+
+bool SyncThread::negotiate(const StringArray &localRevisionIds, Negotiation &result)
+{
+    using namespace Serialization::Api::V1;
+
+    DynamicObject::Ptr payload(new DynamicObject());
+    Array<var> ids;
+    for (const auto &id : localRevisionIds)
+    {
+        ids.add(id);
+    }
+
+    payload->setProperty(revisions, ids);
+    const var response = postJson(this->url.getChildURL("negotiate"), var(payload.get()), this->lastStatusCode);
+
+    // new project, the server has nothing yet
+    if (this->lastStatusCode == 404)
+    {
+        result.missingRemotely = localRevisionIds;
+        return true;
+    }
+
+    if (this->lastStatusCode != 200 || !response.isObject())
+    {
+        return false;
+    }
+
+    if (const auto *missing = response.getProperty(missingRevisions, {}).getArray())
+    {
+        for (const auto &id : *missing)
+        {
+            result.missingRemotely.add(id.toString());
+        }
+    }
+
+    if (const auto *available = response.getProperty(availableRevisions, {}).getArray())
+    {
+        for (const auto &id : *available)
+        {
+            result.missingLocally.add(id.toString());
+        }
+    }
+
+    result.remoteHeadId = response.getProperty(headRevision, {}).toString();
+    result.remoteHistoryId = response.getProperty(historyId, {}).toString();
+    result.remoteVersion = response.getProperty(version, 0);
+    return true;
+}
+
+bool SyncThread::uploadRevision(const String &revisionId, const MemoryBlock &data)
+{
+    const URL revisionUrl(this->url.getChildURL("revisions/" + revisionId + "/upload"));
+    const int64 totalSize = int64(data.getSize());
+
+    for (int attempt = 0; attempt < SYNC_NUM_ATTEMPTS; ++attempt)
+    {
+        if (this->threadShouldExit())
+        {
+            return false;
+        }
+
+        // ask the server how much it already has, and continue from there
+        int64 offset = 0;
+        {
+            ScopedPointer<InputStream> stream(revisionUrl.createInputStream(false,
+                nullptr, nullptr, {}, SYNC_CONNECTION_TIMEOUT_MS, nullptr, &this->lastStatusCode));
+
+            if (stream != nullptr && this->lastStatusCode == 200)
+            {
+                const var response = JSON::parse(stream->readEntireStreamAsString());
+                offset = jlimit(int64(0), totalSize, int64(response.getProperty(Serialization::Api::V1::offset, 0)));
+            }
+            else if (this->lastStatusCode == 401 || this->lastStatusCode == 403)
+            {
+                return false;
+            }
+        }
+
+        bool chunkFailed = false;
+        while (offset < totalSize && !chunkFailed && !this->threadShouldExit())
+        {
+            const int64 chunkSize = jmin(int64(SYNC_CHUNK_SIZE), totalSize - offset);
+            const MemoryBlock chunk(static_cast<const char *>(data.getData()) + offset, size_t(chunkSize));
+            const String contentRange = "Content-Range: bytes " + String(offset) + "-" +
+                String(offset + chunkSize - 1) + "/" + String(totalSize);
+
+            ScopedPointer<InputStream> stream(revisionUrl.withPOSTData(chunk).createInputStream(true,
+                nullptr, nullptr, "Content-Type: application/octet-stream\r\n" + contentRange,
+                SYNC_CONNECTION_TIMEOUT_MS, nullptr, &this->lastStatusCode));
+
+            chunkFailed = (stream == nullptr || this->lastStatusCode < 200 || this->lastStatusCode >= 300);
+            if (!chunkFailed)
+            {
+                offset += chunkSize;
+            }
+        }
+
+        if (offset >= totalSize)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SyncThread::downloadRevision(const String &revisionId, MemoryBlock &data)
+{
+    // a partial download is kept in a temp file, so that it can be resumed
+    const File partialFile(DocumentHelpers::getTempSlot(this->localId + "-" + revisionId + ".part"));
+    const URL revisionUrl(this->url.getChildURL("revisions/" + revisionId));
+
+    for (int attempt = 0; attempt < SYNC_NUM_ATTEMPTS; ++attempt)
+    {
+        if (this->threadShouldExit())
+        {
+            return false;
+        }
+
+        const int64 offset = partialFile.existsAsFile() ? partialFile.getSize() : 0;
+        const String rangeHeader = "Range: bytes=" + String(offset) + "-";
+
+        StringPairArray responseHeaders;
+        ScopedPointer<InputStream> stream(revisionUrl.createInputStream(false,
+            nullptr, nullptr, rangeHeader, SYNC_CONNECTION_TIMEOUT_MS,
+            &responseHeaders, &this->lastStatusCode));
+
+        if (stream == nullptr)
+        {
+            continue;
+        }
+
+        if (this->lastStatusCode == 401 || this->lastStatusCode == 403 || this->lastStatusCode == 404)
+        {
+            return false;
+        }
+
+        // 200 means the server ignored the range, and sends everything from the start
+        const bool isPartial = (this->lastStatusCode == 206);
+        if (!isPartial && this->lastStatusCode != 200)
+        {
+            continue;
+        }
+
+        if (!isPartial)
+        {
+            partialFile.deleteFile();
+        }
+
+        {
+            FileOutputStream out(partialFile);
+            if (!out.openedOk())
+            {
+                return false;
+            }
+
+            HeapBlock<char> buffer(SYNC_CHUNK_SIZE);
+            while (!stream->isExhausted() && !this->threadShouldExit())
+            {
+                const int numRead = stream->read(buffer, SYNC_CHUNK_SIZE);
+                if (numRead <= 0)
+                {
+                    break;
+                }
+
+                out.write(buffer, size_t(numRead));
+            }
+        }
+
+        // the full size is known from "Content-Range: bytes a-b/total"
+        const int64 expectedSize = isPartial ?
+            responseHeaders.getValue("Content-Range", {}).fromLastOccurrenceOf("/", false, false).getLargeIntValue() :
+            stream->getTotalLength();
+
+        const int64 receivedSize = partialFile.getSize();
+
+        // without the full size a truncated payload can't be detected,
+        // and with more data than expected the partial file is broken
+        if (expectedSize <= 0 || receivedSize > expectedSize)
+        {
+            partialFile.deleteFile();
+            continue;
+        }
+
+        if (receivedSize == expectedSize)
+        {
+            partialFile.loadFileAsData(data);
+            partialFile.deleteFile();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SyncThread::commitRevisions(const StringArray &revisionIds,
+    const String &headRevisionId, const String &title, int64 newVersion)
+{
+    using namespace Serialization::Api::V1;
+
+    DynamicObject::Ptr payload(new DynamicObject());
+    Array<var> ids;
+    for (const auto &id : revisionIds)
+    {
+        ids.add(id);
+    }
+
+    payload->setProperty(revisions, ids);
+    payload->setProperty(headRevision, headRevisionId);
+    payload->setProperty(Serialization::Api::V1::title, title);
+    payload->setProperty(version, newVersion);
+
+    postJson(this->url.getChildURL("commit"), var(payload.get()), this->lastStatusCode);
+    return this->lastStatusCode >= 200 && this->lastStatusCode < 300;
+}
+
+MemoryBlock SyncThread::encodeBundle(const ValueTree &bundle)
+{
+    MemoryOutputStream memOut;
+    {
+        GZIPCompressorOutputStream zippedOut(&memOut, 1, false);
+        bundle.writeToStream(zippedOut);
+    }
+
+    return memOut.getMemoryBlock();
+}
+
+ValueTree SyncThread::decodeBundle(const MemoryBlock &data)
+{
+    MemoryInputStream memIn(data, false);
+    GZIPDecompressorInputStream zippedIn(memIn);
+    return ValueTree::readFromStream(zippedIn);
+}
+
+void SyncThread::setErrorState(SyncThread::State defaultError)
+{
+    switch (this->lastStatusCode)
+    {
+    case 401:
+        this->setState(SyncThread::unauthorizedError);
+        break;
+    case 403:
+        this->setState(SyncThread::forbiddenError);
+        break;
+    default:
+        this->setState(defaultError);
+        break;
+    }
+}
@@ -59,7 +59,33 @@ namespace VCS
 
     protected:
 
+        // The delta sync protocol: both sides exchange the ids of the revisions
+        // they have, and only the missing revisions are transferred afterwards,
+        // each one as a separate bundle, so that an interrupted sync can resume
+
+        struct Negotiation final
+        {
+            StringArray missingRemotely;
+            StringArray missingLocally;
+            String remoteHeadId;
+            String remoteHistoryId;
+            int64 remoteVersion = 0;
+        };
+
+        bool negotiate(const StringArray &localRevisionIds, Negotiation &result);
+        bool uploadRevision(const String &revisionId, const MemoryBlock &data);
+        bool downloadRevision(const String &revisionId, MemoryBlock &data);
+        bool commitRevisions(const StringArray &revisionIds,
+            const String &headRevisionId, const String &title, int64 newVersion);
+
+        static MemoryBlock encodeBundle(const ValueTree &bundle);
+        static ValueTree decodeBundle(const MemoryBlock &data);
+
+        // Sets the error state matching the last status code
+        void setErrorState(SyncThread::State defaultError);
+
         URL url;
+        int lastStatusCode;
 
         String localId;
         MemoryBlock localKey;
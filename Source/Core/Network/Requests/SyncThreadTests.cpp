@@ -0,0 +1,114 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+
+#if HELIO_UNIT_TESTS
+
+#include "LocalSyncServer.h"
+#include "PushThread.h"
+#include "PullThread.h"
+#include "VersionControl.h"
+
+using namespace VCS;
+
+#define SYNC_TESTS_TIMEOUT_MS 30000
+
+// Runs push and pull against the local server, which needs the message loop
+// to be running, as VersionControl locks the message manager
+
+class SyncThreadTests final : public UnitTest
+{
+public:
+
+    SyncThreadTests() : UnitTest("Sync threads", "VCS") {}
+
+    void runTest() override
+    {
+        VersionControl local(nullptr);
+        Pack::Ptr pack(new Pack());
+
+        ValueTree first(Revision::create(pack, "first"));
+        ValueTree second(Revision::create(pack, "second"));
+        local.getRoot().appendChild(first, nullptr);
+        first.appendChild(second, nullptr);
+        local.moveHead(second);
+
+        LocalSyncServer server(local.getPublicId());
+        const URL syncUrl(server.getSyncUrl());
+
+        beginTest("Local server");
+        expect(server.start(), "Failed to open a port for the local server");
+
+        beginTest("Push to an empty server");
+        {
+            PushThread push(syncUrl, local.getPublicId(), "Test", local.getKey(), local.serialize());
+            expectEquals(runSync(push), int(SyncThread::allDone));
+            expect(server.getRevisionIds() == local.getRevisionIds());
+            expectEquals(server.getHeadRevisionId(), Revision::getUuid(second));
+        }
+
+        beginTest("Push again");
+        {
+            PushThread push(syncUrl, local.getPublicId(), "Test", local.getKey(), local.serialize());
+            expectEquals(runSync(push), int(SyncThread::upToDate));
+        }
+
+        beginTest("Pull into a new history");
+        {
+            VersionControl remote(nullptr);
+            PullThread pull(syncUrl, remote.getPublicId(), remote.getKey(), remote.serialize());
+            expectEquals(runSync(pull), int(SyncThread::allDone));
+
+            VersionControl merged(nullptr);
+            merged.deserialize(pull.createMergedStateData());
+            expect(merged.getRevisionIds() == local.getRevisionIds());
+            expectEquals(Revision::getUuid(merged.getHead().getHeadingRevision()), Revision::getUuid(second));
+            expectEquals(merged.getPublicId(), local.getPublicId());
+            expectEquals(merged.getVersion(), local.getVersion() + 1);
+        }
+
+        beginTest("Reject truncated downloads");
+        {
+            server.setTruncatesDownloads(true);
+
+            VersionControl remote(nullptr);
+            PullThread pull(syncUrl, remote.getPublicId(), remote.getKey(), remote.serialize());
+            expectEquals(runSync(pull), int(SyncThread::syncError));
+
+            server.setTruncatesDownloads(false);
+        }
+    }
+
+private:
+
+    static int runSync(SyncThread &thread)
+    {
+        thread.startThread();
+        if (!thread.waitForThreadToExit(SYNC_TESTS_TIMEOUT_MS))
+        {
+            thread.stopThread(SYNC_TESTS_TIMEOUT_MS);
+        }
+
+        return int(thread.getState());
+    }
+
+};
+
+static SyncThreadTests syncThreadTests;
+
+#endif // HELIO_UNIT_TESTS
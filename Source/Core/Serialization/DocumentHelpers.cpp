@@ -135,18 +135,26 @@ File DocumentHelpers::getTempSlot(const String &fileName)
     return getFirstSlot(tempPath, tempPath, fileName);
 }
 
-static const OwnedArray<Serializer> &getSerializers()
+struct SerializersRegistry final
 {
-    static OwnedArray<Serializer> serializers;
-    if (serializers.isEmpty())
+    SerializersRegistry()
     {
-        serializers.add(new XmlSerializer());
-        serializers.add(new JsonSerializer());
-        serializers.add(new BinarySerializer());
-        serializers.add(new LegacySerializer());
+        this->serializers.add(new XmlSerializer());
+        this->serializers.add(new JsonSerializer());
+        this->serializers.add(new BinarySerializer());
+        this->serializers.add(new LegacySerializer());
     }
 
-    return serializers;
+    OwnedArray<Serializer> serializers;
+};
+
+// Documents are loaded from the startup tasks' threads as well, so the
+// registry is built once by a static initializer, which is thread-safe,
+// and is never seen half-filled
+static const OwnedArray<Serializer> &getSerializers()
+{
+    static const SerializersRegistry registry;
+    return registry.serializers;
 }
 
 static const Array<Serializer *> getSerializersForExtension(const String &extension)
@@ -18,194 +18,396 @@
 #include "Common.h"
 #include "JsonSerializer.h"
 
-// Slightly modified JSONParser from JUCE classes,
-// but returns ValueTree instead of var, and supports comments like `//` and `/* */`.
-// Parses arrays and objects as nodes/children, and all others as properties.
+//===----------------------------------------------------------------------===//
+// Writer
+//===----------------------------------------------------------------------===//
 
-struct JsonParser
+// Writes nodes as objects, and properties as their members,
+// in the same layout that the parser below expects.
+// Each run of sibling nodes with the same type becomes an array,
+// and leaf nodes are written in one line, so that files stay diffable.
+
+class JsonWriter final
 {
-    static Result parseObjectOrArray(String::CharPointerType t, ValueTree &result)
+public:
+
+    explicit JsonWriter(OutputStream &stream) : out(stream) {}
+
+    void writeRoot(const ValueTree &tree)
     {
-        skipCommentsAndWhitespaces(t);
+        this->out << "{";
+        this->writeNewLine(1);
+        this->writeString(tree.getType().toString());
+        this->out << ": ";
+        this->writeNode(tree, 1);
+        this->out << "\n}\n";
+    }
+
+private:
 
-        switch (t.getAndAdvance())
+    void writeNode(const ValueTree &tree, int depth)
+    {
+        const int numChildren = tree.getNumChildren();
+        if (numChildren == 0)
         {
-        case 0:      result = ValueTree(); return Result::ok();
-        case '{':    return parseObject(t, result);
-        case '[':    return parseArray(t, result, result.getType());
+            this->writeLeafNode(tree);
+            return;
+        }
+
+        this->out << "{";
+        bool isFirstMember = true;
+
+        for (int i = 0; i < tree.getNumProperties(); ++i)
+        {
+            const auto name = tree.getPropertyName(i);
+            const auto &value = tree.getProperty(name);
+            if (!isWritable(value)) { continue; }
+
+            this->out << (isFirstMember ? "" : ",");
+            this->writeNewLine(depth + 1);
+            this->writeString(name.toString());
+            this->out << ": ";
+            this->writeValue(value);
+            isFirstMember = false;
         }
 
-        return createFail("Expected '{' or '['", &t);
+        for (int runStart = 0; runStart < numChildren;)
+        {
+            const auto type = tree.getChild(runStart).getType();
+
+            int runEnd = runStart + 1;
+            while (runEnd < numChildren && tree.getChild(runEnd).getType() == type)
+            {
+                ++runEnd;
+            }
+
+            this->out << (isFirstMember ? "" : ",");
+            this->writeNewLine(depth + 1);
+            this->writeString(type.toString());
+            this->out << ": ";
+            isFirstMember = false;
+
+            if (runEnd - runStart == 1)
+            {
+                this->writeNode(tree.getChild(runStart), depth + 1);
+            }
+            else
+            {
+                this->out << "[";
+                for (int i = runStart; i < runEnd; ++i)
+                {
+                    this->out << (i == runStart ? "" : ",");
+                    this->writeNewLine(depth + 2);
+                    this->writeNode(tree.getChild(i), depth + 2);
+                }
+
+                this->writeNewLine(depth + 1);
+                this->out << "]";
+            }
+
+            runStart = runEnd;
+        }
+
+        this->writeNewLine(depth);
+        this->out << "}";
     }
 
-    static Result parseStringProperty(const juce_wchar quoteChar, String::CharPointerType &t, const Identifier &propertyName, ValueTree &tree)
+    void writeLeafNode(const ValueTree &tree)
     {
-        String property;
-        const auto r = parseString(quoteChar, t, property);
-        if (r.wasOk())
+        this->out << "{";
+        bool isFirstMember = true;
+
+        for (int i = 0; i < tree.getNumProperties(); ++i)
         {
-            tree.setProperty(propertyName, property, nullptr);
+            const auto name = tree.getPropertyName(i);
+            const auto &value = tree.getProperty(name);
+            if (!isWritable(value)) { continue; }
+
+            this->out << (isFirstMember ? " " : ", ");
+            this->writeString(name.toString());
+            this->out << ": ";
+            this->writeValue(value);
+            isFirstMember = false;
         }
 
-        return r;
+        this->out << (isFirstMember ? "}" : " }");
     }
 
-    static Result parseString(const juce_wchar quoteChar, String::CharPointerType &t, String &result)
+    static bool isWritable(const var &value) noexcept
     {
-        MemoryOutputStream buffer(256);
+        // ValueTrees are sometimes used to keep object pointers at runtime;
+        // binary data would only be read back as a base64 string
+        jassert(!value.isBinaryData());
+        return !value.isObject() && !value.isMethod() && !value.isBinaryData();
+    }
 
-        for (;;)
+    void writeValue(const var &value)
+    {
+        if (value.isString())
+        {
+            this->writeString(value.toString());
+        }
+        else if (value.isBool())
+        {
+            this->out << (bool(value) ? "true" : "false");
+        }
+        else if (value.isInt() || value.isInt64())
+        {
+            this->out << String(int64(value));
+        }
+        else if (value.isDouble())
         {
-            auto c = t.getAndAdvance();
+            this->writeDouble(double(value));
+        }
+        else if (const auto *array = value.getArray())
+        {
+            this->out << "[";
+            for (int i = 0; i < array->size(); ++i)
+            {
+                this->out << (i == 0 ? "" : ", ");
+                this->writeValue(array->getReference(i));
+            }
 
-            if (c == quoteChar)
-                break;
+            this->out << "]";
+        }
+        else
+        {
+            this->out << "null";
+        }
+    }
 
-            if (c == '\\')
-            {
-                c = t.getAndAdvance();
+    // The shortest representation that reads back into the same double
+    void writeDouble(double value)
+    {
+        if (!std::isfinite(value))
+        {
+            this->out << "null";
+            return;
+        }
 
-                switch (c)
-                {
-                case '"':
-                case '\'':
-                case '\\':
-                case '/':  break;
-
-                case 'a':  c = '\a'; break;
-                case 'b':  c = '\b'; break;
-                case 'f':  c = '\f'; break;
-                case 'n':  c = '\n'; break;
-                case 'r':  c = '\r'; break;
-                case 't':  c = '\t'; break;
-
-                case 'u':
-                {
-                    c = 0;
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.15g", value);
+        if (CharacterFunctions::readDoubleValue(CharPointer_ASCII(buffer)) != value)
+        {
+            snprintf(buffer, sizeof(buffer), "%.17g", value);
+        }
 
-                    for (int i = 4; --i >= 0;)
-                    {
-                        auto digitValue = CharacterFunctions::getHexDigitValue(t.getAndAdvance());
-                        if (digitValue < 0) { return createFail("Syntax error in Unicode escape sequence"); }
-                        c = (juce_wchar)((c << 4) + static_cast<juce_wchar> (digitValue));
-                    }
+        // make sure it is read back as a double, not as an integer
+        const bool needsFraction = (strpbrk(buffer, ".eE") == nullptr);
+        this->out << buffer << (needsFraction ? ".0" : "");
+    }
 
-                    break;
-                }
-                }
+    void writeString(const String &string)
+    {
+        const auto *start = string.toRawUTF8();
+        const auto *t = start;
+
+        this->out << '"';
+
+        for (;; ++t)
+        {
+            const auto c = static_cast<uint8>(*t);
+            if (c == 0) { break; }
+            if (c >= 0x20 && c != '"' && c != '\\') { continue; }
+
+            // flush the unescaped part as is
+            this->out.write(start, size_t(t - start));
+            start = t + 1;
+
+            switch (c)
+            {
+            case '"':   this->out << "\\\""; break;
+            case '\\':  this->out << "\\\\"; break;
+            case '\n':  this->out << "\\n"; break;
+            case '\r':  this->out << "\\r"; break;
+            case '\t':  this->out << "\\t"; break;
+            default:    this->out << "\\u00" << String::toHexString(int(c)).paddedLeft('0', 2); break;
             }
+        }
+
+        this->out.write(start, size_t(t - start));
+        this->out << '"';
+    }
+
+    void writeNewLine(int depth)
+    {
+        this->out << '\n';
+        this->out.writeRepeatedByte(' ', size_t(depth * 2));
+    }
+
+    OutputStream &out;
+
+    JUCE_DECLARE_NON_COPYABLE(JsonWriter)
+};
 
-            if (c == 0) { return createFail("Unexpected end-of-input in string constant"); }
-            buffer.appendUTF8Char(c);
+//===----------------------------------------------------------------------===//
+// Parser
+//===----------------------------------------------------------------------===//
+
+// Initially based on JSONParser from JUCE classes, but returns ValueTree
+// instead of var, and supports comments like `//` and `/* */`.
+// Parses objects and arrays of objects as nodes/children, and all others
+// as properties; any other arrays, including the empty ones, are parsed
+// into a single array property, the way the writer above writes them.
+//
+// Works on a raw UTF-8 buffer, which doesn't need to be null-terminated,
+// so that a file can be parsed right from its memory-mapped contents.
+// Strings without escapes are created directly from the buffer,
+// and property names are looked up in a small cache of identifiers.
+
+class JsonParser final
+{
+public:
+
+    JsonParser(const char *data, size_t size) noexcept :
+        start(data), t(data), end(data + size)
+    {
+        // skip the UTF-8 byte order mark, if any
+        if (size >= 3 && memcmp(data, "\xef\xbb\xbf", 3) == 0)
+        {
+            this->t += 3;
         }
+    }
 
-        result = buffer.toUTF8();
-        return Result::ok();
+    Result parseObjectOrArray(ValueTree &result)
+    {
+        this->skipCommentsAndWhitespaces();
+
+        switch (this->getAndAdvance())
+        {
+        case 0:      result = ValueTree(); return Result::ok();
+        case '{':    return this->parseObject(result);
+        case '[':    return this->parseArray(result, result.getType());
+        }
+
+        return this->createFail("Expected '{' or '['", this->t - 1);
+    }
+
+private:
+
+    inline char peek() const noexcept
+    {
+        return (this->t < this->end) ? *this->t : 0;
+    }
+
+    inline char getAndAdvance() noexcept
+    {
+        return (this->t < this->end) ? *this->t++ : 0;
     }
 
-    static void findNextNewline(String::CharPointerType &t)
+    static inline bool isWhitespace(char c) noexcept
     {
-        juce_wchar c = 0;
-        do { c = t.getAndAdvance(); } while (c != '\n' && c != '\r');
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
     }
 
-    static void findEndOfMultilineComment(String::CharPointerType &t)
+    static inline bool isDigit(char c) noexcept
     {
-        juce_wchar c1 = 0;
-        juce_wchar c2 = 0;
-        do
-        { 
-            c1 = c2;
-            c2 = t.getAndAdvance();
-            if (c2 == 0) { return; }
-        } while (c1 != '*' || c2 != '/');
+        return c >= '0' && c <= '9';
     }
 
-    static void skipCommentsAndWhitespaces(String::CharPointerType &t)
+    void skipCommentsAndWhitespaces() noexcept
     {
-        t = t.findEndOfWhitespace();
-        auto t2 = t;
-        switch (t2.getAndAdvance())
+        for (;;)
         {
-        case '/':
-            const auto c = t2.getAndAdvance();
-            if (c == '/')
+            while (this->t < this->end && isWhitespace(*this->t))
             {
-                t = t2;
-                findNextNewline(t);
-                skipCommentsAndWhitespaces(t);
+                ++this->t;
             }
-            else if (c == '*')
+
+            if (this->t + 1 >= this->end || this->t[0] != '/')
+            {
+                return;
+            }
+
+            if (this->t[1] == '/')
             {
-                t = t2;
-                findEndOfMultilineComment(t);
-                skipCommentsAndWhitespaces(t);
+                this->t += 2;
+                while (this->t < this->end && *this->t != '\n' && *this->t != '\r')
+                {
+                    ++this->t;
+                }
+            }
+            else if (this->t[1] == '*')
+            {
+                this->t += 2;
+                while (this->t + 1 < this->end && (this->t[0] != '*' || this->t[1] != '/'))
+                {
+                    ++this->t;
+                }
+
+                this->t = jmin(this->t + 2, this->end);
+            }
+            else
+            {
+                return;
             }
         }
     }
 
-    static Result parseAny(String::CharPointerType &t, ValueTree &result, const Identifier &nodeOrProperty)
+    Result parseAny(ValueTree &result, const Identifier &nodeOrProperty)
     {
-        skipCommentsAndWhitespaces(t);
-        auto t2 = t;
+        this->skipCommentsAndWhitespaces();
+        const auto *oldT = this->t;
 
-        switch (t2.getAndAdvance())
+        switch (this->getAndAdvance())
         {
         case '{':
             {
-                t = t2;
                 ValueTree child(nodeOrProperty);
                 result.appendChild(child, nullptr);
-                return parseObject(t, child);
+                return this->parseObject(child);
             }
 
         case '[':
-            t = t2;
-            return parseArray(t, result, nodeOrProperty);
+            return this->parseArray(result, nodeOrProperty);
 
         case '"':
-            t = t2;
-            return parseStringProperty('"', t, nodeOrProperty, result);
-
         case '\'':
-            t = t2;
-            return parseStringProperty('\'', t, nodeOrProperty, result);
-
-        case '-':
-            skipCommentsAndWhitespaces(t2);
-            if (!CharacterFunctions::isDigit(*t2))
-                break;
+            {
+                String property;
+                const auto r = this->parseString(*oldT, property);
+                if (r.wasOk())
+                {
+                    result.setProperty(nodeOrProperty, property, nullptr);
+                }
 
-            t = t2;
-            return parseNumberProperty(t, nodeOrProperty, result, true);
+                return r;
+            }
 
+        case '-':
         case '0': case '1': case '2': case '3': case '4':
         case '5': case '6': case '7': case '8': case '9':
-            return parseNumberProperty(t, nodeOrProperty, result, false);
+            {
+                this->t = oldT;
+                var number;
+                const auto r = this->parseNumber(number);
+                if (r.wasOk())
+                {
+                    result.setProperty(nodeOrProperty, number, nullptr);
+                }
 
-        case 't':   // "true"
-            if (t2.getAndAdvance() == 'r' && t2.getAndAdvance() == 'u' && t2.getAndAdvance() == 'e')
+                return r;
+            }
+
+        case 't':
+            if (this->skipKeyword("rue"))
             {
-                t = t2;
                 result.setProperty(nodeOrProperty, true, nullptr);
                 return Result::ok();
             }
             break;
 
-        case 'f':   // "false"
-            if (t2.getAndAdvance() == 'a' && t2.getAndAdvance() == 'l'
-                && t2.getAndAdvance() == 's' && t2.getAndAdvance() == 'e')
+        case 'f':
+            if (this->skipKeyword("alse"))
             {
-                t = t2;
                 result.setProperty(nodeOrProperty, false, nullptr);
                 return Result::ok();
             }
             break;
 
-        case 'n':   // "null"
-            if (t2.getAndAdvance() == 'u' && t2.getAndAdvance() == 'l' && t2.getAndAdvance() == 'l')
+        case 'n':
+            if (this->skipKeyword("ull"))
             {
-                t = t2;
                 // no need to set any property in this case?
                 return Result::ok();
             }
@@ -215,176 +417,489 @@ struct JsonParser
             break;
         }
 
-        return createFail("Syntax error", &t);
+        return this->createFail("Syntax error", oldT);
     }
 
-private:
-    static Result createFail(const char *const message, const String::CharPointerType *location = nullptr)
+    bool skipKeyword(const char *rest) noexcept
     {
-        String m(message);
-        if (location != nullptr)
-            m << ": \"" << String(*location, 20) << '"';
+        const auto length = strlen(rest);
+        if (size_t(this->end - this->t) >= length && memcmp(this->t, rest, length) == 0)
+        {
+            this->t += length;
+            return true;
+        }
 
-        return Result::fail(m);
+        return false;
     }
 
-    static Result parseNumberProperty(String::CharPointerType &t, const Identifier &propertyName, ValueTree &result, const bool isNegative)
+    Result parseNumber(var &result)
     {
-        auto oldT = t;
+        const auto *oldT = this->t;
 
-        int64 intValue = t.getAndAdvance() - '0';
-        jassert(intValue >= 0 && intValue < 10);
+        const bool isNegative = (this->peek() == '-');
+        if (isNegative)
+        {
+            ++this->t;
+        }
 
-        for (;;)
+        if (!isDigit(this->peek()))
+        {
+            return this->createFail("Syntax error in number", oldT);
+        }
+
+        int64 intValue = 0;
+        while (this->t < this->end && isDigit(*this->t))
         {
-            auto previousChar = t;
-            auto c = t.getAndAdvance();
-            auto digit = ((int)c) - '0';
+            intValue = intValue * 10 + (*this->t++ - '0');
+        }
 
-            if (isPositiveAndBelow(digit, 10))
+        const char c = this->peek();
+        if (c == '.' || c == 'e' || c == 'E')
+        {
+            // copy it out, since the buffer is not null-terminated
+            char buffer[64];
+            const auto *numberStart = isNegative ? oldT + 1 : oldT;
+            size_t length = 0;
+
+            this->t = numberStart;
+            while (this->t < this->end && length < sizeof(buffer) - 1 &&
+                (isDigit(*this->t) || *this->t == '.' || *this->t == 'e' ||
+                 *this->t == 'E' || *this->t == '+' || *this->t == '-'))
             {
-                intValue = intValue * 10 + digit;
-                continue;
+                buffer[length++] = *this->t++;
             }
 
-            if (c == 'e' || c == 'E' || c == '.')
+            buffer[length] = 0;
+            const double asDouble = CharacterFunctions::readDoubleValue(CharPointer_ASCII(buffer));
+            result = isNegative ? -asDouble : asDouble;
+        }
+        else
+        {
+            const auto correctedValue = isNegative ? -intValue : intValue;
+            if ((intValue >> 31) != 0)
             {
-                t = oldT;
-                auto asDouble = CharacterFunctions::readDoubleValue(t);
-                result.setProperty(propertyName, isNegative ? -asDouble : asDouble, nullptr);
-                return Result::ok();
+                result = correctedValue;
+            }
+            else
+            {
+                result = int(correctedValue);
+            }
+        }
+
+        const char next = this->peek();
+        if (!isWhitespace(next) && next != ',' && next != '}' &&
+            next != ']' && next != '/' && next != 0)
+        {
+            return this->createFail("Syntax error in number", oldT);
+        }
+
+        return Result::ok();
+    }
+
+    Result parseString(const char quoteChar, String &result)
+    {
+        // the fast path: no escape sequences, so just take the bytes as they are
+        const auto *stringStart = this->t;
+        while (this->t < this->end && *this->t != quoteChar && *this->t != '\\')
+        {
+            ++this->t;
+        }
+
+        if (this->t >= this->end)
+        {
+            return this->createFail("Unexpected end-of-input in string constant");
+        }
+
+        if (*this->t == quoteChar)
+        {
+            result = String(CharPointer_UTF8(stringStart), CharPointer_UTF8(this->t));
+            ++this->t;
+            return Result::ok();
+        }
+
+        MemoryOutputStream buffer(256);
+        buffer.write(stringStart, size_t(this->t - stringStart));
+
+        for (;;)
+        {
+            auto c = this->getAndAdvance();
+
+            if (c == quoteChar) { break; }
+            if (c == 0) { return this->createFail("Unexpected end-of-input in string constant"); }
+
+            if (c != '\\')
+            {
+                buffer.writeByte(c);
+                continue;
             }
 
-            if (CharacterFunctions::isWhitespace(c)
-                || c == ',' || c == '}' || c == ']' || c == 0)
+            c = this->getAndAdvance();
+
+            switch (c)
             {
-                t = previousChar;
+            case '"':
+            case '\'':
+            case '\\':
+            case '/':  buffer.writeByte(c); break;
+
+            case 'a':  buffer.writeByte('\a'); break;
+            case 'b':  buffer.writeByte('\b'); break;
+            case 'f':  buffer.writeByte('\f'); break;
+            case 'n':  buffer.writeByte('\n'); break;
+            case 'r':  buffer.writeByte('\r'); break;
+            case 't':  buffer.writeByte('\t'); break;
+
+            case 'u':
+            {
+                juce_wchar unicodeChar = 0;
+                if (!this->parseHexDigits(unicodeChar))
+                {
+                    return this->createFail("Syntax error in unicode escape sequence");
+                }
+
+                // a surrogate pair, written as two escape sequences
+                if (unicodeChar >= 0xd800 && unicodeChar < 0xdc00 && this->skipKeyword("\\u"))
+                {
+                    juce_wchar lowSurrogate = 0;
+                    if (!this->parseHexDigits(lowSurrogate))
+                    {
+                        return this->createFail("Syntax error in unicode escape sequence");
+                    }
+
+                    unicodeChar = 0x10000 + ((unicodeChar - 0xd800) << 10) + (lowSurrogate - 0xdc00);
+                }
+
+                buffer.appendUTF8Char(unicodeChar);
                 break;
             }
 
-            return createFail("Syntax error in number", &oldT);
+            default:
+                return this->createFail("Unexpected end-of-input in string constant");
+            }
         }
 
-        auto correctedValue = isNegative ? -intValue : intValue;
+        result = String::fromUTF8(static_cast<const char *>(buffer.getData()), int(buffer.getDataSize()));
+        return Result::ok();
+    }
 
-        if ((intValue >> 31) != 0)
-            result.setProperty(propertyName, correctedValue, nullptr);
-        else
-            result.setProperty(propertyName, (int)correctedValue, nullptr);
+    bool parseHexDigits(juce_wchar &result) noexcept
+    {
+        for (int i = 4; --i >= 0;)
+        {
+            const auto digitValue = CharacterFunctions::getHexDigitValue(juce_wchar(this->getAndAdvance()));
+            if (digitValue < 0) { return false; }
+            result = (juce_wchar)((result << 4) + static_cast<juce_wchar>(digitValue));
+        }
+
+        return true;
+    }
 
+    // Property and node names are repeated all over the file,
+    // so the identifiers are cached by their raw bytes
+    Result parseName(Identifier &result)
+    {
+        const auto *nameStart = this->t;
+        while (this->t < this->end && *this->t != '"' && *this->t != '\\')
+        {
+            ++this->t;
+        }
+
+        if (this->t < this->end && *this->t == '"')
+        {
+            const auto length = int(this->t - nameStart);
+            ++this->t;
+
+            if (length == 0)
+            {
+                return this->createFail("Empty member name", nameStart);
+            }
+
+            uint32 hash = 2166136261u;
+            for (int i = 0; i < length; ++i)
+            {
+                hash = (hash ^ uint8(nameStart[i])) * 16777619u;
+            }
+
+            auto &slot = this->names[hash % numCachedNames];
+            if (slot.length != length || slot.hash != hash ||
+                memcmp(slot.name.getCharPointer().getAddress(), nameStart, size_t(length)) != 0)
+            {
+                slot.name = Identifier(String(CharPointer_UTF8(nameStart), CharPointer_UTF8(this->t - 1)));
+                slot.hash = hash;
+                slot.length = length;
+            }
+
+            result = slot.name;
+            return Result::ok();
+        }
+
+        // has escape sequences, which is not likely in names
+        this->t = nameStart;
+        String name;
+        const auto r = this->parseString('"', name);
+        if (r.failed()) { return r; }
+        if (name.isEmpty()) { return this->createFail("Empty member name", nameStart); }
+        result = Identifier(name);
         return Result::ok();
     }
 
-    static Result parseObject(String::CharPointerType &t, ValueTree &result)
+    Result parseObject(ValueTree &result)
     {
         for (;;)
         {
-            skipCommentsAndWhitespaces(t);
+            this->skipCommentsAndWhitespaces();
 
-            auto oldT = t;
-            auto c = t.getAndAdvance();
+            auto *oldT = this->t;
+            const auto c = this->getAndAdvance();
 
             if (c == '}') { break; }
-            if (c == 0) { return createFail("Unexpected end-of-input in object declaration"); }
+            if (c == 0) { return this->createFail("Unexpected end-of-input in object declaration"); }
             if (c == '"')
             {
-                String nodeNameVar;
-                const auto r = parseString('"', t, nodeNameVar);
+                Identifier nodeName;
+                const auto r = this->parseName(nodeName);
                 if (r.failed()) { return r; }
 
-                const Identifier nodeName(nodeNameVar);
-                if (nodeName.isValid())
-                {
-                    skipCommentsAndWhitespaces(t);
-                    oldT = t;
+                this->skipCommentsAndWhitespaces();
+                oldT = this->t;
 
-                    auto c2 = t.getAndAdvance();
-
-                    if (c2 != ':') { return createFail("Expected ':', but found", &oldT); }
+                if (this->getAndAdvance() != ':')
+                {
+                    return this->createFail("Expected ':', but found", oldT);
+                }
 
-                    const auto r2 = parseAny(t, result, nodeName);
-                    if (r2.failed()) { return r2; }
+                const auto r2 = this->parseAny(result, nodeName);
+                if (r2.failed()) { return r2; }
 
-                    skipCommentsAndWhitespaces(t);
-                    oldT = t;
+                this->skipCommentsAndWhitespaces();
+                oldT = this->t;
 
-                    auto nextChar = t.getAndAdvance();
-                    if (nextChar == ',') { continue; }
-                    if (nextChar == '}') { break; }
-                }
+                const auto nextChar = this->getAndAdvance();
+                if (nextChar == ',') { continue; }
+                if (nextChar == '}') { break; }
             }
 
-            return createFail("Expected object member declaration, but found", &oldT);
+            return this->createFail("Expected object member declaration, but found", oldT);
         }
 
         return Result::ok();
     }
 
-    static Result parseArray(String::CharPointerType &t, ValueTree &result, const Identifier &nodeName)
+    Result parseArray(ValueTree &result, const Identifier &nodeName)
     {
+        this->skipCommentsAndWhitespaces();
+
+        if (this->peek() != '{')
+        {
+            var values;
+            const auto r = this->parseValueArray(values);
+            if (r.wasOk())
+            {
+                result.setProperty(nodeName, values, nullptr);
+            }
+
+            return r;
+        }
+
         for (;;)
         {
-            skipCommentsAndWhitespaces(t);
+            this->skipCommentsAndWhitespaces();
 
-            auto oldT = t;
-            auto c = t.getAndAdvance();
+            auto *oldT = this->t;
+            const auto c = this->peek();
 
-            if (c == ']') { break; }
-            if (c == 0) { return createFail("Unexpected end-of-input in array declaration"); }
+            if (c == ']') { ++this->t; break; }
+            if (c == 0) { return this->createFail("Unexpected end-of-input in array declaration"); }
 
-            t = oldT;
-            auto r = parseAny(t, result, nodeName);
+            const auto r = this->parseAny(result, nodeName);
+            if (r.failed()) { return r; }
 
+            this->skipCommentsAndWhitespaces();
+            oldT = this->t;
+
+            const auto nextChar = this->getAndAdvance();
+            if (nextChar == ',') { continue; }
+            if (nextChar == ']') { break; }
+            return this->createFail("Expected object array item, but found", oldT);
+        }
+
+        return Result::ok();
+    }
+
+    // For event data and such, which goes into a single property
+    Result parseValueArray(var &result)
+    {
+        Array<var> values;
+
+        this->skipCommentsAndWhitespaces();
+        if (this->peek() == ']')
+        {
+            ++this->t;
+            result = values;
+            return Result::ok();
+        }
+
+        for (;;)
+        {
+            this->skipCommentsAndWhitespaces();
+
+            var value;
+            const auto r = this->parseValue(value);
             if (r.failed()) { return r; }
+            values.add(value);
 
-            skipCommentsAndWhitespaces(t);
-            oldT = t;
+            this->skipCommentsAndWhitespaces();
+            const auto *oldT = this->t;
 
-            auto nextChar = t.getAndAdvance();
+            const auto nextChar = this->getAndAdvance();
             if (nextChar == ',') { continue; }
             if (nextChar == ']') { break; }
-            return createFail("Expected object array item, but found", &oldT);
+            return this->createFail("Expected a value in array, but found", oldT);
         }
 
+        result = values;
         return Result::ok();
     }
-};
 
-Result JsonSerializer::saveToFile(File file, const ValueTree &tree) const
-{
-    return Result::fail("Not implemented");
-}
+    Result parseValue(var &result)
+    {
+        const auto *oldT = this->t;
 
-Result JsonSerializer::loadFromFile(const File &file, ValueTree &tree) const
+        switch (this->getAndAdvance())
+        {
+        case '[':
+            return this->parseValueArray(result);
+
+        case '"':
+        case '\'':
+            {
+                String value;
+                const auto r = this->parseString(*oldT, value);
+                result = value;
+                return r;
+            }
+
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            this->t = oldT;
+            return this->parseNumber(result);
+
+        case 't':
+            if (this->skipKeyword("rue")) { result = true; return Result::ok(); }
+            break;
+
+        case 'f':
+            if (this->skipKeyword("alse")) { result = false; return Result::ok(); }
+            break;
+
+        case 'n':
+            if (this->skipKeyword("ull")) { result = var(); return Result::ok(); }
+            break;
+
+        default:
+            break;
+        }
+
+        return this->createFail("Syntax error in array", oldT);
+    }
+
+    Result createFail(const char *const message, const char *location = nullptr) const
+    {
+        String m(message);
+        if (location != nullptr)
+        {
+            const auto length = jmin(int(this->end - location), 20);
+            m << ": \"" << String::fromUTF8(location, length) << '"';
+        }
+
+        // the line number is more helpful than anything else here
+        const auto *errorPosition = (location != nullptr) ? location : this->t;
+        const int line = 1 + int(std::count(this->start, jmin(errorPosition, this->end), '\n'));
+        m << " at line " << line;
+
+        return Result::fail(m);
+    }
+
+    const char *const start;
+    const char *t;
+    const char *const end;
+
+    struct CachedName final
+    {
+        Identifier name;
+        uint32 hash = 0;
+        int length = 0;
+    };
+
+    static constexpr int numCachedNames = 256;
+    CachedName names[numCachedNames];
+
+    JUCE_DECLARE_NON_COPYABLE(JsonParser)
+};
+
+static Result parseJson(const char *data, size_t size, ValueTree &tree)
 {
-    const String text(file.loadFileAsString());
     ValueTree root("FakeRoot");
-    const auto result = JsonParser::parseObjectOrArray(text.getCharPointer(), root);
+    JsonParser parser(data, size);
+    const auto result = parser.parseObjectOrArray(root);
     if (result.wasOk())
     {
         tree = root.getChild(0);
         return result;
     }
 
+    Logger::writeToLog("Failed to load JSON: " + result.getErrorMessage());
     return Result::fail("Failed to load JSON");
 }
 
-Result JsonSerializer::saveToString(String &string, const ValueTree &tree) const
+Result JsonSerializer::saveToFile(File file, const ValueTree &tree) const
 {
-    return Result::fail("Not implemented");
+    FileOutputStream fileStream(file, 64 * 1024);
+    if (fileStream.openedOk())
+    {
+        fileStream.setPosition(0);
+        fileStream.truncate();
+
+        JsonWriter writer(fileStream);
+        writer.writeRoot(tree);
+        fileStream.flush();
+
+        if (fileStream.getStatus().wasOk())
+        {
+            return Result::ok();
+        }
+    }
+
+    return Result::fail("Failed to save");
 }
 
-Result JsonSerializer::loadFromString(const String &string, ValueTree &tree) const
+Result JsonSerializer::loadFromFile(const File &file, ValueTree &tree) const
 {
-    ValueTree root("FakeRoot");
-    const auto result = JsonParser::parseObjectOrArray(string.getCharPointer(), root);
-    if (result.wasOk())
+    const MemoryMappedFile mappedFile(file, MemoryMappedFile::readOnly);
+    if (mappedFile.getData() != nullptr)
     {
-        tree = root.getChild(0);
-        return result;
+        return parseJson(static_cast<const char *>(mappedFile.getData()), mappedFile.getSize(), tree);
     }
 
-    return Result::fail("Failed to load JSON");
+    // mapping may fail, e.g. for empty files
+    MemoryBlock data;
+    file.loadFileAsData(data);
+    return parseJson(static_cast<const char *>(data.getData()), data.getSize(), tree);
+}
+
+Result JsonSerializer::saveToString(String &string, const ValueTree &tree) const
+{
+    MemoryOutputStream stream;
+    JsonWriter writer(stream);
+    writer.writeRoot(tree);
+    string = stream.toUTF8();
+    return Result::ok();
+}
+
+Result JsonSerializer::loadFromString(const String &string, ValueTree &tree) const
+{
+    return parseJson(string.toRawUTF8(), string.getNumBytesAsUTF8(), tree);
 }
 
 bool JsonSerializer::supportsFileWithExtension(const String &extension) const
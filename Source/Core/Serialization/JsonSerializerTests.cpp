@@ -0,0 +1,105 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+
+#if HELIO_UNIT_TESTS
+
+#include "JsonSerializer.h"
+
+// Everything the writer writes should be read back as it was
+
+class JsonSerializerTests final : public UnitTest
+{
+public:
+
+    JsonSerializerTests() : UnitTest("Json serializer", "Serialization") {}
+
+    void runTest() override
+    {
+        beginTest("Scalar properties");
+        {
+            ValueTree tree("root");
+            tree.setProperty("string", "a \"quoted\"\nline", nullptr);
+            tree.setProperty("int", 42, nullptr);
+            tree.setProperty("int64", int64(1) << 40, nullptr);
+            tree.setProperty("double", 0.1, nullptr);
+            tree.setProperty("wholeDouble", 2.0, nullptr);
+            tree.setProperty("bool", true, nullptr);
+            expectRoundTrip(tree);
+        }
+
+        beginTest("Array properties");
+        {
+            Array<var> numbers;
+            numbers.add(1, -2, 3.5);
+
+            Array<var> strings;
+            strings.add("first", "second", "third");
+
+            Array<var> nested;
+            nested.add(var(numbers), var(strings), var(Array<var>()));
+
+            ValueTree tree("root");
+            tree.setProperty("numbers", numbers, nullptr);
+            tree.setProperty("strings", strings, nullptr);
+            tree.setProperty("empty", Array<var>(), nullptr);
+            tree.setProperty("nested", nested, nullptr);
+            expectRoundTrip(tree);
+        }
+
+        beginTest("Nodes");
+        {
+            ValueTree tree("root");
+            tree.setProperty("name", "test", nullptr);
+
+            ValueTree single("single");
+            single.setProperty("key", 1, nullptr);
+            tree.appendChild(single, nullptr);
+
+            for (int i = 0; i < 3; ++i)
+            {
+                ValueTree item("item");
+                item.setProperty("index", i, nullptr);
+                item.appendChild(ValueTree("leaf"), nullptr);
+                tree.appendChild(item, nullptr);
+            }
+
+            tree.appendChild(ValueTree("empty"), nullptr);
+            expectRoundTrip(tree);
+        }
+    }
+
+private:
+
+    void expectRoundTrip(const ValueTree &tree)
+    {
+        JsonSerializer serializer;
+
+        String json;
+        expect(serializer.saveToString(json, tree).wasOk());
+
+        ValueTree loaded;
+        expect(serializer.loadFromString(json, loaded).wasOk());
+        expect(loaded.isEquivalentTo(tree), "Read back differently:\n" + json);
+    }
+
+};
+
+static JsonSerializerTests jsonSerializerTests;
+
+#endif // HELIO_UNIT_TESTS
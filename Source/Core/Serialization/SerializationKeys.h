@@ -163,6 +163,12 @@ namespace Serialization
         static const Identifier midiInputName = "name";
         static const Identifier defaultMidiOutput = "defaultMidiOutput";
 
+        static const Identifier midiRouting = "midiRouting";
+        static const Identifier midiRoutingRule = "rule";
+        static const Identifier midiRoutingDevice = "device";
+        static const Identifier midiRoutingChannel = "channel";
+        static const Identifier midiRoutingInstrumentId = "instrumentId";
+
         static const Identifier pluginsList = "plugins";
         static const Identifier audioCore = "audioCore";
         static const Identifier orchestra = "orchestra";
@@ -301,6 +307,9 @@ namespace Serialization
         static const Identifier commitVersion = "version";
         static const Identifier commitId = "id";
 
+        static const Identifier revisionBundle = "revisionBundle";
+        static const Identifier parentRevisionId = "parentId";
+
         static const Identifier vcsItemId = "vcsId";
 
         static const Identifier revisionItem = "revisionItem";
@@ -423,6 +432,14 @@ namespace Serialization
             static const Identifier resourceInfo = "resourceInfo";
             static const Identifier resourceName = "resourceName";
             static const Identifier hash = "hash";
+
+            static const Identifier revisions = "revisions";
+            static const Identifier missingRevisions = "missing";
+            static const Identifier availableRevisions = "available";
+            static const Identifier headRevision = "head";
+            static const Identifier historyId = "historyId";
+            static const Identifier title = "title";
+            static const Identifier offset = "offset";
         } // namespace V1
     } // namespace Api
     
@@ -36,13 +36,15 @@
 InstrumentTreeItem::InstrumentTreeItem(Instrument *targetInstrument) :
     TreeItem({}, Serialization::Core::instrumentRoot),
     instrument(targetInstrument),
-    instrumentEditor(nullptr)
+    instrumentEditor(nullptr),
+    hasOutdatedChildren(false)
 {
     this->audioCore = &App::Workspace().getAudioCore();
     
     if (this->instrument != nullptr)
     {
         this->name = this->instrument->getName();
+        this->instrument->addChangeListener(this);
         this->initInstrumentEditor();
     }
 }
@@ -51,6 +53,11 @@ InstrumentTreeItem::~InstrumentTreeItem()
 {
     if (! this->instrument.wasObjectDeleted())
     {
+        if (this->instrument != nullptr)
+        {
+            this->instrument->removeChangeListener(this);
+        }
+
         this->audioCore->removeInstrument(this->instrument);
     }
 
@@ -225,7 +232,12 @@ ValueTree InstrumentTreeItem::serialize() const
     ValueTree tree(Serialization::Core::treeItem);
     tree.setProperty(Serialization::Core::treeItemType, this->type, nullptr);
     tree.setProperty(Serialization::Core::treeItemName, this->name, nullptr);
-    tree.setProperty(Serialization::Audio::instrumentId, this->instrument->getIdAndHash(), nullptr);
+
+    // the hash of a partially loaded graph would not match the one it loads into
+    const String instrumentId = this->instrument->isLoading() ?
+        this->instrument->getInstrumentID() : this->instrument->getIdAndHash();
+
+    tree.setProperty(Serialization::Audio::instrumentId, instrumentId, nullptr);
     return tree;
 }
 
@@ -233,6 +245,11 @@ void InstrumentTreeItem::deserialize(const ValueTree &tree)
 {
     this->reset();
 
+    if (this->instrument != nullptr)
+    {
+        this->instrument->removeChangeListener(this);
+    }
+
     const String id = tree.getProperty(Serialization::Audio::instrumentId);
     this->instrument = this->audioCore->findInstrumentById(id);
 
@@ -243,12 +260,33 @@ void InstrumentTreeItem::deserialize(const ValueTree &tree)
         return;
     }
 
+    this->instrument->addChangeListener(this);
     this->initInstrumentEditor();
 
     // Proceed with basic properties and children
     TreeItem::deserialize(tree);
 
-    this->updateChildrenEditors();
+    // the nodes are still being loaded in the background
+    this->hasOutdatedChildren = this->instrument->isLoading();
+    if (!this->hasOutdatedChildren)
+    {
+        this->updateChildrenEditors();
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// ChangeListener
+//===----------------------------------------------------------------------===//
+
+void InstrumentTreeItem::changeListenerCallback(ChangeBroadcaster *source)
+{
+    if (this->hasOutdatedChildren &&
+        this->instrument != nullptr &&
+        !this->instrument->isLoading())
+    {
+        this->hasOutdatedChildren = false;
+        this->updateChildrenEditors();
+    }
 }
 
 void InstrumentTreeItem::initInstrumentEditor()
@@ -24,7 +24,9 @@ class AudioCore;
 #include "TreeItem.h"
 
 // todo fix dependency on audiocore
-class InstrumentTreeItem : public TreeItem
+class InstrumentTreeItem :
+    public TreeItem,
+    public ChangeListener
 {
 public:
 
@@ -85,6 +87,13 @@ public:
 
     void deserialize(const ValueTree &tree) override;
 
+    //===------------------------------------------------------------------===//
+    // ChangeListener
+    //===------------------------------------------------------------------===//
+
+    // Rebuilds the plugin sub-items once the instrument has finished loading
+    void changeListenerCallback(ChangeBroadcaster *source) override;
+
 private:
 
     void initInstrumentEditor();
@@ -97,4 +106,6 @@ private:
 
     WeakReference<AudioCore> audioCore;
 
+    bool hasOutdatedChildren;
+
 };
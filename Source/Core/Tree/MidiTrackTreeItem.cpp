@@ -95,6 +95,49 @@ void MidiTrackTreeItem::importMidi(const MidiMessageSequence &sequence)
     this->layer->importMidi(sequence);
 }
 
+class MidiTrackImportJob final : public ThreadPoolJob
+{
+public:
+
+    MidiTrackImportJob(MidiTrackTreeItem &track, const MidiMessageSequence &sequence) :
+        ThreadPoolJob("Midi import: " + track.getTrackName()),
+        track(track),
+        sequence(sequence) {}
+
+    JobStatus runJob() override
+    {
+        this->track.importMidi(this->sequence);
+        return jobHasFinished;
+    }
+
+private:
+
+    MidiTrackTreeItem &track;
+    const MidiMessageSequence &sequence;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiTrackImportJob)
+};
+
+void MidiTrackTreeItem::importMidi(const Array<MidiTrackTreeItem *> &tracks, const MidiFile &file)
+{
+    jassert(tracks.size() <= file.getNumTracks());
+
+    ThreadPool pool(jlimit(1, SystemStats::getNumCpus(), tracks.size()));
+    OwnedArray<MidiTrackImportJob> jobs;
+
+    for (int i = 0; i < tracks.size(); ++i)
+    {
+        jassert(tracks.getUnchecked(i)->getParentItem() == nullptr);
+        auto job = jobs.add(new MidiTrackImportJob(*tracks.getUnchecked(i), *file.getTrack(i)));
+        pool.addJob(job, false);
+    }
+
+    for (auto job : jobs)
+    {
+        pool.waitForJobToFinish(job, -1);
+    }
+}
+
 //===----------------------------------------------------------------------===//
 // VCS::TrackedItem
 //===----------------------------------------------------------------------===//
@@ -49,6 +49,11 @@ public:
 
     void importMidi(const MidiMessageSequence &sequence);
 
+    // Imports each of the file's tracks into the corresponding item
+    // on a thread pool, and waits for all of them to finish;
+    // the items should not be added to the project yet:
+    static void importMidi(const Array<MidiTrackTreeItem *> &tracks, const MidiFile &file);
+
     //===------------------------------------------------------------------===//
     // VCS::TrackedItem
     //===------------------------------------------------------------------===//
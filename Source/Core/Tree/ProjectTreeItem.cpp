@@ -33,15 +33,18 @@
 #include "ProjectPageDefault.h"
 #include "ProjectPagePhone.h"
 #include "AudioCore.h"
+#include "MidiInputRouter.h"
 #include "PlayerThread.h"
 #include "SequencerLayout.h"
 #include "MidiEvent.h"
 #include "MidiSequence.h"
 #include "PianoSequence.h"
 #include "AutomationSequence.h"
+#include "Pattern.h"
 #include "Icons.h"
 #include "ProjectInfo.h"
 #include "ProjectTimeline.h"
+#include "NotesCache.h"
 #include "TrackedItem.h"
 #include "VersionControlTreeItem.h"
 #include "VersionControl.h"
@@ -94,6 +97,9 @@ void ProjectTreeItem::initialize()
     this->timeline = new ProjectTimeline(*this, "Project Timeline");
     this->vcsItems.add(this->timeline);
 
+    this->notesCache = new NotesCache(*this);
+    this->addListener(this->notesCache);
+
     this->transport->seekToPosition(0.0);
     
     this->recreatePage();
@@ -121,6 +127,7 @@ ProjectTreeItem::~ProjectTreeItem()
 
     this->removeAllListeners();
     this->sequencerLayout = nullptr;
+    this->notesCache = nullptr;
 
     this->timeline = nullptr;
     this->info = nullptr;
@@ -198,6 +205,12 @@ ProjectTimeline *ProjectTreeItem::getTimeline() const noexcept
     return this->timeline;
 }
 
+NotesCache &ProjectTreeItem::getNotesCache() const noexcept
+{
+    jassert(this->notesCache);
+    return *this->notesCache;
+}
+
 HybridRollEditMode &ProjectTreeItem::getEditMode() noexcept
 {
     return this->rollEditMode;
@@ -299,6 +312,7 @@ void ProjectTreeItem::showLinearEditor(MidiSequence *activeSequence, TreeItem *s
         
         this->sequencerLayout->showLinearEditor(pianoSequences, activeSequence);
         this->lastShownTrack = source;
+        this->routeLiveInputTo(activeSequence->getTrack());
 
         App::Layout().showPage(this->sequencerLayout, source);
     }
@@ -323,6 +337,12 @@ WeakReference<TreeItem> ProjectTreeItem::getLastShownTrack() const
     return this->lastShownTrack;
 }
 
+void ProjectTreeItem::routeLiveInputTo(const MidiTrack *track) const
+{
+    auto &router = App::Workspace().getAudioCore().getMidiInputRouter();
+    router.setSelectedInstrument(this->transport->findInstrumentFor(track));
+}
+
 void ProjectTreeItem::updateActiveGroupEditors()
 {
     Array<TrackGroupTreeItem *> myGroups(this->findChildrenOfType<TrackGroupTreeItem>());
@@ -470,13 +490,16 @@ Point<float> ProjectTreeItem::getProjectRangeInBeats() const
 
     for (auto track : tracks)
     {
-        const float layerFirstBeat = track->getSequence()->getFirstBeat();
-        const float layerLastBeat = track->getSequence()->getLastBeat();
+        const auto *sequence = track->getSequence();
+        const auto *pattern = track->getPattern();
+        const bool hasClips = (pattern != nullptr && pattern->size() > 0 && sequence->size() > 0);
+
+        // the sequence is played once per clip, at the clip's offset
+        const float layerFirstBeat = sequence->getFirstBeat() + (hasClips ? pattern->getFirstBeat() : 0.f);
+        const float layerLastBeat = sequence->getLastBeat() + (hasClips ? pattern->getLastBeat() : 0.f);
         //Logger::writeToLog(">  " + String(layerFirstBeat) + " : " + String(layerLastBeat));
         firstBeat = jmin(firstBeat, layerFirstBeat);
         lastBeat = jmax(lastBeat, layerLastBeat);
-
-        // TODO also take into account patterns!!!!!!!
     }
     
     if (firstBeat == FLT_MAX)
@@ -619,15 +642,23 @@ void ProjectTreeItem::importMidi(File &file)
         return;
     }
     
+    Array<MidiTrackTreeItem *> tracks;
     for (int trackNum = 0; trackNum < tempFile.getNumTracks(); trackNum++)
     {
-        const MidiMessageSequence *currentTrack = tempFile.getTrack(trackNum);
         const String trackName = "Track " + String(trackNum);
-        MidiTrackTreeItem *layer = new PianoTrackTreeItem(trackName);
-        this->addChildTreeItem(layer);
-        layer->importMidi(*currentTrack);
+        tracks.add(new PianoTrackTreeItem(trackName));
     }
-    
+
+    // Tracks are filled on worker threads before they are added to the project,
+    // so that nobody else is going to access them meanwhile:
+    MidiTrackTreeItem::importMidi(tracks, tempFile);
+
+    this->undoStack->clearUndoHistory();
+    for (auto *track : tracks)
+    {
+        this->addChildTreeItem(track);
+    }
+
     this->broadcastReloadProjectContent();
     this->broadcastChangeProjectBeatRange();
     this->getDocument()->save();
@@ -664,6 +695,7 @@ void ProjectTreeItem::broadcastChangeEvent(const MidiEvent &oldEvent, const Midi
 {
     //jassert(oldEvent.isValid()); // old event is allowed to be un-owned
     jassert(newEvent.isValid());
+    this->markChangedForVCS(newEvent.getSequence()->getTrack());
     this->changeListeners.call(&ProjectListener::onChangeMidiEvent, oldEvent, newEvent);
     this->sendChangeMessage();
 }
@@ -671,6 +703,7 @@ void ProjectTreeItem::broadcastChangeEvent(const MidiEvent &oldEvent, const Midi
 void ProjectTreeItem::broadcastAddEvent(const MidiEvent &event)
 {
     jassert(event.isValid());
+    this->markChangedForVCS(event.getSequence()->getTrack());
     this->changeListeners.call(&ProjectListener::onAddMidiEvent, event);
     this->sendChangeMessage();
 }
@@ -678,12 +711,14 @@ void ProjectTreeItem::broadcastAddEvent(const MidiEvent &event)
 void ProjectTreeItem::broadcastRemoveEvent(const MidiEvent &event)
 {
     jassert(event.isValid());
+    this->markChangedForVCS(event.getSequence()->getTrack());
     this->changeListeners.call(&ProjectListener::onRemoveMidiEvent, event);
     this->sendChangeMessage();
 }
 
 void ProjectTreeItem::broadcastPostRemoveEvent(MidiSequence *const layer)
 {
+    this->markChangedForVCS(layer->getTrack());
     this->changeListeners.call(&ProjectListener::onPostRemoveMidiEvent, layer);
     this->sendChangeMessage();
 }
@@ -718,36 +753,49 @@ void ProjectTreeItem::broadcastRemoveTrack(MidiTrack *const track)
 
 void ProjectTreeItem::broadcastChangeTrackProperties(MidiTrack *const track)
 {
+    this->markChangedForVCS(track);
     this->changeListeners.call(&ProjectListener::onChangeTrackProperties, track);
+
+    // the transport has updated its link to the track's instrument by now
+    if (dynamic_cast<MidiTrack *>(this->lastShownTrack.get()) == track)
+    {
+        this->routeLiveInputTo(track);
+    }
+
     this->sendChangeMessage();
 }
 
 void ProjectTreeItem::broadcastAddClip(const Clip &clip)
 {
+    this->markChangedForVCS(clip.getPattern()->getTrack());
     this->changeListeners.call(&ProjectListener::onAddClip, clip);
     this->sendChangeMessage();
 }
 
 void ProjectTreeItem::broadcastChangeClip(const Clip &oldClip, const Clip &newClip)
 {
+    this->markChangedForVCS(newClip.getPattern()->getTrack());
     this->changeListeners.call(&ProjectListener::onChangeClip, oldClip, newClip);
     this->sendChangeMessage();
 }
 
 void ProjectTreeItem::broadcastRemoveClip(const Clip &clip)
 {
+    this->markChangedForVCS(clip.getPattern()->getTrack());
     this->changeListeners.call(&ProjectListener::onRemoveClip, clip);
     this->sendChangeMessage();
 }
 
 void ProjectTreeItem::broadcastPostRemoveClip(Pattern *const pattern)
 {
+    this->markChangedForVCS(pattern->getTrack());
     this->changeListeners.call(&ProjectListener::onPostRemoveClip, pattern);
     this->sendChangeMessage();
 }
 
 void ProjectTreeItem::broadcastChangeProjectInfo(const ProjectInfo *info)
 {
+    this->info->markVCSItemChanged();
     this->changeListeners.call(&ProjectListener::onChangeProjectInfo, info);
     this->sendChangeMessage();
 }
@@ -776,6 +824,7 @@ Point<float> ProjectTreeItem::broadcastChangeProjectBeatRange()
 
 void ProjectTreeItem::broadcastReloadProjectContent()
 {
+    this->markAllChangedForVCS();
     this->changeListeners.call(&ProjectListener::onReloadProjectContent, this->getTracks());
     this->sendChangeMessage();
 }
@@ -955,6 +1004,28 @@ bool ProjectTreeItem::deleteTrackedItem(VCS::TrackedItem *item)
     return false;
 }
 
+void ProjectTreeItem::markChangedForVCS(MidiTrack *const track)
+{
+    if (auto *tracked = dynamic_cast<VCS::TrackedItem *>(track))
+    {
+        tracked->markVCSItemChanged();
+    }
+    else if (this->timeline != nullptr)
+    {
+        // annotations, time and key signatures are all tracked as the timeline
+        this->timeline->markVCSItemChanged();
+    }
+}
+
+void ProjectTreeItem::markAllChangedForVCS()
+{
+    const ScopedReadLock lock(this->vcsInfoLock);
+    for (auto *item : this->vcsItems)
+    {
+        const_cast<VCS::TrackedItem *>(item)->markVCSItemChanged();
+    }
+}
+
 void ProjectTreeItem::onResetState()
 {
     this->broadcastReloadProjectContent();
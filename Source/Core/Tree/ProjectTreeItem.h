@@ -34,6 +34,7 @@ class TrackMap;
 class Transport;
 class ProjectInfo;
 class ProjectTimeline;
+class NotesCache;
 class ToolsSidebar;
 class UndoStack;
 class RecentFilesList;
@@ -69,6 +70,7 @@ public:
     Transport &getTransport() const noexcept;
     ProjectInfo *getProjectInfo() const noexcept;
     ProjectTimeline *getTimeline() const noexcept;
+    NotesCache &getNotesCache() const noexcept;
     HybridRollEditMode &getEditMode() noexcept;
     HybridRoll *getLastFocusedRoll() const;
     
@@ -202,6 +204,9 @@ private:
 
     void collectTracks(Array<MidiTrack *> &resultArray, bool onlySelected = false) const;
 
+    // The live midi input only plays the instrument of the track being edited
+    void routeLiveInputTo(const MidiTrack *track) const;
+
     ScopedPointer<Autosaver> autosaver;
     ScopedPointer<Transport> transport;
     WeakReference<RecentFilesList> recentFilesList;
@@ -219,6 +224,7 @@ private:
     ReadWriteLock tracksListLock;
     ScopedPointer<ProjectInfo> info;
     ScopedPointer<ProjectTimeline> timeline;
+    ScopedPointer<NotesCache> notesCache;
 
     WeakReference<TreeItem> lastShownTrack;
 
@@ -240,4 +246,8 @@ private:
 
     void rebuildSequencesHashIfNeeded();
 
+    // Lets the vcs head re-diff only the items that have changed
+    void markChangedForVCS(MidiTrack *const track);
+    void markAllChangedForVCS();
+
 };
@@ -102,14 +102,22 @@ void RootTreeItem::importMidi(const File &file)
     this->addChildTreeItem(project);
     this->addVCS(project);
 
+    Array<MidiTrackTreeItem *> tracks;
     for (int trackNum = 0; trackNum < tempFile.getNumTracks(); trackNum++)
     {
-        const MidiMessageSequence *currentTrack = tempFile.getTrack(trackNum);
-        String trackName = "Track " + String(trackNum);
-        MidiTrackTreeItem *layer = this->addPianoTrack(project, trackName);
-        layer->importMidi(*currentTrack);
+        const String trackName = "Track " + String(trackNum);
+        tracks.add(new PianoTrackTreeItem(trackName));
     }
 
+    MidiTrackTreeItem::importMidi(tracks, tempFile);
+
+    for (auto *track : tracks)
+    {
+        project->addChildTreeItem(track);
+    }
+
+    project->broadcastReloadProjectContent();
+
     //this->addAutoLayer(project, "Tempo", 81);
 
     // todo сохранить по умолчанию рядом - или куда?
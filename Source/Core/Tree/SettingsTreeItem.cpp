@@ -23,6 +23,7 @@
 #include "SerializationKeys.h"
 #include "AuthSettings.h"
 #include "AudioSettings.h"
+#include "PerformanceSettings.h"
 #include "ThemeSettings.h"
 #include "OpenGLSettings.h"
 #include "TranslationSettings.h"
@@ -82,6 +83,8 @@ void SettingsTreeItem::recreatePage()
     this->themeSettings = nullptr;
     this->audioSettingsWrapper = nullptr;
     this->audioSettings = nullptr;
+    this->performanceSettingsWrapper = nullptr;
+    this->performanceSettings = nullptr;
     this->settingsList = nullptr;
     
     this->settingsList = new ComponentsList(0, 6);
@@ -102,6 +105,10 @@ void SettingsTreeItem::recreatePage()
     this->audioSettings = new AudioSettings(App::Workspace().getAudioCore());
     this->audioSettingsWrapper = new LabeledSettingsWrapper(this->audioSettings, TRANS("settings::audio"));
     this->settingsList->addAndMakeVisible(this->audioSettingsWrapper);
+
+    this->performanceSettings = new PerformanceSettings(App::Workspace().getAudioCore());
+    this->performanceSettingsWrapper = new LabeledSettingsWrapper(this->performanceSettings, TRANS("settings::performance"));
+    this->settingsList->addAndMakeVisible(this->performanceSettingsWrapper);
     
 #if ! HELIO_MOBILE
     this->openGLSettings = new OpenGLSettings();
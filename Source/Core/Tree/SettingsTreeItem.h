@@ -51,6 +51,8 @@ private:
     ScopedPointer<ComponentsList> settingsList;
     ScopedPointer<Component> audioSettings;
     ScopedPointer<Component> audioSettingsWrapper;
+    ScopedPointer<Component> performanceSettings;
+    ScopedPointer<Component> performanceSettingsWrapper;
     ScopedPointer<Component> themeSettings;
     ScopedPointer<Component> themeSettingsWrapper;
     ScopedPointer<Component> openGLSettings;
@@ -53,9 +53,10 @@ bool AnnotationEventInsertAction::undo()
     return false;
 }
 
-int AnnotationEventInsertAction::getSizeInUnits()
+int AnnotationEventInsertAction::getSizeInBytes()
 {
-    return sizeof(AnnotationEvent);
+    return sizeof(AnnotationEventInsertAction) + getStringSize(this->trackId) +
+        getStringSize(this->event.getId());
 }
 
 ValueTree AnnotationEventInsertAction::serialize() const
@@ -110,9 +111,10 @@ bool AnnotationEventRemoveAction::undo()
     return false;
 }
 
-int AnnotationEventRemoveAction::getSizeInUnits()
+int AnnotationEventRemoveAction::getSizeInBytes()
 {
-    return sizeof(AnnotationEvent);
+    return sizeof(AnnotationEventRemoveAction) + getStringSize(this->trackId) +
+        getStringSize(this->event.getId());
 }
 
 ValueTree AnnotationEventRemoveAction::serialize() const
@@ -169,9 +171,11 @@ bool AnnotationEventChangeAction::undo()
     return false;
 }
 
-int AnnotationEventChangeAction::getSizeInUnits()
+int AnnotationEventChangeAction::getSizeInBytes()
 {
-    return sizeof(AnnotationEvent) * 2;
+    return sizeof(AnnotationEventChangeAction) + getStringSize(this->trackId) +
+        getStringSize(this->eventBefore.getId()) +
+        getStringSize(this->eventAfter.getId());
 }
 
 UndoAction *AnnotationEventChangeAction::createCoalescedAction(UndoAction *nextAction)
@@ -242,6 +246,7 @@ AnnotationEventsGroupInsertAction::AnnotationEventsGroupInsertAction(MidiTrackSo
     trackId(std::move(targetTrackId))
 {
     this->annotations.swapWith(target);
+    this->annotations.minimiseStorageOverheads();
 }
 
 bool AnnotationEventsGroupInsertAction::perform()
@@ -266,9 +271,10 @@ bool AnnotationEventsGroupInsertAction::undo()
     return false;
 }
 
-int AnnotationEventsGroupInsertAction::getSizeInUnits()
+int AnnotationEventsGroupInsertAction::getSizeInBytes()
 {
-    return (sizeof(AnnotationEvent) * this->annotations.size());
+    return sizeof(AnnotationEventsGroupInsertAction) + getStringSize(this->trackId) +
+        getEventsSize(this->annotations);
 }
 
 ValueTree AnnotationEventsGroupInsertAction::serialize() const
@@ -295,6 +301,8 @@ void AnnotationEventsGroupInsertAction::deserialize(const ValueTree &tree)
         ae.deserialize(params);
         this->annotations.add(ae);
     }
+
+    this->annotations.minimiseStorageOverheads();
 }
 
 void AnnotationEventsGroupInsertAction::reset()
@@ -313,6 +321,7 @@ AnnotationEventsGroupRemoveAction::AnnotationEventsGroupRemoveAction(MidiTrackSo
     trackId(std::move(targetTrackId))
 {
     this->annotations.swapWith(target);
+    this->annotations.minimiseStorageOverheads();
 }
 
 bool AnnotationEventsGroupRemoveAction::perform()
@@ -337,9 +346,10 @@ bool AnnotationEventsGroupRemoveAction::undo()
     return false;
 }
 
-int AnnotationEventsGroupRemoveAction::getSizeInUnits()
+int AnnotationEventsGroupRemoveAction::getSizeInBytes()
 {
-    return (sizeof(AnnotationEvent) * this->annotations.size());
+    return sizeof(AnnotationEventsGroupRemoveAction) + getStringSize(this->trackId) +
+        getEventsSize(this->annotations);
 }
 
 ValueTree AnnotationEventsGroupRemoveAction::serialize() const
@@ -366,6 +376,8 @@ void AnnotationEventsGroupRemoveAction::deserialize(const ValueTree &tree)
         ae.deserialize(params);
         this->annotations.add(ae);
     }
+
+    this->annotations.minimiseStorageOverheads();
 }
 
 void AnnotationEventsGroupRemoveAction::reset()
@@ -385,7 +397,9 @@ AnnotationEventsGroupChangeAction::AnnotationEventsGroupChangeAction(MidiTrackSo
     trackId(std::move(targetTrackId))
 {
     this->eventsBefore.addArray(state1);
+    this->eventsBefore.minimiseStorageOverheads();
     this->eventsAfter.addArray(state2);
+    this->eventsAfter.minimiseStorageOverheads();
 }
 
 bool AnnotationEventsGroupChangeAction::perform()
@@ -410,10 +424,11 @@ bool AnnotationEventsGroupChangeAction::undo()
     return false;
 }
 
-int AnnotationEventsGroupChangeAction::getSizeInUnits()
+int AnnotationEventsGroupChangeAction::getSizeInBytes()
 {
-    return (sizeof(AnnotationEvent) * this->eventsBefore.size()) +
-        (sizeof(AnnotationEvent) * this->eventsAfter.size());
+    return sizeof(AnnotationEventsGroupChangeAction) + getStringSize(this->trackId) +
+        getEventsSize(this->eventsBefore) +
+        getEventsSize(this->eventsAfter);
 }
 
 UndoAction *AnnotationEventsGroupChangeAction::createCoalescedAction(UndoAction *nextAction)
@@ -495,6 +510,9 @@ void AnnotationEventsGroupChangeAction::deserialize(const ValueTree &tree)
         ae.deserialize(params);
         this->eventsAfter.add(ae);
     }
+
+    this->eventsBefore.minimiseStorageOverheads();
+    this->eventsAfter.minimiseStorageOverheads();
 }
 
 void AnnotationEventsGroupChangeAction::reset()
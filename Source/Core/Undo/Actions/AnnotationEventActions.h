@@ -40,7 +40,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -70,7 +70,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -100,7 +100,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     UndoAction *createCoalescedAction(UndoAction *nextAction) override;
     
     ValueTree serialize() const override;
@@ -134,7 +134,7 @@ public:
     
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -165,7 +165,7 @@ public:
     
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -196,7 +196,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     UndoAction *createCoalescedAction(UndoAction *nextAction) override;
     
     ValueTree serialize() const override;
@@ -53,9 +53,10 @@ bool AutomationEventInsertAction::undo()
     return false;
 }
 
-int AutomationEventInsertAction::getSizeInUnits()
+int AutomationEventInsertAction::getSizeInBytes()
 {
-    return sizeof(AutomationEvent);
+    return sizeof(AutomationEventInsertAction) + getStringSize(this->trackId) +
+        getStringSize(this->event.getId());
 }
 
 ValueTree AutomationEventInsertAction::serialize() const
@@ -110,9 +111,10 @@ bool AutomationEventRemoveAction::undo()
     return false;
 }
 
-int AutomationEventRemoveAction::getSizeInUnits()
+int AutomationEventRemoveAction::getSizeInBytes()
 {
-    return sizeof(AutomationEvent);
+    return sizeof(AutomationEventRemoveAction) + getStringSize(this->trackId) +
+        getStringSize(this->event.getId());
 }
 
 ValueTree AutomationEventRemoveAction::serialize() const
@@ -169,9 +171,11 @@ bool AutomationEventChangeAction::undo()
     return false;
 }
 
-int AutomationEventChangeAction::getSizeInUnits()
+int AutomationEventChangeAction::getSizeInBytes()
 {
-    return sizeof(AutomationEvent) * 2;
+    return sizeof(AutomationEventChangeAction) + getStringSize(this->trackId) +
+        getStringSize(this->eventBefore.getId()) +
+        getStringSize(this->eventAfter.getId());
 }
 
 UndoAction *AutomationEventChangeAction::createCoalescedAction(UndoAction *nextAction)
@@ -208,7 +212,7 @@ ValueTree AutomationEventChangeAction::serialize() const
     tree.appendChild(eventBeforeChild, nullptr);
     
     ValueTree eventAfterChild(Serialization::Undo::eventAfter);
-    eventAfterChild.appendChild(this->eventAfter.serialize(), nullptr);
+    eventAfterChild.appendChild(makeDelta(this->eventBefore.serialize(), this->eventAfter.serialize()), nullptr);
     tree.appendChild(eventAfterChild, nullptr);
     
     return tree;
@@ -222,7 +226,7 @@ void AutomationEventChangeAction::deserialize(const ValueTree &tree)
     const auto eventAfterChild = tree.getChildWithName(Serialization::Undo::eventAfter);
     
     this->eventBefore.deserialize(eventBeforeChild.getChild(0));
-    this->eventAfter.deserialize(eventAfterChild.getChild(0));
+    this->eventAfter.deserialize(applyDelta(this->eventBefore.serialize(), eventAfterChild.getChild(0)));
 }
 
 void AutomationEventChangeAction::reset()
@@ -242,6 +246,7 @@ AutomationEventsGroupInsertAction::AutomationEventsGroupInsertAction(MidiTrackSo
     trackId(std::move(targetLayerId))
 {
     this->events.swapWith(target);
+    this->events.minimiseStorageOverheads();
 }
 
 bool AutomationEventsGroupInsertAction::perform()
@@ -266,9 +271,10 @@ bool AutomationEventsGroupInsertAction::undo()
     return false;
 }
 
-int AutomationEventsGroupInsertAction::getSizeInUnits()
+int AutomationEventsGroupInsertAction::getSizeInBytes()
 {
-    return (sizeof(AutomationEvent) * this->events.size());
+    return sizeof(AutomationEventsGroupInsertAction) + getStringSize(this->trackId) +
+        getEventsSize(this->events);
 }
 
 ValueTree AutomationEventsGroupInsertAction::serialize() const
@@ -295,6 +301,8 @@ void AutomationEventsGroupInsertAction::deserialize(const ValueTree &tree)
         ae.deserialize(params);
         this->events.add(ae);
     }
+
+    this->events.minimiseStorageOverheads();
 }
 
 void AutomationEventsGroupInsertAction::reset()
@@ -313,6 +321,7 @@ AutomationEventsGroupRemoveAction::AutomationEventsGroupRemoveAction(MidiTrackSo
     trackId(std::move(targetTrackId))
 {
     this->events.swapWith(target);
+    this->events.minimiseStorageOverheads();
 }
 
 bool AutomationEventsGroupRemoveAction::perform()
@@ -337,9 +346,10 @@ bool AutomationEventsGroupRemoveAction::undo()
     return false;
 }
 
-int AutomationEventsGroupRemoveAction::getSizeInUnits()
+int AutomationEventsGroupRemoveAction::getSizeInBytes()
 {
-    return (sizeof(AutomationEvent) * this->events.size());
+    return sizeof(AutomationEventsGroupRemoveAction) + getStringSize(this->trackId) +
+        getEventsSize(this->events);
 }
 
 ValueTree AutomationEventsGroupRemoveAction::serialize() const
@@ -366,6 +376,8 @@ void AutomationEventsGroupRemoveAction::deserialize(const ValueTree &tree)
         ae.deserialize(params);
         this->events.add(ae);
     }
+
+    this->events.minimiseStorageOverheads();
 }
 
 void AutomationEventsGroupRemoveAction::reset()
@@ -385,7 +397,9 @@ AutomationEventsGroupChangeAction::AutomationEventsGroupChangeAction(MidiTrackSo
     trackId(std::move(targetTrackId))
 {
     this->eventsBefore.addArray(state1);
+    this->eventsBefore.minimiseStorageOverheads();
     this->eventsAfter.addArray(state2);
+    this->eventsAfter.minimiseStorageOverheads();
 }
 
 bool AutomationEventsGroupChangeAction::perform()
@@ -410,10 +424,11 @@ bool AutomationEventsGroupChangeAction::undo()
     return false;
 }
 
-int AutomationEventsGroupChangeAction::getSizeInUnits()
+int AutomationEventsGroupChangeAction::getSizeInBytes()
 {
-    return (sizeof(AutomationEvent) * this->eventsBefore.size()) +
-           (sizeof(AutomationEvent) * this->eventsAfter.size());
+    return sizeof(AutomationEventsGroupChangeAction) + getStringSize(this->trackId) +
+        getEventsSize(this->eventsBefore) +
+        getEventsSize(this->eventsAfter);
 }
 
 UndoAction *AutomationEventsGroupChangeAction::createCoalescedAction(UndoAction *nextAction)
@@ -463,9 +478,12 @@ ValueTree AutomationEventsGroupChangeAction::serialize() const
         groupBeforeChild.appendChild(this->eventsBefore.getUnchecked(i).serialize(), nullptr);
     }
     
+    // the groups are parallel arrays, so the after state is stored as deltas
     for (int i = 0; i < this->eventsAfter.size(); ++i)
     {
-        groupAfterChild.appendChild(this->eventsAfter.getUnchecked(i).serialize(), nullptr);
+        const auto after = this->eventsAfter.getUnchecked(i).serialize();
+        groupAfterChild.appendChild(i < this->eventsBefore.size() ?
+            makeDelta(groupBeforeChild.getChild(i), after) : after, nullptr);
     }
     
     tree.appendChild(groupBeforeChild, nullptr);
@@ -490,12 +508,17 @@ void AutomationEventsGroupChangeAction::deserialize(const ValueTree &tree)
         this->eventsBefore.add(ae);
     }
     
-    for (const auto &params : groupAfterChild)
+    for (int i = 0; i < groupAfterChild.getNumChildren(); ++i)
     {
         AutomationEvent ae;
-        ae.deserialize(params);
+        const auto params = groupAfterChild.getChild(i);
+        ae.deserialize(i < groupBeforeChild.getNumChildren() ?
+            applyDelta(groupBeforeChild.getChild(i), params) : params);
         this->eventsAfter.add(ae);
     }
+
+    this->eventsBefore.minimiseStorageOverheads();
+    this->eventsAfter.minimiseStorageOverheads();
 }
 
 void AutomationEventsGroupChangeAction::reset()
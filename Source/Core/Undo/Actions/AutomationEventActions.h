@@ -39,7 +39,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -69,7 +69,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -99,7 +99,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     UndoAction *createCoalescedAction(UndoAction *nextAction) override;
     
     ValueTree serialize() const override;
@@ -133,7 +133,7 @@ public:
     
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -164,7 +164,7 @@ public:
     
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -195,7 +195,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     UndoAction *createCoalescedAction(UndoAction *nextAction) override;
     
     ValueTree serialize() const override;
@@ -64,9 +64,12 @@ bool AutomationTrackInsertAction::undo()
     return false;
 }
 
-int AutomationTrackInsertAction::getSizeInUnits()
+int AutomationTrackInsertAction::getSizeInBytes()
 {
-    return this->trackName.length();
+    return sizeof(AutomationTrackInsertAction) +
+        getStringSize(this->trackId) +
+        getStringSize(this->trackName) +
+        getTreeSize(this->trackState);
 }
 
 ValueTree AutomationTrackInsertAction::serialize() const
@@ -135,14 +138,12 @@ bool AutomationTrackRemoveAction::undo()
     return false;
 }
 
-int AutomationTrackRemoveAction::getSizeInUnits()
+int AutomationTrackRemoveAction::getSizeInBytes()
 {
-    if (this->serializedTreeItem.isValid())
-    {
-        return (this->numEvents * sizeof(MidiEvent));
-    }
-    
-    return 1;
+    return sizeof(AutomationTrackRemoveAction) +
+        getStringSize(this->trackId) +
+        getStringSize(this->trackName) +
+        getTreeSize(this->serializedTreeItem);
 }
 
 ValueTree AutomationTrackRemoveAction::serialize() const
@@ -41,7 +41,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -77,7 +77,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
 
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
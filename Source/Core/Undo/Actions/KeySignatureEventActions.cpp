@@ -53,9 +53,10 @@ bool KeySignatureEventInsertAction::undo()
     return false;
 }
 
-int KeySignatureEventInsertAction::getSizeInUnits()
+int KeySignatureEventInsertAction::getSizeInBytes()
 {
-    return sizeof(KeySignatureEvent);
+    return sizeof(KeySignatureEventInsertAction) + getStringSize(this->trackId) +
+        getStringSize(this->event.getId());
 }
 
 ValueTree KeySignatureEventInsertAction::serialize() const
@@ -110,9 +111,10 @@ bool KeySignatureEventRemoveAction::undo()
     return false;
 }
 
-int KeySignatureEventRemoveAction::getSizeInUnits()
+int KeySignatureEventRemoveAction::getSizeInBytes()
 {
-    return sizeof(KeySignatureEvent);
+    return sizeof(KeySignatureEventRemoveAction) + getStringSize(this->trackId) +
+        getStringSize(this->event.getId());
 }
 
 ValueTree KeySignatureEventRemoveAction::serialize() const
@@ -169,9 +171,11 @@ bool KeySignatureEventChangeAction::undo()
     return false;
 }
 
-int KeySignatureEventChangeAction::getSizeInUnits()
+int KeySignatureEventChangeAction::getSizeInBytes()
 {
-    return sizeof(KeySignatureEvent) * 2;
+    return sizeof(KeySignatureEventChangeAction) + getStringSize(this->trackId) +
+        getStringSize(this->eventBefore.getId()) +
+        getStringSize(this->eventAfter.getId());
 }
 
 UndoAction *KeySignatureEventChangeAction::createCoalescedAction(UndoAction *nextAction)
@@ -242,6 +246,7 @@ KeySignatureEventsGroupInsertAction::KeySignatureEventsGroupInsertAction(MidiTra
     trackId(std::move(targetTrackId))
 {
     this->signatures.swapWith(target);
+    this->signatures.minimiseStorageOverheads();
 }
 
 bool KeySignatureEventsGroupInsertAction::perform()
@@ -266,9 +271,10 @@ bool KeySignatureEventsGroupInsertAction::undo()
     return false;
 }
 
-int KeySignatureEventsGroupInsertAction::getSizeInUnits()
+int KeySignatureEventsGroupInsertAction::getSizeInBytes()
 {
-    return (sizeof(KeySignatureEvent) * this->signatures.size());
+    return sizeof(KeySignatureEventsGroupInsertAction) + getStringSize(this->trackId) +
+        getEventsSize(this->signatures);
 }
 
 ValueTree KeySignatureEventsGroupInsertAction::serialize() const
@@ -295,6 +301,8 @@ void KeySignatureEventsGroupInsertAction::deserialize(const ValueTree &tree)
         ae.deserialize(params);
         this->signatures.add(ae);
     }
+
+    this->signatures.minimiseStorageOverheads();
 }
 
 void KeySignatureEventsGroupInsertAction::reset()
@@ -313,6 +321,7 @@ KeySignatureEventsGroupRemoveAction::KeySignatureEventsGroupRemoveAction(MidiTra
     trackId(std::move(targetTrackId))
 {
     this->signatures.swapWith(target);
+    this->signatures.minimiseStorageOverheads();
 }
 
 bool KeySignatureEventsGroupRemoveAction::perform()
@@ -337,9 +346,10 @@ bool KeySignatureEventsGroupRemoveAction::undo()
     return false;
 }
 
-int KeySignatureEventsGroupRemoveAction::getSizeInUnits()
+int KeySignatureEventsGroupRemoveAction::getSizeInBytes()
 {
-    return (sizeof(KeySignatureEvent) * this->signatures.size());
+    return sizeof(KeySignatureEventsGroupRemoveAction) + getStringSize(this->trackId) +
+        getEventsSize(this->signatures);
 }
 
 ValueTree KeySignatureEventsGroupRemoveAction::serialize() const
@@ -366,6 +376,8 @@ void KeySignatureEventsGroupRemoveAction::deserialize(const ValueTree &tree)
         ae.deserialize(params);
         this->signatures.add(ae);
     }
+
+    this->signatures.minimiseStorageOverheads();
 }
 
 void KeySignatureEventsGroupRemoveAction::reset()
@@ -385,7 +397,9 @@ KeySignatureEventsGroupChangeAction::KeySignatureEventsGroupChangeAction(MidiTra
     trackId(std::move(targetTrackId))
 {
     this->eventsBefore.addArray(state1);
+    this->eventsBefore.minimiseStorageOverheads();
     this->eventsAfter.addArray(state2);
+    this->eventsAfter.minimiseStorageOverheads();
 }
 
 bool KeySignatureEventsGroupChangeAction::perform()
@@ -410,10 +424,11 @@ bool KeySignatureEventsGroupChangeAction::undo()
     return false;
 }
 
-int KeySignatureEventsGroupChangeAction::getSizeInUnits()
+int KeySignatureEventsGroupChangeAction::getSizeInBytes()
 {
-    return (sizeof(KeySignatureEvent) * this->eventsBefore.size()) +
-           (sizeof(KeySignatureEvent) * this->eventsAfter.size());
+    return sizeof(KeySignatureEventsGroupChangeAction) + getStringSize(this->trackId) +
+        getEventsSize(this->eventsBefore) +
+        getEventsSize(this->eventsAfter);
 }
 
 UndoAction *KeySignatureEventsGroupChangeAction::createCoalescedAction(UndoAction *nextAction)
@@ -494,6 +509,9 @@ void KeySignatureEventsGroupChangeAction::deserialize(const ValueTree &tree)
         ae.deserialize(params);
         this->eventsAfter.add(ae);
     }
+
+    this->eventsBefore.minimiseStorageOverheads();
+    this->eventsAfter.minimiseStorageOverheads();
 }
 
 void KeySignatureEventsGroupChangeAction::reset()
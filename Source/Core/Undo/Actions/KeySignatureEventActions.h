@@ -40,7 +40,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -71,7 +71,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -102,7 +102,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     UndoAction *createCoalescedAction(UndoAction *nextAction) override;
     
     ValueTree serialize() const override;
@@ -137,7 +137,7 @@ public:
     
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -168,7 +168,7 @@ public:
     
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -200,7 +200,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     UndoAction *createCoalescedAction(UndoAction *nextAction) override;
     
     ValueTree serialize() const override;
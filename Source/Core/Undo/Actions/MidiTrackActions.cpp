@@ -56,9 +56,12 @@ bool MidiTrackRenameAction::undo()
     return false;
 }
 
-int MidiTrackRenameAction::getSizeInUnits()
+int MidiTrackRenameAction::getSizeInBytes()
 {
-    return this->xPathBefore.length() + this->xPathAfter.length();
+    return sizeof(MidiTrackRenameAction) +
+        getStringSize(this->trackId) +
+        getStringSize(this->xPathBefore) +
+        getStringSize(this->xPathAfter);
 }
 
 ValueTree MidiTrackRenameAction::serialize() const
@@ -121,9 +124,10 @@ bool MidiTrackChangeColourAction::undo()
     return false;
 }
 
-int MidiTrackChangeColourAction::getSizeInUnits()
+int MidiTrackChangeColourAction::getSizeInBytes()
 {
-    return sizeof(this->colourBefore) + sizeof(this->colourAfter);
+    return sizeof(MidiTrackChangeColourAction) +
+        getStringSize(this->trackId);
 }
 
 ValueTree MidiTrackChangeColourAction::serialize() const
@@ -182,9 +186,12 @@ bool MidiTrackChangeInstrumentAction::undo()
     return false;
 }
 
-int MidiTrackChangeInstrumentAction::getSizeInUnits()
+int MidiTrackChangeInstrumentAction::getSizeInBytes()
 {
-    return this->instrumentIdAfter.length() + this->instrumentIdBefore.length();
+    return sizeof(MidiTrackChangeInstrumentAction) +
+        getStringSize(this->trackId) +
+        getStringSize(this->instrumentIdBefore) +
+        getStringSize(this->instrumentIdAfter);
 }
 
 ValueTree MidiTrackChangeInstrumentAction::serialize() const
@@ -243,9 +250,10 @@ bool MidiTrackMuteAction::undo()
     return false;
 }
 
-int MidiTrackMuteAction::getSizeInUnits()
+int MidiTrackMuteAction::getSizeInBytes()
 {
-    return 1;
+    return sizeof(MidiTrackMuteAction) +
+        getStringSize(this->trackId);
 }
 
 String boolToString(bool val)
@@ -37,7 +37,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -69,7 +69,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
 
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -102,7 +102,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
 
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -135,7 +135,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
 
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
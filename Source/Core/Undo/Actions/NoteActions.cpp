@@ -54,9 +54,10 @@ bool NoteInsertAction::undo()
     return false;
 }
 
-int NoteInsertAction::getSizeInUnits()
+int NoteInsertAction::getSizeInBytes()
 {
-    return sizeof(Note);
+    return sizeof(NoteInsertAction) + getStringSize(this->trackId) +
+        getStringSize(this->note.getId());
 }
 
 ValueTree NoteInsertAction::serialize() const
@@ -111,9 +112,10 @@ bool NoteRemoveAction::undo()
     return false;
 }
 
-int NoteRemoveAction::getSizeInUnits()
+int NoteRemoveAction::getSizeInBytes()
 {
-    return sizeof(Note);
+    return sizeof(NoteRemoveAction) + getStringSize(this->trackId) +
+        getStringSize(this->note.getId());
 }
 
 ValueTree NoteRemoveAction::serialize() const
@@ -172,9 +174,11 @@ bool NoteChangeAction::undo()
     return false;
 }
 
-int NoteChangeAction::getSizeInUnits()
+int NoteChangeAction::getSizeInBytes()
 {
-    return sizeof(Note) * 2;
+    return sizeof(NoteChangeAction) + getStringSize(this->trackId) +
+        getStringSize(this->noteBefore.getId()) +
+        getStringSize(this->noteAfter.getId());
 }
 
 UndoAction *NoteChangeAction::createCoalescedAction(UndoAction *nextAction)
@@ -212,7 +216,7 @@ ValueTree NoteChangeAction::serialize() const
     tree.appendChild(noteBeforeChild, nullptr);
 
     ValueTree noteAfterChild(Serialization::Undo::noteAfter);
-    noteAfterChild.appendChild(this->noteAfter.serialize(), nullptr);
+    noteAfterChild.appendChild(makeDelta(this->noteBefore.serialize(), this->noteAfter.serialize()), nullptr);
     tree.appendChild(noteAfterChild, nullptr);
 
     return tree;
@@ -226,7 +230,7 @@ void NoteChangeAction::deserialize(const ValueTree &tree)
     const auto noteAfterChild = tree.getChildWithName(Serialization::Undo::noteAfter);
     
     this->noteBefore.deserialize(noteBeforeChild.getChild(0));
-    this->noteAfter.deserialize(noteAfterChild.getChild(0));
+    this->noteAfter.deserialize(applyDelta(this->noteBefore.serialize(), noteAfterChild.getChild(0)));
 }
 
 void NoteChangeAction::reset()
@@ -246,6 +250,7 @@ NotesGroupInsertAction::NotesGroupInsertAction(MidiTrackSource &source,
     trackId(std::move(targetTrackId))
 {
     this->notes.swapWith(target);
+    this->notes.minimiseStorageOverheads();
 }
 
 bool NotesGroupInsertAction::perform()
@@ -270,9 +275,10 @@ bool NotesGroupInsertAction::undo()
     return false;
 }
 
-int NotesGroupInsertAction::getSizeInUnits()
+int NotesGroupInsertAction::getSizeInBytes()
 {
-    return (sizeof(Note) * this->notes.size());
+    return sizeof(NotesGroupInsertAction) + getStringSize(this->trackId) +
+        getEventsSize(this->notes);
 }
 
 ValueTree NotesGroupInsertAction::serialize() const
@@ -299,6 +305,8 @@ void NotesGroupInsertAction::deserialize(const ValueTree &tree)
         n.deserialize(props);
         this->notes.add(n);
     }
+
+    this->notes.minimiseStorageOverheads();
 }
 
 void NotesGroupInsertAction::reset()
@@ -317,6 +325,7 @@ NotesGroupRemoveAction::NotesGroupRemoveAction(MidiTrackSource &source,
     trackId(std::move(targetTrackId))
 {
     this->notes.swapWith(target);
+    this->notes.minimiseStorageOverheads();
 }
 
 bool NotesGroupRemoveAction::perform()
@@ -341,9 +350,10 @@ bool NotesGroupRemoveAction::undo()
     return false;
 }
 
-int NotesGroupRemoveAction::getSizeInUnits()
+int NotesGroupRemoveAction::getSizeInBytes()
 {
-    return (sizeof(Note) * this->notes.size());
+    return sizeof(NotesGroupRemoveAction) + getStringSize(this->trackId) +
+        getEventsSize(this->notes);
 }
 
 ValueTree NotesGroupRemoveAction::serialize() const
@@ -370,6 +380,8 @@ void NotesGroupRemoveAction::deserialize(const ValueTree &tree)
         n.deserialize(props);
         this->notes.add(n);
     }
+
+    this->notes.minimiseStorageOverheads();
 }
 
 void NotesGroupRemoveAction::reset()
@@ -388,7 +400,9 @@ NotesGroupChangeAction::NotesGroupChangeAction(MidiTrackSource &source,
     trackId(std::move(targetTrackId))
 {
     this->notesBefore.swapWith(state1);
+    this->notesBefore.minimiseStorageOverheads();
     this->notesAfter.swapWith(state2);
+    this->notesAfter.minimiseStorageOverheads();
 }
 
 bool NotesGroupChangeAction::perform()
@@ -413,10 +427,11 @@ bool NotesGroupChangeAction::undo()
     return false;
 }
 
-int NotesGroupChangeAction::getSizeInUnits()
+int NotesGroupChangeAction::getSizeInBytes()
 {
-    return (sizeof(Note) * this->notesBefore.size()) +
-        (sizeof(Note) * this->notesAfter.size());
+    return sizeof(NotesGroupChangeAction) + getStringSize(this->trackId) +
+        getEventsSize(this->notesBefore) +
+        getEventsSize(this->notesAfter);
 }
 
 UndoAction *NotesGroupChangeAction::createCoalescedAction(UndoAction *nextAction)
@@ -472,9 +487,12 @@ ValueTree NotesGroupChangeAction::serialize() const
         groupBeforeChild.appendChild(this->notesBefore.getUnchecked(i).serialize(), nullptr);
     }
     
+    // the groups are parallel arrays, so the after state is stored as deltas
     for (int i = 0; i < this->notesAfter.size(); ++i)
     {
-        groupAfterChild.appendChild(this->notesAfter.getUnchecked(i).serialize(), nullptr);
+        const auto after = this->notesAfter.getUnchecked(i).serialize();
+        groupAfterChild.appendChild(i < this->notesBefore.size() ?
+            makeDelta(groupBeforeChild.getChild(i), after) : after, nullptr);
     }
     
     tree.appendChild(groupBeforeChild, nullptr);
@@ -499,12 +517,17 @@ void NotesGroupChangeAction::deserialize(const ValueTree &tree)
         this->notesBefore.add(n);
     }
 
-    for (const auto &props : groupAfterChild)
+    for (int i = 0; i < groupAfterChild.getNumChildren(); ++i)
     {
         Note n;
-        n.deserialize(props);
+        const auto props = groupAfterChild.getChild(i);
+        n.deserialize(i < groupBeforeChild.getNumChildren() ?
+            applyDelta(groupBeforeChild.getChild(i), props) : props);
         this->notesAfter.add(n);
     }
+
+    this->notesBefore.minimiseStorageOverheads();
+    this->notesAfter.minimiseStorageOverheads();
 }
 
 void NotesGroupChangeAction::reset()
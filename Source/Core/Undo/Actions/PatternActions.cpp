@@ -54,9 +54,10 @@ bool PatternClipInsertAction::undo()
     return false;
 }
 
-int PatternClipInsertAction::getSizeInUnits()
+int PatternClipInsertAction::getSizeInBytes()
 {
-    return sizeof(Clip);
+    return sizeof(PatternClipInsertAction) + getStringSize(this->trackId) +
+        getStringSize(this->clip.getId());
 }
 
 ValueTree PatternClipInsertAction::serialize() const
@@ -111,9 +112,10 @@ bool PatternClipRemoveAction::undo()
     return false;
 }
 
-int PatternClipRemoveAction::getSizeInUnits()
+int PatternClipRemoveAction::getSizeInBytes()
 {
-    return sizeof(Clip);
+    return sizeof(PatternClipRemoveAction) + getStringSize(this->trackId) +
+        getStringSize(this->clip.getId());
 }
 
 ValueTree PatternClipRemoveAction::serialize() const
@@ -172,9 +174,11 @@ bool PatternClipChangeAction::undo()
     return false;
 }
 
-int PatternClipChangeAction::getSizeInUnits()
+int PatternClipChangeAction::getSizeInBytes()
 {
-    return sizeof(Clip) * 2;
+    return sizeof(PatternClipChangeAction) + getStringSize(this->trackId) +
+        getStringSize(this->clipBefore.getId()) +
+        getStringSize(this->clipAfter.getId());
 }
 
 UndoAction *PatternClipChangeAction::createCoalescedAction(UndoAction *nextAction)
@@ -211,7 +215,7 @@ ValueTree PatternClipChangeAction::serialize() const
     tree.appendChild(instanceBeforeChild, nullptr);
 
     ValueTree instanceAfterChild(Serialization::Undo::instanceAfter);
-    instanceAfterChild.appendChild(this->clipAfter.serialize(), nullptr);
+    instanceAfterChild.appendChild(makeDelta(this->clipBefore.serialize(), this->clipAfter.serialize()), nullptr);
     tree.appendChild(instanceAfterChild, nullptr);
 
     return tree;
@@ -225,7 +229,7 @@ void PatternClipChangeAction::deserialize(const ValueTree &tree)
     auto instanceAfterChild = tree.getChildWithName(Serialization::Undo::instanceAfter);
 
     this->clipBefore.deserialize(instanceBeforeChild.getChild(0));
-    this->clipAfter.deserialize(instanceAfterChild.getChild(0));
+    this->clipAfter.deserialize(applyDelta(this->clipBefore.serialize(), instanceAfterChild.getChild(0)));
 }
 
 void PatternClipChangeAction::reset()
@@ -39,7 +39,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
 
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -70,7 +70,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
 
     ValueTree serialize() const override;
     void deserialize(const ValueTree &tree) override;
@@ -101,7 +101,7 @@ public:
 
     bool perform() override;
     bool undo() override;
-    int getSizeInUnits() override;
+    int getSizeInBytes() override;
     UndoAction *createCoalescedAction(UndoAction *nextAction) override;
 
     ValueTree serialize() const override;
@@ -65,9 +65,12 @@ bool PianoTrackInsertAction::undo()
     return false;
 }
 
-int PianoTrackInsertAction::getSizeInUnits()
+int PianoTrackInsertAction::getSizeInBytes()
 {
-    return this->trackName.length();
+    return sizeof(PianoTrackInsertAction) +
+        getStringSize(this->trackId) +
+        getStringSize(this->trackName) +
+        getTreeSize(this->trackState);
 }
 
 ValueTree PianoTrackInsertAction::serialize() const
@@ -138,14 +141,12 @@ bool PianoTrackRemoveAction::undo()
     return false;
 }
 
-int PianoTrackRemoveAction::getSizeInUnits()
+int PianoTrackRemoveAction::getSizeInBytes()
 {
-    if (this->serializedTreeItem.isValid())
-    {
-        return (this->numEvents * sizeof(MidiEvent));
-    }
-    
-    return 1;
+    return sizeof(PianoTrackRemoveAction) +
+        getStringSize(this->trackId) +
+        getStringSize(this->trackName) +
+        getTreeSize(this->serializedTreeItem);
 }
 
 ValueTree PianoTrackRemoveAction::serialize() const
@@ -53,9 +53,10 @@ bool TimeSignatureEventInsertAction::undo()
     return false;
 }
 
-int TimeSignatureEventInsertAction::getSizeInUnits()
+int TimeSignatureEventInsertAction::getSizeInBytes()
 {
-    return sizeof(TimeSignatureEvent);
+    return sizeof(TimeSignatureEventInsertAction) + getStringSize(this->trackId) +
+        getStringSize(this->event.getId());
 }
 
 ValueTree TimeSignatureEventInsertAction::serialize() const
@@ -110,9 +111,10 @@ bool TimeSignatureEventRemoveAction::undo()
     return false;
 }
 
-int TimeSignatureEventRemoveAction::getSizeInUnits()
+int TimeSignatureEventRemoveAction::getSizeInBytes()
 {
-    return sizeof(TimeSignatureEvent);
+    return sizeof(TimeSignatureEventRemoveAction) + getStringSize(this->trackId) +
+        getStringSize(this->event.getId());
 }
 
 ValueTree TimeSignatureEventRemoveAction::serialize() const
@@ -169,9 +171,11 @@ bool TimeSignatureEventChangeAction::undo()
     return false;
 }
 
-int TimeSignatureEventChangeAction::getSizeInUnits()
+int TimeSignatureEventChangeAction::getSizeInBytes()
 {
-    return sizeof(TimeSignatureEvent) * 2;
+    return sizeof(TimeSignatureEventChangeAction) + getStringSize(this->trackId) +
+        getStringSize(this->eventBefore.getId()) +
+        getStringSize(this->eventAfter.getId());
 }
 
 UndoAction *TimeSignatureEventChangeAction::createCoalescedAction(UndoAction *nextAction)
@@ -242,6 +246,7 @@ TimeSignatureEventsGroupInsertAction::TimeSignatureEventsGroupInsertAction(MidiT
     trackId(std::move(targetTrackId))
 {
     this->signatures.swapWith(target);
+    this->signatures.minimiseStorageOverheads();
 }
 
 bool TimeSignatureEventsGroupInsertAction::perform()
@@ -266,9 +271,10 @@ bool TimeSignatureEventsGroupInsertAction::undo()
     return false;
 }
 
-int TimeSignatureEventsGroupInsertAction::getSizeInUnits()
+int TimeSignatureEventsGroupInsertAction::getSizeInBytes()
 {
-    return (sizeof(TimeSignatureEvent) * this->signatures.size());
+    return sizeof(TimeSignatureEventsGroupInsertAction) + getStringSize(this->trackId) +
+        getEventsSize(this->signatures);
 }
 
 ValueTree TimeSignatureEventsGroupInsertAction::serialize() const
@@ -295,6 +301,8 @@ void TimeSignatureEventsGroupInsertAction::deserialize(const ValueTree &tree)
         ae.deserialize(params);
         this->signatures.add(ae);
     }
+
+    this->signatures.minimiseStorageOverheads();
 }
 
 void TimeSignatureEventsGroupInsertAction::reset()
@@ -313,6 +321,7 @@ TimeSignatureEventsGroupRemoveAction::TimeSignatureEventsGroupRemoveAction(MidiT
     trackId(std::move(targetTrackId))
 {
     this->signatures.swapWith(target);
+    this->signatures.minimiseStorageOverheads();
 }
 
 bool TimeSignatureEventsGroupRemoveAction::perform()
@@ -337,9 +346,10 @@ bool TimeSignatureEventsGroupRemoveAction::undo()
     return false;
 }
 
-int TimeSignatureEventsGroupRemoveAction::getSizeInUnits()
+int TimeSignatureEventsGroupRemoveAction::getSizeInBytes()
 {
-    return (sizeof(TimeSignatureEvent) * this->signatures.size());
+    return sizeof(TimeSignatureEventsGroupRemoveAction) + getStringSize(this->trackId) +
+        getEventsSize(this->signatures);
 }
 
 ValueTree TimeSignatureEventsGroupRemoveAction::serialize() const
@@ -366,6 +376,8 @@ void TimeSignatureEventsGroupRemoveAction::deserialize(const ValueTree &tree)
         ae.deserialize(params);
         this->signatures.add(ae);
     }
+
+    this->signatures.minimiseStorageOverheads();
 }
 
 void TimeSignatureEventsGroupRemoveAction::reset()
@@ -385,7 +397,9 @@ TimeSignatureEventsGroupChangeAction::TimeSignatureEventsGroupChangeAction(MidiT
     trackId(std::move(targetTrackId))
 {
     this->eventsBefore.addArray(state1);
+    this->eventsBefore.minimiseStorageOverheads();
     this->eventsAfter.addArray(state2);
+    this->eventsAfter.minimiseStorageOverheads();
 }
 
 bool TimeSignatureEventsGroupChangeAction::perform()
@@ -410,10 +424,11 @@ bool TimeSignatureEventsGroupChangeAction::undo()
     return false;
 }
 
-int TimeSignatureEventsGroupChangeAction::getSizeInUnits()
+int TimeSignatureEventsGroupChangeAction::getSizeInBytes()
 {
-    return (sizeof(TimeSignatureEvent) * this->eventsBefore.size()) +
-           (sizeof(TimeSignatureEvent) * this->eventsAfter.size());
+    return sizeof(TimeSignatureEventsGroupChangeAction) + getStringSize(this->trackId) +
+        getEventsSize(this->eventsBefore) +
+        getEventsSize(this->eventsAfter);
 }
 
 UndoAction *TimeSignatureEventsGroupChangeAction::createCoalescedAction(UndoAction *nextAction)
@@ -494,6 +509,9 @@ void TimeSignatureEventsGroupChangeAction::deserialize(const ValueTree &tree)
         ae.deserialize(params);
         this->eventsAfter.add(ae);
     }
+
+    this->eventsBefore.minimiseStorageOverheads();
+    this->eventsAfter.minimiseStorageOverheads();
 }
 
 void TimeSignatureEventsGroupChangeAction::reset()
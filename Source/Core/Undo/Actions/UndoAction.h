@@ -30,9 +30,11 @@ public:
     virtual bool perform() = 0;
     virtual bool undo() = 0;
 
-    virtual int getSizeInUnits()
+    // The estimated number of bytes this action holds in memory,
+    // including the heap allocations of the events and ids it stores
+    virtual int getSizeInBytes()
     {
-        return 10;
+        return sizeof(UndoAction);
     }
 
     virtual UndoAction *createCoalescedAction(UndoAction* nextAction)
@@ -45,4 +47,98 @@ protected:
     
     MidiTrackSource &source;
 
+    //===------------------------------------------------------------------===//
+    // Memory accounting helpers
+    //===------------------------------------------------------------------===//
+
+    static int getStringSize(const String &string) noexcept
+    {
+        // non-empty strings are ref-counted heap buffers with a small header
+        return string.isEmpty() ? 0 :
+            int(sizeof(int) + sizeof(size_t) + string.getNumBytesAsUTF8() + 1);
+    }
+
+    // Expects the array to have no spare capacity, see minimiseStorageOverheads
+    template<typename T>
+    static int getEventsSize(const Array<T> &events) noexcept
+    {
+        int size = events.size() * sizeof(T);
+        for (const auto &event : events)
+        {
+            size += getStringSize(event.getId());
+        }
+
+        return size;
+    }
+
+    static int getTreeSize(const ValueTree &tree) noexcept
+    {
+        // a rough guess of the shared object, plus a name-value pair per property
+        int size = 64;
+        for (int i = 0; i < tree.getNumProperties(); ++i)
+        {
+            const auto &value = tree.getProperty(tree.getPropertyName(i));
+            size += sizeof(NamedValueSet::NamedValue) +
+                (value.isString() ? getStringSize(value.toString()) : 0);
+        }
+
+        for (const auto &child : tree)
+        {
+            size += sizeof(ValueTree) + getTreeSize(child);
+        }
+
+        return size;
+    }
+
+    //===------------------------------------------------------------------===//
+    // Delta encoding helpers
+    //===------------------------------------------------------------------===//
+
+    // Change actions store the state after the change as a delta against
+    // the state before, since most edits only touch one or two properties.
+    // Applying a full state as a delta gives the same full state,
+    // so the histories saved before that are still read correctly.
+
+    static ValueTree makeDelta(const ValueTree &before, const ValueTree &after)
+    {
+        ValueTree delta(after.getType());
+        for (int i = 0; i < after.getNumProperties(); ++i)
+        {
+            const auto key = after.getPropertyName(i);
+            const auto &value = after.getProperty(key);
+            if (!before.hasProperty(key) || before.getProperty(key) != value)
+            {
+                delta.setProperty(key, value, nullptr);
+            }
+        }
+
+        for (const auto &child : after)
+        {
+            delta.appendChild(child.createCopy(), nullptr);
+        }
+
+        return delta;
+    }
+
+    static ValueTree applyDelta(const ValueTree &before, const ValueTree &delta)
+    {
+        ValueTree after(before.createCopy());
+        for (int i = 0; i < delta.getNumProperties(); ++i)
+        {
+            const auto key = delta.getPropertyName(i);
+            after.setProperty(key, delta.getProperty(key), nullptr);
+        }
+
+        if (delta.getNumChildren() > 0)
+        {
+            after.removeAllChildren(nullptr);
+            for (const auto &child : delta)
+            {
+                after.appendChild(child.createCopy(), nullptr);
+            }
+        }
+
+        return after;
+    }
+
 };
@@ -33,12 +33,18 @@
 #include "PatternActions.h"
 
 #define MAX_TRANSACTIONS_TO_STORE 10
+#define MAX_BYTES_TO_STORE (512 * 1024)
+
+// Compact the history file when most of it is taken by dropped transactions
+#define HISTORY_FILE_MIN_SIZE_TO_COMPACT (16 * 1024 * 1024)
 
 using namespace Serialization;
 
 UndoStack::ActionSet::ActionSet(ProjectTreeItem &parentProject, String transactionName) :
 project(parentProject),
-name(std::move(transactionName)) {}
+name(std::move(transactionName)),
+spillOffset(0),
+spillSize(0) {}
     
 bool UndoStack::ActionSet::perform() const
 {
@@ -71,7 +77,7 @@ int UndoStack::ActionSet::getTotalSize() const
     int total = 0;
         
     for (int i = actions.size(); --i >= 0;) {
-        total += actions.getUnchecked(i)->getSizeInUnits();
+        total += actions.getUnchecked(i)->getSizeInBytes();
     }
         
     return total;
@@ -161,20 +167,25 @@ UndoAction *UndoStack::ActionSet::createUndoActionsByTagName(const Identifier &t
 }
 
 UndoStack::UndoStack (ProjectTreeItem &parentProject,
-    const int maxNumberOfUnitsToKeep,
-    const int minimumTransactions) :
+    const int maxInMemory,
+    const int maxOnDisk,
+    const int minimumInMemory) :
     project(parentProject),
-    totalUnitsStored(0),
+    totalBytesInMemory(0),
+    maxBytesInMemory(maxInMemory),
+    minimumTransactionsInMemory(jmax(1, minimumInMemory)),
     nextIndex(0),
+    totalBytesOnDisk(0),
+    maxBytesOnDisk(maxOnDisk),
     newTransaction(true),
-    reentrancyCheck(false),
-    maxNumUnitsToKeep(maxNumberOfUnitsToKeep),
-    minimumTransactionsToKeep(minimumTransactions) {}
+    reentrancyCheck(false) {}
 
 void UndoStack::clearUndoHistory()
 {
     transactions.clear();
-    totalUnitsStored = 0;
+    totalBytesInMemory = 0;
+    totalBytesOnDisk = 0;
+    historyFile = nullptr;
     nextIndex = 0;
     sendChangeMessage();
 }
@@ -220,7 +231,7 @@ bool UndoStack::perform (UndoAction *const newAction)
                         if (UndoAction *const coalescedAction = lastAction->createCoalescedAction(action))
                         {
                             action = coalescedAction;
-                            totalUnitsStored -= lastAction->getSizeInUnits();
+                            totalBytesInMemory -= lastAction->getSizeInBytes();
                             actionSet->actions.remove(i);
                             break;
                         }
@@ -234,7 +245,7 @@ bool UndoStack::perform (UndoAction *const newAction)
                 ++nextIndex;
             }
             
-            totalUnitsStored += action->getSizeInUnits();
+            totalBytesInMemory += action->getSizeInBytes();
             actionSet->actions.add (action.release());
             newTransaction = false;
             //Logger::writeToLog("size " + String(actionSet->actions.size()));
@@ -252,22 +263,52 @@ void UndoStack::clearFutureTransactions()
 {
     while (this->nextIndex < this->transactions.size())
     {
-        this->totalUnitsStored -= transactions.getLast()->getTotalSize();
-        this->transactions.removeLast();
+        this->removeTransaction(this->transactions.size() - 1);
     }
     
-    while (this->nextIndex > 0
-           && this->totalUnitsStored > this->maxNumUnitsToKeep
-           && this->transactions.size() > this->minimumTransactionsToKeep)
+    // spill the oldest transactions, but keep the recent ones in memory;
+    // if the history file is not writable, just forget them
+    for (int i = 0; i < this->nextIndex - this->minimumTransactionsInMemory &&
+        this->totalBytesInMemory > this->maxBytesInMemory; ++i)
+    {
+        ActionSet *actionSet = this->transactions.getUnchecked(i);
+        if (!actionSet->isSpilled() && !this->spillTransaction(actionSet))
+        {
+            this->removeTransaction(i);
+            --this->nextIndex;
+            --i;
+        }
+    }
+
+    while (this->nextIndex > this->minimumTransactionsInMemory
+           && this->totalBytesOnDisk > this->maxBytesOnDisk)
     {
-        this->totalUnitsStored -= this->transactions.getFirst()->getTotalSize();
-        this->transactions.remove (0);
+        this->removeTransaction(0);
         --this->nextIndex;
-        
-        // if this fails, then some actions may not be returning
-        // consistent results from their getSizeInUnits() method
-        jassert (this->totalUnitsStored >= 0);
     }
+
+    if (this->historyFile != nullptr && this->totalBytesOnDisk == 0)
+    {
+        this->historyFile = nullptr;
+    }
+    else if (this->historyFile != nullptr &&
+        this->historyFile->getFile().getSize() > HISTORY_FILE_MIN_SIZE_TO_COMPACT &&
+        this->historyFile->getFile().getSize() > this->totalBytesOnDisk * 2)
+    {
+        this->compactHistoryFile();
+    }
+
+    // if this fails, then some actions may not be returning
+    // consistent results from their getSizeInBytes() method
+    jassert (this->totalBytesInMemory >= 0 && this->totalBytesOnDisk >= 0);
+}
+
+void UndoStack::removeTransaction(int index)
+{
+    const ActionSet *actionSet = this->transactions.getUnchecked(index);
+    this->totalBytesInMemory -= actionSet->getTotalSize();
+    this->totalBytesOnDisk -= actionSet->spillSize;
+    this->transactions.remove(index);
 }
 
 void UndoStack::beginNewTransaction() noexcept
@@ -298,11 +339,11 @@ bool UndoStack::canRedo() const noexcept   { return getNextSet()    != nullptr;
 
 bool UndoStack::undo()
 {
-    if (const ActionSet* const s = getCurrentSet())
+    if (ActionSet* const s = getCurrentSet())
     {
         const ScopedValueSetter<bool> setter (reentrancyCheck, true);
         
-        if (s->undo()) {
+        if ((! s->isSpilled() || restoreTransaction(s)) && s->undo()) {
             --nextIndex;
         } else {
             clearUndoHistory();
@@ -381,6 +422,137 @@ int UndoStack::getNumActionsInCurrentTransaction() const
     return 0;
 }
 
+//===----------------------------------------------------------------------===//
+// History file
+//===----------------------------------------------------------------------===//
+
+bool UndoStack::spillTransaction(ActionSet *actionSet)
+{
+    jassert(!actionSet->isSpilled());
+
+    if (this->historyFile == nullptr)
+    {
+        this->historyFile = new TemporaryFile(".undo");
+    }
+
+    MemoryOutputStream block;
+
+    {
+        GZIPCompressorOutputStream compressor(&block, 1, false);
+        actionSet->serialize().writeToStream(compressor);
+    }
+
+    FileOutputStream out(this->historyFile->getFile());
+    if (!out.openedOk())
+    {
+        return false;
+    }
+
+    const int64 offset = out.getPosition();
+    if (!out.write(block.getData(), block.getDataSize()))
+    {
+        return false;
+    }
+
+    out.flush();
+    if (out.getStatus().failed())
+    {
+        return false;
+    }
+
+    actionSet->spillOffset = offset;
+    actionSet->spillSize = int(block.getDataSize());
+
+    this->totalBytesInMemory -= actionSet->getTotalSize();
+    this->totalBytesOnDisk += actionSet->spillSize;
+    actionSet->actions.clear();
+    return true;
+}
+
+bool UndoStack::restoreTransaction(ActionSet *actionSet)
+{
+    jassert(actionSet->isSpilled());
+
+    if (this->historyFile == nullptr)
+    {
+        return false;
+    }
+
+    FileInputStream in(this->historyFile->getFile());
+    if (!in.openedOk() || !in.setPosition(actionSet->spillOffset))
+    {
+        return false;
+    }
+
+    MemoryBlock block;
+    if (in.readIntoMemoryBlock(block, actionSet->spillSize) != size_t(actionSet->spillSize))
+    {
+        return false;
+    }
+
+    MemoryInputStream blockStream(block, false);
+    GZIPDecompressorInputStream decompressor(blockStream);
+    const auto tree = ValueTree::readFromStream(decompressor);
+    if (!tree.isValid())
+    {
+        return false;
+    }
+
+    actionSet->deserialize(tree);
+    this->totalBytesOnDisk -= actionSet->spillSize;
+    this->totalBytesInMemory += actionSet->getTotalSize();
+    actionSet->spillOffset = 0;
+    actionSet->spillSize = 0;
+    return true;
+}
+
+// The dropped and restored transactions leave holes in the history file,
+// so once in a while the remaining blocks are moved into a new file
+void UndoStack::compactHistoryFile()
+{
+    ScopedPointer<TemporaryFile> newFile(new TemporaryFile(".undo"));
+
+    {
+        FileInputStream in(this->historyFile->getFile());
+        FileOutputStream out(newFile->getFile());
+        if (!in.openedOk() || !out.openedOk())
+        {
+            return;
+        }
+
+        Array<int64> newOffsets;
+        for (const auto *actionSet : this->transactions)
+        {
+            if (actionSet->isSpilled())
+            {
+                newOffsets.add(out.getPosition());
+                if (!in.setPosition(actionSet->spillOffset) ||
+                    out.writeFromInputStream(in, actionSet->spillSize) != actionSet->spillSize)
+                {
+                    return;
+                }
+            }
+        }
+
+        out.flush();
+        if (out.getStatus().failed())
+        {
+            return;
+        }
+
+        int i = 0;
+        for (auto *actionSet : this->transactions)
+        {
+            if (actionSet->isSpilled())
+            {
+                actionSet->spillOffset = newOffsets.getUnchecked(i++);
+            }
+        }
+    }
+
+    this->historyFile = newFile.release();
+}
+
 //===----------------------------------------------------------------------===//
 // Serializable
 //===----------------------------------------------------------------------===//
@@ -391,14 +563,21 @@ ValueTree UndoStack::serialize() const
     
     int currentIndex = (this->nextIndex - 1);
     int numStoredTransactions = 0;
+    int numStoredBytes = 0;
     
+    // the spilled history is not saved, it only lives until the app closes
     while (currentIndex >= 0 &&
-           numStoredTransactions < MAX_TRANSACTIONS_TO_STORE)
+           numStoredTransactions < MAX_TRANSACTIONS_TO_STORE &&
+           numStoredBytes < MAX_BYTES_TO_STORE)
     {
-        if (ActionSet *action = this->transactions[currentIndex])
+        const ActionSet *action = this->transactions[currentIndex];
+        if (action == nullptr || action->isSpilled())
         {
-            tree.appendChild(action->serialize(), nullptr);
+            break;
         }
+
+        tree.appendChild(action->serialize(), nullptr);
+        numStoredBytes += action->getTotalSize();
         
         --currentIndex;
         ++numStoredTransactions;
@@ -421,6 +600,7 @@ void UndoStack::deserialize(const ValueTree &tree)
     {
         auto actionSet = new ActionSet(this->project, String::empty);
         actionSet->deserialize(childTransaction);
+        this->totalBytesInMemory += actionSet->getTotalSize();
         this->transactions.insert(this->nextIndex, actionSet);
         ++this->nextIndex;
     }
@@ -21,13 +21,20 @@ class ProjectTreeItem;
 
 #include "UndoAction.h"
 
+#define UNDO_STACK_MAX_BYTES_IN_MEMORY (8 * 1024 * 1024)
+#define UNDO_STACK_MAX_BYTES_ON_DISK (256 * 1024 * 1024)
+
+// Keeps the recent transactions in memory, and spills the older ones
+// to a temporary history file, so that undo can go deep without
+// holding the whole history in RAM or saving it into the project
 class UndoStack final : public ChangeBroadcaster, public Serializable
 {
 public:
 
     explicit UndoStack(ProjectTreeItem &parentProject,
-        int maxNumberOfUnitsToKeep = 30000,
-        int minimumTransactionsToKeep = 30);
+        int maxBytesInMemory = UNDO_STACK_MAX_BYTES_IN_MEMORY,
+        int maxBytesOnDisk = UNDO_STACK_MAX_BYTES_ON_DISK,
+        int minimumTransactionsInMemory = 30);
     
     void clearUndoHistory();
 
@@ -73,22 +80,41 @@ private:
 
         UndoAction *createUndoActionsByTagName(const Identifier &tagName);
 
+        // The transaction is spilled when its actions are only stored
+        // in the history file, as a compressed block at spillOffset
+        inline bool isSpilled() const noexcept { return this->spillSize > 0; }
+
         OwnedArray<UndoAction> actions;
         String name;
 
+        int64 spillOffset;
+        int spillSize;
+
         ProjectTreeItem &project;
     };
     
     OwnedArray<ActionSet> transactions;
     String newTransactionName;
     
-    int totalUnitsStored, maxNumUnitsToKeep, minimumTransactionsToKeep, nextIndex;
+    int totalBytesInMemory, maxBytesInMemory, minimumTransactionsInMemory, nextIndex;
+    int64 totalBytesOnDisk, maxBytesOnDisk;
     bool newTransaction, reentrancyCheck;
     
     ActionSet *getCurrentSet() const noexcept;
     ActionSet *getNextSet() const noexcept;
     
     void clearFutureTransactions();
+    void removeTransaction(int index);
+
+    //===------------------------------------------------------------------===//
+    // History file
+    //===------------------------------------------------------------------===//
+
+    ScopedPointer<TemporaryFile> historyFile;
+
+    bool spillTransaction(ActionSet *actionSet);
+    bool restoreTransaction(ActionSet *actionSet);
+    void compactHistoryFile();
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (UndoStack)
 };
@@ -27,8 +27,9 @@
 
 using namespace VCS;
 
-Client::Client(VersionControl &versionControl) :
+Client::Client(VersionControl &versionControl, const String &serverUrl) :
     vcs(versionControl),
+    serverUrl(serverUrl.isNotEmpty() ? serverUrl : HelioFM::baseURL),
     lastPushState(SyncThread::readyToRock),
     lastPullState(SyncThread::readyToRock),
     lastRemovalState(SyncThread::readyToRock),
@@ -36,6 +37,12 @@ Client::Client(VersionControl &versionControl) :
     pullThread(nullptr),
     removalThread(nullptr) {}
 
+URL Client::getSyncUrl() const
+{
+    return URL(this->serverUrl +
+        HelioFM::Api::V1::vcs.replace(":project", this->vcs.getPublicId()));
+}
+
 bool Client::push()
 {
     //Logger::writeToLog(DocumentReader::obfuscate(HELIO_CLOUD_URL));
@@ -47,7 +54,7 @@ bool Client::push()
     const auto vcsNode(this->vcs.serialize());
 
     this->pushThread =
-        new PushThread(URL(HelioFM::Api::V1::vcs),
+        new PushThread(this->getSyncUrl(),
                        this->vcs.getPublicId(),
                        this->vcs.getParentName(),
                        this->vcs.getKey(),
@@ -73,7 +80,7 @@ bool Client::pull()
     const auto vcsNode(this->vcs.serialize());
 
     this->pullThread =
-        new PullThread(URL(HelioFM::Api::V1::vcs),
+        new PullThread(this->getSyncUrl(),
                        this->vcs.getPublicId(),
                        this->vcs.getKey(),
                        vcsNode);
@@ -96,7 +103,7 @@ bool Client::remove()
     if (this->isRemoving()) { return false; }
     
     this->removalThread =
-        new RemovalThread(URL(HelioFM::Api::V1::vcs),
+        new RemovalThread(this->getSyncUrl(),
                           this->vcs.getPublicId(),
                           this->vcs.getKey());
     
@@ -33,7 +33,8 @@ namespace VCS
     {
     public:
 
-        explicit Client(VersionControl &versionControl);
+        // The server address can be overridden, e.g. to sync against a local server
+        explicit Client(VersionControl &versionControl, const String &serverUrl = {});
         
         bool push();
         bool pull();
@@ -60,9 +61,12 @@ namespace VCS
 
         void changeListenerCallback(ChangeBroadcaster *source) override;
 
+        URL getSyncUrl() const;
+
     private:
 
         VersionControl &vcs;
+        const String serverUrl;
 
         ScopedPointer<Component> progressBar;
         
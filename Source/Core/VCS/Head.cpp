@@ -29,6 +29,7 @@
 using namespace VCS;
 
 #define DIFF_BUILD_THREAD_STOP_TIMEOUT 5000
+#define DIFF_BUILD_JOB_WAIT_TIMEOUT 50
 
 Head::Head(const Head &other) :
     Thread("Diff Thread"),
@@ -38,7 +39,8 @@ Head::Head(const Head &other) :
     rebuildingDiffMode(false),
     diff(other.diff),
     headingAt(other.headingAt),
-    state(new HeadState(other.state))
+    state(new HeadState(other.state)),
+    needsFullRebuild(true)
 {
 }
 
@@ -50,7 +52,8 @@ Head::Head(Pack::Ptr packPtr, WeakReference<TrackedItemsSource> targetProject) :
     rebuildingDiffMode(false),
     diff(Revision::create(packPtr)),
     headingAt(Revision::create(packPtr)),
-    state(nullptr)
+    state(nullptr),
+    needsFullRebuild(true)
 {
     if (targetVcsItemsSource != nullptr)
     {
@@ -158,6 +161,8 @@ void Head::mergeStateWith(ValueTree changes)
             else { jassertfalse; }
         }
     }
+
+    this->invalidateAllItemDiffs();
 }
 
 bool VCS::Head::moveTo(const ValueTree revision)
@@ -225,6 +230,7 @@ bool VCS::Head::moveTo(const ValueTree revision)
     }
 
     this->headingAt = revision;
+    this->invalidateAllItemDiffs();
     this->setDiffOutdated(true);
     return true;
 }
@@ -232,6 +238,7 @@ bool VCS::Head::moveTo(const ValueTree revision)
 void Head::pointTo(const ValueTree revision)
 {
     this->headingAt = revision;
+    this->invalidateAllItemDiffs();
     this->setDiffOutdated(true);
 }
 
@@ -583,6 +590,7 @@ void VCS::Head::deserialize(const ValueTree &tree)
 void Head::reset()
 {
     this->state = new HeadState();
+    this->invalidateAllItemDiffs();
     this->setDiffOutdated(true);
 }
 
@@ -601,6 +609,34 @@ void Head::changeListenerCallback(ChangeBroadcaster *source)
 // Thread
 //===----------------------------------------------------------------------===//
 
+class Head::ItemDiffJob final : public ThreadPoolJob
+{
+public:
+
+    ItemDiffJob(Head &head, TrackedItem &targetItem,
+        RevisionItem::Ptr stateItem, int changeStamp) :
+        ThreadPoolJob("Diff: " + targetItem.getVCSName()),
+        head(head),
+        targetItem(targetItem),
+        stateItem(stateItem),
+        changeStamp(changeStamp) {}
+
+    JobStatus runJob() override
+    {
+        this->head.diffItem(this->targetItem, this->stateItem, this->changeStamp);
+        return jobHasFinished;
+    }
+
+private:
+
+    Head &head;
+    TrackedItem &targetItem;
+    RevisionItem::Ptr stateItem;
+    int changeStamp;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ItemDiffJob)
+};
+
 void Head::run()
 {
     if (this->targetVcsItemsSource == nullptr)
@@ -612,213 +648,192 @@ void Head::run()
     this->setRebuildingDiffMode(true);
     this->sendChangeMessage();
 
+    const bool finished = this->rebuildDiff(true);
+
+    if (finished)
     {
-        const ScopedWriteLock lock(this->diffLock);
-        this->diff.removeAllChildren(nullptr);
-        this->diff.removeAllProperties(nullptr);
+        this->setDiffOutdated(false);
+    }
+
+    this->setRebuildingDiffMode(false);
+    this->sendChangeMessage();
+}
+
+void Head::rebuildDiffSynchronously()
+{
+    if (this->targetVcsItemsSource == nullptr)
+    { return; }
+    
+    if (this->state == nullptr)
+    { return; }
+    
+    if (this->isRebuildingDiff())
+    { return; }
+    
+    this->setRebuildingDiffMode(true);
+    this->rebuildDiff(false);
+    this->setDiffOutdated(false);
+    this->setRebuildingDiffMode(false);
+    this->sendChangeMessage();
+}
+
+bool Head::rebuildDiff(bool canBeCancelled)
+{
+    {
+        const SpinLock::ScopedLockType stampsLock(this->itemStampsLock);
+        if (this->needsFullRebuild)
+        {
+            this->needsFullRebuild = false;
+            this->diffedItemStamps.clear();
+
+            const ScopedWriteLock lock(this->diffLock);
+            this->diff.removeAllChildren(nullptr);
+            this->diff.removeAllProperties(nullptr);
+        }
     }
 
     const ScopedReadLock threadStateLock(this->stateLock);
 
+    // removal records are not matched against the project
+    SparseHashMap<String, RevisionItem::Ptr, StringHash> stateItems;
     for (int i = 0; i < this->state->getNumTrackedItems(); ++i)
     {
-        if (this->threadShouldExit())
+        const RevisionItem::Ptr stateItem = static_cast<RevisionItem *>(this->state->getTrackedItem(i));
+        if (stateItem->getType() != RevisionItem::Removed)
         {
-            this->setRebuildingDiffMode(false);
-            this->sendChangeMessage();
-            return;
+            stateItems[stateItem->getUuid().toString()] = stateItem;
         }
+    }
 
-        bool foundItemInTarget = false;
-        const RevisionItem::Ptr stateItem = static_cast<RevisionItem *>(this->state->getTrackedItem(i));
+    // only the items changed since their last diff are diffed again
+    SparseHashSet<String, StringHash> targetKeys;
+    OwnedArray<ItemDiffJob> jobs;
 
-        // записи удаления рассматриваем позже
-        if (stateItem->getType() == RevisionItem::Removed) { continue; }
+    for (int i = 0; i < this->targetVcsItemsSource->getNumTrackedItems(); ++i)
+    {
+        TrackedItem *targetItem = this->targetVcsItemsSource->getTrackedItem(i);
+        const String key(targetItem->getUuid().toString());
+        const int changeStamp = targetItem->getVCSChangeStamp();
+        targetKeys.insert(key);
 
-        for (int j = 0; j < this->targetVcsItemsSource->getNumTrackedItems(); ++j)
         {
-            if (this->threadShouldExit())
+            const SpinLock::ScopedLockType lock(this->itemStampsLock);
+            const auto diffedStamp = this->diffedItemStamps.find(key);
+            if (diffedStamp != this->diffedItemStamps.end() &&
+                diffedStamp->second == changeStamp)
             {
-                this->setRebuildingDiffMode(false);
-                this->sendChangeMessage();
-                return;
+                continue;
             }
+        }
 
-            TrackedItem *targetItem = this->targetVcsItemsSource->getTrackedItem(j); // i.e. LayerTreeItem
-
-            // айтем из состояния - существует в проекте. добавляем запись changed, если нужно.
-            if (stateItem->getUuid() == targetItem->getUuid())
-            {
-                foundItemInTarget = true;
-
-                ScopedPointer<Diff> itemDiff(targetItem->getDiffLogic()->createDiff(*stateItem));
-
-                if (itemDiff->hasAnyChanges())
-                {
-                    RevisionItem::Ptr revisionRecord(new RevisionItem(this->pack, RevisionItem::Changed, itemDiff));
-                    var revisionVar(revisionRecord);
+        const auto stateItem = stateItems.find(key);
+        auto *job = jobs.add(new ItemDiffJob(*this, *targetItem,
+            (stateItem != stateItems.end()) ? stateItem->second : RevisionItem::Ptr(), changeStamp));
 
-                    const ScopedWriteLock itemDiffLock(this->diffLock);
-                    this->diff.setProperty(stateItem->getUuid().toString(), revisionVar, nullptr);
-                }
+        this->diffPool.addJob(job, false);
+    }
 
-                break;
-            }
+    // state items missing in the project are marked as removed
+    for (const auto &stateItem : stateItems)
+    {
+        if (targetKeys.find(stateItem.first) != targetKeys.end())
+        {
+            continue;
         }
 
-        // айтем из состояния - в проекте не найден. добавляем запись removed.
-        if (! foundItemInTarget)
         {
-            ScopedPointer<Diff> emptyDiff(new Diff(*stateItem));
+            const ScopedReadLock lock(this->diffLock);
+            const var existingRecord = this->diff.getProperty(stateItem.first);
+            const auto *revisionItem = dynamic_cast<RevisionItem *>(existingRecord.getObject());
+            if (revisionItem != nullptr && revisionItem->getType() == RevisionItem::Removed)
+            {
+                continue;
+            }
+        }
 
-            RevisionItem::Ptr revisionRecord(new RevisionItem(this->pack, RevisionItem::Removed, emptyDiff));
-            var revisionVar(revisionRecord);
+        ScopedPointer<Diff> emptyDiff(new Diff(*stateItem.second));
+        RevisionItem::Ptr revisionRecord(new RevisionItem(this->pack, RevisionItem::Removed, emptyDiff));
 
-            const ScopedWriteLock emptyDiffLock(this->diffLock);
-            this->diff.setProperty(stateItem->getUuid().toString(), revisionVar, nullptr);
-        }
+        const ScopedWriteLock lock(this->diffLock);
+        this->diff.setProperty(stateItem.first, var(revisionRecord), nullptr);
     }
 
-    // теперь ищем айтемы в проекте, которые отсутствуют - или удалены - в состоянии
-    for (int i = 0; i < this->targetVcsItemsSource->getNumTrackedItems(); ++i)
+    // and the records of the items that are gone from both are dropped
     {
-        if (this->threadShouldExit())
-        {
-            this->setRebuildingDiffMode(false);
-            this->sendChangeMessage();
-            return;
-        }
-
-        bool foundItemInState = false;
-        TrackedItem *targetItem = this->targetVcsItemsSource->getTrackedItem(i);
+        const SpinLock::ScopedLockType stampsLock(this->itemStampsLock);
+        const ScopedWriteLock lock(this->diffLock);
 
-        for (int j = 0; j < this->state->getNumTrackedItems(); ++j)
+        for (int i = this->diff.getNumProperties(); --i >= 0;)
         {
-            const RevisionItem::Ptr stateItem = static_cast<RevisionItem *>(this->state->getTrackedItem(j));
-
-            if (stateItem->getType() == RevisionItem::Removed) { continue; }
-
-            if (stateItem->getUuid() == targetItem->getUuid())
+            const Identifier id(this->diff.getPropertyName(i));
+            const String key(id.toString());
+            if (targetKeys.find(key) == targetKeys.end() &&
+                stateItems.find(key) == stateItems.end())
             {
-                foundItemInState = true;
-                break;
+                this->diff.removeProperty(id, nullptr);
+                this->diffedItemStamps.erase(key);
             }
         }
+    }
 
-        // и добавляем запись - added, с дельтами, которые тупо копируем у targetItem
-        if (! foundItemInState)
+    for (auto *job : jobs)
+    {
+        while (!this->diffPool.waitForJobToFinish(job, DIFF_BUILD_JOB_WAIT_TIMEOUT))
         {
-            RevisionItem::Ptr revisionRecord(new RevisionItem(this->pack, RevisionItem::Added, targetItem));
-            var revisionVar(revisionRecord);
-
-            const ScopedWriteLock lock(this->diffLock);
-            this->diff.setProperty(targetItem->getUuid().toString(), revisionVar, nullptr);
+            if (canBeCancelled && this->threadShouldExit())
+            {
+                this->diffPool.removeAllJobs(true, -1);
+                return false;
+            }
         }
     }
 
-    this->setDiffOutdated(false);
-    this->setRebuildingDiffMode(false);
-    this->sendChangeMessage();
+    return true;
 }
 
-// warning код практически дублирует Head::run
-void Head::rebuildDiffSynchronously()
+void Head::diffItem(TrackedItem &targetItem, RevisionItem::Ptr stateItem, int changeStamp)
 {
-    if (this->targetVcsItemsSource == nullptr)
-    { return; }
-    
-    if (this->state == nullptr)
-    { return; }
-    
-    if (this->isRebuildingDiff())
-    { return; }
-    
-    this->setRebuildingDiffMode(true);
-    
+    RevisionItem::Ptr revisionRecord;
+
+    if (stateItem == nullptr)
     {
-        const ScopedWriteLock lock(this->diffLock);
-        this->diff.removeAllChildren(nullptr);
-        this->diff.removeAllProperties(nullptr);
+        // not in the state, so it's added with all its deltas copied
+        revisionRecord = new RevisionItem(this->pack, RevisionItem::Added, &targetItem);
     }
-    
-    const ScopedReadLock rebuildStateLock(this->stateLock);
-    
-    for (int i = 0; i < this->state->getNumTrackedItems(); ++i)
+    else
     {
-        bool foundItemInTarget = false;
-        const RevisionItem::Ptr stateItem = static_cast<RevisionItem *>(this->state->getTrackedItem(i));
-        
-        // записи удаления рассматриваем позже
-        if (stateItem->getType() == RevisionItem::Removed) { continue; }
-        
-        for (int j = 0; j < this->targetVcsItemsSource->getNumTrackedItems(); ++j)
-        {
-            TrackedItem *targetItem = this->targetVcsItemsSource->getTrackedItem(j); // i.e. LayerTreeItem
-            
-            // айтем из состояния - существует в проекте. добавляем запись changed, если нужно.
-            if (stateItem->getUuid() == targetItem->getUuid())
-            {
-                foundItemInTarget = true;
-                
-                ScopedPointer<Diff> itemDiff(targetItem->getDiffLogic()->createDiff(*stateItem));
-                
-                if (itemDiff->hasAnyChanges())
-                {
-                    RevisionItem::Ptr revisionRecord(new RevisionItem(this->pack, RevisionItem::Changed, itemDiff));
-                    var revisionVar(revisionRecord);
-                    
-                    const ScopedWriteLock lock(this->diffLock);
-                    this->diff.setProperty(stateItem->getUuid().toString(), revisionVar, nullptr);
-                }
-                
-                break;
-            }
-        }
-        
-        // айтем из состояния - в проекте не найден. добавляем запись removed.
-        if (! foundItemInTarget)
+        ScopedPointer<Diff> itemDiff(targetItem.getDiffLogic()->createDiff(*stateItem));
+        if (itemDiff->hasAnyChanges())
         {
-            ScopedPointer<Diff> emptyDiff(new Diff(*stateItem));
-            
-            RevisionItem::Ptr revisionRecord(new RevisionItem(this->pack, RevisionItem::Removed, emptyDiff));
-            var revisionVar(revisionRecord);
-            
-            const ScopedWriteLock lock(this->diffLock);
-            this->diff.setProperty(stateItem->getUuid().toString(), revisionVar, nullptr);
+            revisionRecord = new RevisionItem(this->pack, RevisionItem::Changed, itemDiff);
         }
     }
-    
-    // теперь ищем айтемы в проекте, которые отсутствуют - или удалены - в состоянии
-    for (int i = 0; i < this->targetVcsItemsSource->getNumTrackedItems(); ++i)
+
+    const String key(targetItem.getUuid().toString());
+
     {
-        bool foundItemInState = false;
-        TrackedItem *targetItem = this->targetVcsItemsSource->getTrackedItem(i);
-        
-        for (int j = 0; j < this->state->getNumTrackedItems(); ++j)
+        const ScopedWriteLock lock(this->diffLock);
+        if (revisionRecord != nullptr)
         {
-            const RevisionItem::Ptr stateItem = static_cast<RevisionItem *>(this->state->getTrackedItem(j));
-            
-            if (stateItem->getType() == RevisionItem::Removed) { continue; }
-            
-            if (stateItem->getUuid() == targetItem->getUuid())
-            {
-                foundItemInState = true;
-                break;
-            }
+            this->diff.setProperty(key, var(revisionRecord), nullptr);
         }
-        
-        // и добавляем запись - added, с дельтами, которые тупо копируем у targetItem
-        if (! foundItemInState)
+        else
         {
-            RevisionItem::Ptr revisionRecord(new RevisionItem(this->pack, RevisionItem::Added, targetItem));
-            var revisionVar(revisionRecord);
-            
-            const ScopedWriteLock lock(this->diffLock);
-            this->diff.setProperty(targetItem->getUuid().toString(), revisionVar, nullptr);
+            this->diff.removeProperty(key, nullptr);
         }
     }
-    
-    this->setDiffOutdated(false);
-    this->setRebuildingDiffMode(false);
+
+    {
+        const SpinLock::ScopedLockType lock(this->itemStampsLock);
+        this->diffedItemStamps[key] = changeStamp;
+    }
+
+    // the stage is updated as soon as each item is ready
     this->sendChangeMessage();
 }
+
+void Head::invalidateAllItemDiffs()
+{
+    const SpinLock::ScopedLockType lock(this->itemStampsLock);
+    this->needsFullRebuild = true;
+}
@@ -85,6 +85,14 @@ namespace VCS
         //===--------------------------------------------------------------===//
 
         void run() override;
+
+        class ItemDiffJob;
+        friend class ItemDiffJob;
+
+        bool rebuildDiff(bool canBeCancelled); // returns false if cancelled
+        void diffItem(TrackedItem &targetItem, RevisionItem::Ptr stateItem, int changeStamp);
+        void invalidateAllItemDiffs(); // when the state has changed
+
         void checkoutItem(VCS::RevisionItem::Ptr stateItem);
         bool resetChangedItemToState(const VCS::RevisionItem::Ptr diffItem);
 
@@ -103,6 +111,15 @@ namespace VCS
         ReadWriteLock stateLock;
         ScopedPointer<HeadState> state;
 
+    private:
+
+        // The change stamps of the tracked items at the time of their last diff
+        SpinLock itemStampsLock;
+        SparseHashMap<String, int, StringHash> diffedItemStamps;
+        bool needsFullRebuild;
+
+        ThreadPool diffPool;
+
     private:
 
         WeakReference<TrackedItemsSource> targetVcsItemsSource; // ProjectTreeItem
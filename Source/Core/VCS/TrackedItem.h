@@ -27,11 +27,16 @@ namespace VCS
     {
     public:
 
-        TrackedItem() {}
+        TrackedItem() : vcsChangeStamp(getNextVCSChangeStamp()) {}
         virtual ~TrackedItem() {}
 
         const Uuid &getUuid() const { return this->vcsUuid; }
         void setVCSUuid(Uuid value) { this->vcsUuid = value; }
+
+        // The stamps are unique across all items, so a re-created item
+        // with the same uuid never looks like the one diffed before
+        void markVCSItemChanged() noexcept { this->vcsChangeStamp = getNextVCSChangeStamp(); }
+        int getVCSChangeStamp() const noexcept { return this->vcsChangeStamp.get(); }
         
         virtual int getNumDeltas() const = 0;
         virtual Delta *getDelta(int index) const = 0;
@@ -54,5 +59,15 @@ namespace VCS
 
         Uuid vcsUuid; // needs to be serialized by subclasses
 
+    private:
+
+        static int getNextVCSChangeStamp() noexcept
+        {
+            static Atomic<int> lastStamp;
+            return ++lastStamp;
+        }
+
+        Atomic<int> vcsChangeStamp;
+
     };
 } // namespace VCS
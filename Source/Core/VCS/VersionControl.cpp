@@ -133,6 +133,160 @@ void VersionControl::mergeWith(VersionControl &remoteHistory)
     this->sendChangeMessage();
 }
 
+//===----------------------------------------------------------------------===//
+// Delta sync
+//===----------------------------------------------------------------------===//
+
+// Parents always go before their children
+StringArray VersionControl::getRevisionIds() const
+{
+    StringArray ids;
+    this->recursiveGetIds(this->rootRevision, ids);
+    return ids;
+}
+
+void VersionControl::recursiveGetIds(const ValueTree revision, StringArray &ids) const
+{
+    ids.add(Revision::getUuid(revision));
+
+    for (const auto &child : revision)
+    {
+        this->recursiveGetIds(child, ids);
+    }
+}
+
+ValueTree VersionControl::createRevisionBundle(const String &revisionId) const
+{
+    const ValueTree revision(this->getRevisionById(this->rootRevision, revisionId));
+    if (Revision::getUuid(revision) != revisionId)
+    {
+        return {};
+    }
+
+    ValueTree bundle(Serialization::VCS::revisionBundle);
+    bundle.setProperty(Serialization::VCS::parentRevisionId,
+        Revision::getUuid(revision.getParent()), nullptr);
+
+    // the revision without its children, and the data for its deltas
+    ValueTree revisionData(Serialization::VCS::revision);
+    ValueTree packData(Serialization::VCS::pack);
+
+    for (int i = 0; i < revision.getNumProperties(); ++i)
+    {
+        const Identifier id(revision.getPropertyName(i));
+        const var property(revision.getProperty(id));
+
+        if (const auto *revItem = dynamic_cast<RevisionItem *>(property.getObject()))
+        {
+            revisionData.appendChild(revItem->serialize(), nullptr);
+
+            for (int j = 0; j < revItem->getNumDeltas(); ++j)
+            {
+                ValueTree record(Serialization::VCS::packItem);
+                record.setProperty(Serialization::VCS::packItemRevId, revItem->getUuid().toString(), nullptr);
+                record.setProperty(Serialization::VCS::packItemDeltaId, revItem->getDelta(j)->getUuid().toString(), nullptr);
+                record.appendChild(revItem->serializeDeltaData(j).createCopy(), nullptr);
+                packData.appendChild(record, nullptr);
+            }
+        }
+        else if (property.isString() || property.isInt64())
+        {
+            revisionData.setProperty(id, property.toString(), nullptr);
+        }
+    }
+
+    bundle.appendChild(revisionData, nullptr);
+    bundle.appendChild(packData, nullptr);
+    return bundle;
+}
+
+bool VersionControl::importRevisionBundle(const ValueTree &bundle)
+{
+    const auto revisionData = bundle.getChildWithName(Serialization::VCS::revision);
+    const auto packData = bundle.getChildWithName(Serialization::VCS::pack);
+    const String revisionId = revisionData.getProperty(Serialization::VCS::commitId);
+    const String parentId = bundle.getProperty(Serialization::VCS::parentRevisionId);
+
+    if (revisionId.isEmpty())
+    {
+        return false;
+    }
+
+    if (Revision::getUuid(this->getRevisionById(this->rootRevision, revisionId)) == revisionId)
+    {
+        return true; // already here
+    }
+
+    ValueTree parent;
+    if (parentId.isNotEmpty())
+    {
+        parent = this->getRevisionById(this->rootRevision, parentId);
+        if (Revision::getUuid(parent) != parentId)
+        {
+            return false; // the parent should be imported first
+        }
+    }
+
+    ValueTree revision(Revision::create(this->pack));
+    for (int i = 0; i < revisionData.getNumProperties(); ++i)
+    {
+        const auto id(revisionData.getPropertyName(i));
+        revision.setProperty(id, revisionData.getProperty(id), nullptr);
+    }
+
+    for (const auto &itemData : revisionData)
+    {
+        RevisionItem::Ptr item(new RevisionItem(this->pack, RevisionItem::Undefined, nullptr));
+        item->deserialize(itemData);
+
+        const String itemId = item->getUuid().toString();
+        for (const auto &record : packData)
+        {
+            if (record.getProperty(Serialization::VCS::packItemRevId).toString() == itemId)
+            {
+                item->importDataForDelta(record.getChild(0),
+                    record.getProperty(Serialization::VCS::packItemDeltaId));
+            }
+        }
+
+        revision.setProperty(itemId, var(item), nullptr);
+    }
+
+    Revision::flush(revision);
+
+    if (parent.isValid())
+    {
+        parent.appendChild(revision, nullptr);
+    }
+    else
+    {
+        // the remote root replaces the local one, like in recursiveTreeMerge
+        Revision::copyProperties(this->rootRevision, revision);
+    }
+
+    return true;
+}
+
+void VersionControl::moveToRemoteHead(const String &headRevisionId,
+    const String &remoteHistoryId, int64 remoteVersion)
+{
+    this->historyMergeVersion = remoteVersion;
+
+    if (remoteHistoryId.isNotEmpty())
+    {
+        this->publicId = remoteHistoryId;
+    }
+
+    const ValueTree newHeadRevision(this->getRevisionById(this->rootRevision, headRevisionId));
+    if (Revision::getUuid(newHeadRevision) == headRevisionId)
+    {
+        this->head.moveTo(newHeadRevision);
+    }
+
+    this->pack->flush();
+    this->sendChangeMessage();
+}
+
 void VersionControl::recursiveTreeMerge(ValueTree localRevision,
     ValueTree remoteRevision)
 {
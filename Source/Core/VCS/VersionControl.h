@@ -75,6 +75,14 @@ public:
     MD5 calculateHash() const;
     void mergeWith(VersionControl &remoteHistory);
 
+    // Delta sync: only the revisions missing on the other side
+    // are transferred, each as a bundle with its own delta data
+    StringArray getRevisionIds() const;
+    ValueTree createRevisionBundle(const String &revisionId) const;
+    bool importRevisionBundle(const ValueTree &bundle);
+    void moveToRemoteHead(const String &headRevisionId,
+        const String &remoteHistoryId, int64 remoteVersion);
+
     //===------------------------------------------------------------------===//
     // VCS
     //===------------------------------------------------------------------===//
@@ -117,6 +125,7 @@ public:
 protected:
 
     StringArray recursiveGetHashes(const ValueTree revision) const;
+    void recursiveGetIds(const ValueTree revision, StringArray &ids) const;
     void recursiveTreeMerge(ValueTree localRevision, ValueTree remoteRevision);
     ValueTree getRevisionById(const ValueTree startFrom, const String &id) const;
 
@@ -26,6 +26,7 @@
 #define GENERIC_METER_PEAK_FADE_MS 1300.f
 #define GENERIC_METER_PEAK_MAX_ALPHA 0.35f
 #define GENERIC_METER_SHOWS_VOLUME_PEAKS 1
+#define GENERIC_METER_UPDATE_MS 35.f
 
 static const float kSpectrumFrequencies[] =
 {
@@ -38,9 +39,8 @@ static const float kSpectrumFrequencies[] =
 };
 
 GenericAudioMonitorComponent::GenericAudioMonitorComponent(WeakReference<AudioMonitor> monitor)
-    : Thread("Spectrum Component"),
-      audioMonitor(std::move(monitor)),
-      skewTime(0)
+    : audioMonitor(std::move(monitor)),
+      timeSinceUpdateMs(0.f)
 {
     // (true, false) will enable switching rendering modes on click
     this->setInterceptsMouseClicks(false, false);
@@ -56,7 +56,7 @@ GenericAudioMonitorComponent::GenericAudioMonitorComponent(WeakReference<AudioMo
 
     if (this->audioMonitor != nullptr)
     {
-        this->startThread(5);
+        this->startReceivingFrames();
     }
 }
 
@@ -65,37 +65,33 @@ void GenericAudioMonitorComponent::setTargetAnalyzer(WeakReference<AudioMonitor>
     if (monitor != nullptr)
     {
         this->audioMonitor = monitor;
-        this->startThread(5);
+        this->startReceivingFrames();
     }
 }
 
 GenericAudioMonitorComponent::~GenericAudioMonitorComponent()
-{ 
-    this->stopThread(1000);
+{
+    this->stopReceivingFrames();
 }
 
-void GenericAudioMonitorComponent::run()
+void GenericAudioMonitorComponent::onFrame(float deltaMs)
 {
-    while (! this->threadShouldExit())
+    this->timeSinceUpdateMs += deltaMs;
+    if (this->timeSinceUpdateMs < GENERIC_METER_UPDATE_MS ||
+        this->audioMonitor == nullptr)
     {
-        Thread::sleep(jlimit(10, 100, 35 - this->skewTime));
-        const double b = Time::getMillisecondCounterHiRes();
+        return;
+    }
 
-        for (int i = 0; i < GENERIC_METER_NUM_BANDS; ++i)
-        {
-            this->lPeak = this->audioMonitor->getPeak(0);
-            this->rPeak = this->audioMonitor->getPeak(1);
-            this->values[i] = this->audioMonitor->getInterpolatedSpectrumAtFrequency(kSpectrumFrequencies[i]);
-        }
+    this->timeSinceUpdateMs = 0.f;
+    this->lPeak = this->audioMonitor->getPeak(0);
+    this->rPeak = this->audioMonitor->getPeak(1);
 
-        this->triggerAsyncUpdate();
-        const double a = Time::getMillisecondCounterHiRes();
-        this->skewTime = int(a - b);
+    for (int i = 0; i < GENERIC_METER_NUM_BANDS; ++i)
+    {
+        this->values[i] = this->audioMonitor->getInterpolatedSpectrumAtFrequency(kSpectrumFrequencies[i]);
     }
-}
 
-void GenericAudioMonitorComponent::handleAsyncUpdate()
-{
     this->repaint();
 }
 
@@ -18,10 +18,11 @@
 #pragma once
 
 #include "AudioMonitor.h"
+#include "FrameClock.h"
 
 #define GENERIC_METER_NUM_BANDS 10
 
-class GenericAudioMonitorComponent : public Component, private Thread, private AsyncUpdater
+class GenericAudioMonitorComponent : public Component, private FrameClock::Listener
 {
 public:
 
@@ -57,8 +58,7 @@ private:
     
 private:
     
-    void run() override;
-    void handleAsyncUpdate() override;
+    void onFrame(float deltaMs) override;
     
     WeakReference<AudioMonitor> audioMonitor;
     OwnedArray<SpectrumBand> bands;
@@ -70,7 +70,7 @@ private:
     Atomic<float> lPeak;
     Atomic<float> rPeak;
 
-    int skewTime;
+    float timeSinceUpdateMs;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GenericAudioMonitorComponent);
 };
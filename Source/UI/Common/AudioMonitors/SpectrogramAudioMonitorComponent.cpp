@@ -22,6 +22,7 @@
 
 #define SPECTROGRAM_METER_MAXDB (+4.0f)
 #define SPECTROGRAM_METER_MINDB (-70.0f)
+#define SPECTROGRAM_UPDATE_MS 35.f
 
 static const float kSpectrumFrequencies[] =
 {
@@ -37,23 +38,22 @@ static const float kSpectrumFrequencies[] =
 };
 
 SpectrogramAudioMonitorComponent::SpectrogramAudioMonitorComponent(WeakReference<AudioMonitor> targetAnalyzer) :
-    Thread("Volume Component"),
     audioMonitor(std::move(targetAnalyzer)),
     head(0),
-    skewTime(0)
+    timeSinceUpdateMs(0.f)
 {
     this->setInterceptsMouseClicks(false, false);
     this->setPaintingIsUnclipped(true);
 
     if (this->audioMonitor != nullptr)
     {
-        this->startThread(6);
+        this->startReceivingFrames();
     }
 }
 
 SpectrogramAudioMonitorComponent::~SpectrogramAudioMonitorComponent()
 {
-    this->stopThread(1000);
+    this->stopReceivingFrames();
 }
 
 void SpectrogramAudioMonitorComponent::setTargetAnalyzer(WeakReference<AudioMonitor> targetAnalyzer)
@@ -61,35 +61,31 @@ void SpectrogramAudioMonitorComponent::setTargetAnalyzer(WeakReference<AudioMoni
     if (targetAnalyzer != nullptr)
     {
         this->audioMonitor = targetAnalyzer;
-        this->startThread(6);
+        this->startReceivingFrames();
     }
 }
 
-void SpectrogramAudioMonitorComponent::run()
+void SpectrogramAudioMonitorComponent::onFrame(float deltaMs)
 {
-    while (! this->threadShouldExit())
+    this->timeSinceUpdateMs += deltaMs;
+    if (this->timeSinceUpdateMs < SPECTROGRAM_UPDATE_MS ||
+        this->audioMonitor == nullptr)
     {
-        Thread::sleep(jlimit(10, 100, 35 - this->skewTime));
-        const double b = Time::getMillisecondCounterHiRes();
+        return;
+    }
 
-        // Move to the next row:
-        this->head = (this->head.get() + 1) % SPECTROGRAM_BUFFER_SIZE;
+    this->timeSinceUpdateMs = 0.f;
 
-        // Update matrix:
-        for (int i = 0; i < SPECTROGRAM_NUM_BANDS; ++i)
-        {
-            this->spectrum[this->head.get()][i] =
-                this->audioMonitor->getInterpolatedSpectrumAtFrequency(kSpectrumFrequencies[i]);
-        }
+    // Move to the next row:
+    this->head = (this->head.get() + 1) % SPECTROGRAM_BUFFER_SIZE;
 
-        this->triggerAsyncUpdate();
-        const double a = Time::getMillisecondCounterHiRes();
-        this->skewTime = int(a - b);
+    // Update matrix:
+    for (int i = 0; i < SPECTROGRAM_NUM_BANDS; ++i)
+    {
+        this->spectrum[this->head.get()][i] =
+            this->audioMonitor->getInterpolatedSpectrumAtFrequency(kSpectrumFrequencies[i]);
     }
-}
 
-void SpectrogramAudioMonitorComponent::handleAsyncUpdate()
-{
     this->repaint();
 }
 
@@ -20,12 +20,13 @@
 class AudioMonitor;
 
 #include "NavigationSidebar.h"
+#include "FrameClock.h"
 
 #define SPECTROGRAM_BUFFER_SIZE (NAVIGATION_SIDEBAR_WIDTH / 2)
 #define SPECTROGRAM_NUM_BANDS (NAVIGATION_SIDEBAR_WIDTH / 2)
 
 class SpectrogramAudioMonitorComponent :
-    public Component, private Thread, private AsyncUpdater
+    public Component, private FrameClock::Listener
 {
 public:
 
@@ -42,8 +43,7 @@ public:
 
 private:
 
-    void run() override;
-    void handleAsyncUpdate() override;
+    void onFrame(float deltaMs) override;
     
     WeakReference<AudioMonitor> audioMonitor;
     
@@ -51,7 +51,7 @@ private:
     Atomic<float> spectrum[SPECTROGRAM_BUFFER_SIZE][SPECTROGRAM_NUM_BANDS];
 
     Atomic<int> head;
-    int skewTime;
+    float timeSinceUpdateMs;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrogramAudioMonitorComponent)
 
@@ -23,24 +23,24 @@
 #define WAVEFORM_METER_MAXDB (+4.0f)
 // -69 instead of -70 to have that nearly invisible horizontal line
 #define WAVEFORM_METER_MINDB (-69.0f)
+#define WAVEFORM_METER_UPDATE_MS 35.f
 
 WaveformAudioMonitorComponent::WaveformAudioMonitorComponent(WeakReference<AudioMonitor> targetAnalyzer) :
-    Thread("Volume Component"),
     audioMonitor(std::move(targetAnalyzer)),
-    skewTime(0)
+    timeSinceUpdateMs(0.f)
 {
     this->setInterceptsMouseClicks(false, false);
     this->setPaintingIsUnclipped(true);
 
     if (this->audioMonitor != nullptr)
     {
-        this->startThread(6);
+        this->startReceivingFrames();
     }
 }
 
 WaveformAudioMonitorComponent::~WaveformAudioMonitorComponent()
 {
-    this->stopThread(1000);
+    this->stopReceivingFrames();
 }
 
 void WaveformAudioMonitorComponent::setTargetAnalyzer(WeakReference<AudioMonitor> targetAnalyzer)
@@ -48,43 +48,38 @@ void WaveformAudioMonitorComponent::setTargetAnalyzer(WeakReference<AudioMonitor
     if (targetAnalyzer != nullptr)
     {
         this->audioMonitor = targetAnalyzer;
-        this->startThread(6);
+        this->startReceivingFrames();
     }
 }
 
-void WaveformAudioMonitorComponent::run()
+void WaveformAudioMonitorComponent::onFrame(float deltaMs)
 {
-    while (! this->threadShouldExit())
+    this->timeSinceUpdateMs += deltaMs;
+    if (this->timeSinceUpdateMs < WAVEFORM_METER_UPDATE_MS ||
+        this->audioMonitor == nullptr)
     {
-        Thread::sleep(jlimit(10, 100, 35 - this->skewTime));
-        const double b = Time::getMillisecondCounterHiRes();
-
-        // Shift buffers:
-        for (int i = 0; i < WAVEFORM_METER_BUFFER_SIZE - 1; ++i)
-        {
-            this->lPeakBuffer[i] = this->lPeakBuffer[i + 1].get();
-            this->rPeakBuffer[i] = this->rPeakBuffer[i + 1].get();
-            this->lRmsBuffer[i] = this->lRmsBuffer[i + 1].get();
-            this->rRmsBuffer[i] = this->rRmsBuffer[i + 1].get();
-        }
-
-        const int i = WAVEFORM_METER_BUFFER_SIZE - 1;
-
-        // Push next values:
-        this->lPeakBuffer[i] = this->audioMonitor->getPeak(0);
-        this->rPeakBuffer[i] = this->audioMonitor->getPeak(1);
-        this->lRmsBuffer[i] = this->audioMonitor->getRootMeanSquare(0);
-        this->rRmsBuffer[i] = this->audioMonitor->getRootMeanSquare(1);
-
-        this->triggerAsyncUpdate();
-
-        const double a = Time::getMillisecondCounterHiRes();
-        this->skewTime = int(a - b);
+        return;
     }
-}
 
-void WaveformAudioMonitorComponent::handleAsyncUpdate()
-{
+    this->timeSinceUpdateMs = 0.f;
+
+    // Shift buffers:
+    for (int i = 0; i < WAVEFORM_METER_BUFFER_SIZE - 1; ++i)
+    {
+        this->lPeakBuffer[i] = this->lPeakBuffer[i + 1].get();
+        this->rPeakBuffer[i] = this->rPeakBuffer[i + 1].get();
+        this->lRmsBuffer[i] = this->lRmsBuffer[i + 1].get();
+        this->rRmsBuffer[i] = this->rRmsBuffer[i + 1].get();
+    }
+
+    const int i = WAVEFORM_METER_BUFFER_SIZE - 1;
+
+    // Push next values:
+    this->lPeakBuffer[i] = this->audioMonitor->getPeak(0);
+    this->rPeakBuffer[i] = this->audioMonitor->getPeak(1);
+    this->lRmsBuffer[i] = this->audioMonitor->getRootMeanSquare(0);
+    this->rRmsBuffer[i] = this->audioMonitor->getRootMeanSquare(1);
+
     this->repaint();
 }
 
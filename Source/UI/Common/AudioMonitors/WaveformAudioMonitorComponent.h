@@ -20,12 +20,13 @@
 class AudioMonitor;
 
 #include "NavigationSidebar.h"
+#include "FrameClock.h"
 
 // Set this depending on component width (or sidebar width):
 #define WAVEFORM_METER_BUFFER_SIZE (NAVIGATION_SIDEBAR_WIDTH / 2)
 
 class WaveformAudioMonitorComponent :
-    public Component, private Thread, private AsyncUpdater
+    public Component, private FrameClock::Listener
 {
 public:
 
@@ -42,8 +43,7 @@ public:
 
 private:
 
-    void run() override;
-    void handleAsyncUpdate() override;
+    void onFrame(float deltaMs) override;
     
     WeakReference<AudioMonitor> audioMonitor;
     
@@ -53,7 +53,7 @@ private:
     Atomic<float> lRmsBuffer[WAVEFORM_METER_BUFFER_SIZE];
     Atomic<float> rRmsBuffer[WAVEFORM_METER_BUFFER_SIZE];
 
-    int skewTime;
+    float timeSinceUpdateMs;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformAudioMonitorComponent)
 
@@ -325,6 +325,8 @@ int CommandIDs::getIdForName(const String &command)
         return TweakVolumeRandom;
     case Hash("TweakVolumeFadeOut"):
         return TweakVolumeFadeOut;
+    case Hash("SelectOutOfScaleEvents"):
+        return SelectOutOfScaleEvents;
     default:
         return 0;
     };
@@ -64,6 +64,10 @@ namespace CommandIDs
         ScanPluginsFolder               = 0x0505,
         CreateInstrument                = 0x0506, // more ids reserved for instruments
 
+        // InstrumentCommandPanel
+        SelectInstrumentMidiInput       = 0x0600,
+        ToggleInstrumentMidiInput       = 0x0601, // more ids reserved for devices
+
         // LayerCommandPanel
         DeleteLayer                     = 0x1000,
         MuteLayer                       = 0x1001,
@@ -219,7 +223,12 @@ namespace CommandIDs
         TweakVolumeRandom               = 0x405e,
         TweakVolumeFadeOut              = 0x405f,
 
-        YourNextCommandId               = 0x4060
+        FreezeLayer                     = 0x4060,
+        UnfreezeLayer                   = 0x4061,
+
+        SelectOutOfScaleEvents          = 0x4062,
+
+        YourNextCommandId               = 0x4063
     };
 
     int getIdForName(const String &command);
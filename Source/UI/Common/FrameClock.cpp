@@ -0,0 +1,98 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "FrameClock.h"
+
+// Don't let the animations jump too far after a stall
+#define FRAME_CLOCK_MAX_DELTA_MS 100.f
+
+FrameClock::FrameClock() :
+    lastFrameTimeMs(0.0) {}
+
+FrameClock::~FrameClock()
+{
+    jassert(this->listeners.isEmpty());
+    this->stopTimer();
+}
+
+void FrameClock::subscribe(Listener *listener)
+{
+    if (this->listeners.isEmpty())
+    {
+        this->lastFrameTimeMs = Time::getMillisecondCounterHiRes();
+        this->startTimerHz(FRAME_CLOCK_RATE_HZ);
+    }
+
+    this->listeners.add(listener);
+}
+
+void FrameClock::unsubscribe(Listener *listener)
+{
+    this->listeners.remove(listener);
+
+    if (this->listeners.isEmpty())
+    {
+        this->stopTimer();
+    }
+}
+
+void FrameClock::timerCallback()
+{
+    // A listener might delete the last of the others, and the clock with it
+    const SharedResourcePointer<FrameClock> keepAlive;
+
+    const double timeNowMs = Time::getMillisecondCounterHiRes();
+    const float deltaMs = jmin(FRAME_CLOCK_MAX_DELTA_MS, float(timeNowMs - this->lastFrameTimeMs));
+    this->lastFrameTimeMs = timeNowMs;
+    this->listeners.call(&Listener::onFrame, deltaMs);
+}
+
+//===----------------------------------------------------------------------===//
+// Listener
+//===----------------------------------------------------------------------===//
+
+FrameClock::Listener::Listener() :
+    isSubscribed(false) {}
+
+FrameClock::Listener::~Listener()
+{
+    this->stopReceivingFrames();
+}
+
+void FrameClock::Listener::startReceivingFrames()
+{
+    if (!this->isSubscribed)
+    {
+        this->isSubscribed = true;
+        this->clock->subscribe(this);
+    }
+}
+
+void FrameClock::Listener::stopReceivingFrames()
+{
+    if (this->isSubscribed)
+    {
+        this->isSubscribed = false;
+        this->clock->unsubscribe(this);
+    }
+}
+
+bool FrameClock::Listener::isReceivingFrames() const noexcept
+{
+    return this->isSubscribed;
+}
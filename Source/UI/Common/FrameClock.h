@@ -0,0 +1,68 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define FRAME_CLOCK_RATE_HZ 60
+
+// A single timer driving all UI animations, so that they are updated
+// together within one wakeup per frame instead of each running its own timer.
+// It only ticks while someone is subscribed.
+class FrameClock final : private Timer
+{
+public:
+
+    FrameClock();
+    ~FrameClock() override;
+
+    class Listener
+    {
+    public:
+
+        Listener();
+        virtual ~Listener();
+
+        // Called on the message thread on every frame while subscribed,
+        // with the time passed since the previous frame
+        virtual void onFrame(float deltaMs) = 0;
+
+    protected:
+
+        void startReceivingFrames();
+        void stopReceivingFrames();
+        bool isReceivingFrames() const noexcept;
+
+    private:
+
+        SharedResourcePointer<FrameClock> clock;
+        bool isSubscribed;
+
+        JUCE_DECLARE_NON_COPYABLE(Listener)
+    };
+
+private:
+
+    void subscribe(Listener *listener);
+    void unsubscribe(Listener *listener);
+
+    void timerCallback() override;
+
+    ListenerList<Listener> listeners;
+    double lastFrameTimeMs;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameClock)
+};
@@ -27,11 +27,11 @@
 #define PEAK_FADE_MS 2500.f
 #define NUM_BANDS 70
 #define NUM_SEGMENTS_TO_SKIP 8
+#define PULSE_UPDATE_MS 35.f
 
 SpectralLogo::SpectralLogo()
-    : Thread("Spectral Logo"),
-      bandCount(NUM_BANDS),
-      skewTime(0),
+    : bandCount(NUM_BANDS),
+      timeSinceUpdateMs(0.f),
       pulse(0.f),
       randomnessRange(0),
       lineThickness(0),
@@ -43,28 +43,23 @@ SpectralLogo::SpectralLogo()
         this->bands.add(new SpectralLogo::Band(this));
     }
     
-    this->startThread(5);
+    this->startReceivingFrames();
 }
 
 SpectralLogo::~SpectralLogo()
 { 
-    this->stopThread(1000);
+    this->stopReceivingFrames();
 }
 
-void SpectralLogo::run()
+void SpectralLogo::onFrame(float deltaMs)
 {
-    while (! this->threadShouldExit())
+    this->timeSinceUpdateMs += deltaMs;
+    if (this->timeSinceUpdateMs < PULSE_UPDATE_MS)
     {
-        Thread::sleep(jlimit(10, 100, 35 - this->skewTime));
-        const double b = Time::getMillisecondCounterHiRes();
-        this->triggerAsyncUpdate();
-        const double a = Time::getMillisecondCounterHiRes();
-        this->skewTime = int(a - b);
+        return;
     }
-}
 
-void SpectralLogo::handleAsyncUpdate()
-{
+    this->timeSinceUpdateMs = 0.f;
     this->pulse = fmodf(this->pulse + MathConstants<float>::pi / 18.f, MathConstants<float>::twoPi);
     this->repaint();
 }
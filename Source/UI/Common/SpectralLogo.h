@@ -17,7 +17,9 @@
 
 #pragma once
 
-class SpectralLogo : public Component, private Thread, private AsyncUpdater
+#include "FrameClock.h"
+
+class SpectralLogo : public Component, private FrameClock::Listener
 {
 public:
 
@@ -63,14 +65,13 @@ private:
     
 private:
     
-    void run() override;
-    void handleAsyncUpdate() override;
+    void onFrame(float deltaMs) override;
     
     OwnedArray<SpectralLogo::Band> bands;
     Path wave;
     
     int bandCount;
-    int skewTime;
+    float timeSinceUpdateMs;
     
     float pulse;
     
@@ -18,18 +18,20 @@
 #pragma once
 
 #include "SmoothZoomListener.h"
+#include "FrameClock.h"
 
-#define SMOOTH_ZOOM_TIMER_DELAY_MS 8
+#define SMOOTH_ZOOM_TIMER_DELAY_MS 10
 #define ZOOM_STOP_FACTOR 0.001f
 #define ZOOM_DECAY_FACTOR 0.77f
 #define ZOOM_INITIAL_SPEED 0.55f
 
-class SmoothZoomController : private Thread, private WaitableEvent, private AsyncUpdater
+// The decay and speed factors were tuned for one zoom step per timerDelay,
+// so every frame applies as many steps as fit into its delta time
+class SmoothZoomController final : private FrameClock::Listener
 {
 public:
 
     explicit SmoothZoomController(SmoothZoomListener &parent) :
-        Thread("SmoothZoomController"),
         listener(parent),
         factorX(0.f),
         factorY(0.f),
@@ -38,16 +40,11 @@ public:
         timerDelay(SMOOTH_ZOOM_TIMER_DELAY_MS),
         zoomStopFactor(ZOOM_STOP_FACTOR),
         zoomDecayFactor(ZOOM_DECAY_FACTOR),
-        initialZoomSpeed(ZOOM_INITIAL_SPEED)
-    {
-        this->startThread(5);
-    }
+        initialZoomSpeed(ZOOM_INITIAL_SPEED) {}
 
     ~SmoothZoomController() override
     {
-        this->signalThreadShouldExit();
-        this->signal();
-        this->stopThread(500);
+        this->stopReceivingFrames();
     }
 
     inline int getTimerDelay() const noexcept { return timerDelay; }
@@ -57,13 +54,14 @@ public:
 
     bool isZooming() const
     {
-        return fabs(this->factorX.get()) > 0.f;
+        return fabs(this->factorX) > 0.f;
     }
 
     void cancelZoom()
     {
         this->factorX = 0.f;
         this->factorY = 0.f;
+        this->stopReceivingFrames();
     }
 
     void zoomRelative(const Point<float> &from, const Point<float> &zoom)
@@ -77,61 +75,45 @@ public:
         }
         else
         {
-            this->factorX = (this->factorX.get() + zoom.getX()) / 2.f;
-            this->factorY = (this->factorY.get() + zoom.getY()) / 2.f;
-            this->originX = (this->originX.get() + from.getX()) / 2.f;
-            this->originY = (this->originY.get() + from.getY()) / 2.f;
+            this->factorX = (this->factorX + zoom.getX()) / 2.f;
+            this->factorY = (this->factorY + zoom.getY()) / 2.f;
+            this->originX = (this->originX + from.getX()) / 2.f;
+            this->originY = (this->originY + from.getY()) / 2.f;
         }
 
-        WaitableEvent::signal();
+        this->startReceivingFrames();
     }
 
 private:
 
     inline bool stillNeedsZoom() const
     {
-        return juce_hypot(this->factorX.get(), this->factorY.get()) >= this->zoomStopFactor;
+        return juce_hypot(this->factorX, this->factorY) >= this->zoomStopFactor;
     }
 
-    void run() override
+    void onFrame(float deltaMs) override
     {
-        while (! this->threadShouldExit())
+        if (! this->stillNeedsZoom())
         {
-            while (this->stillNeedsZoom())
-            {
-                const double b = Time::getMillisecondCounterHiRes();
-                this->factorX = this->factorX.get() * this->zoomDecayFactor;
-                this->factorY = this->factorY.get() * this->zoomDecayFactor;
-
-                this->triggerAsyncUpdate();
-                
-                if (this->threadShouldExit())
-                {
-                    return;
-                }
-
-                const double a = Time::getMillisecondCounterHiRes();
-                const int skewTime = int(a - b);
-                Thread::sleep(jlimit(10, 100, this->timerDelay - skewTime));
-            }
-
             this->cancelZoom();
-            WaitableEvent::wait();
+            return;
         }
-    }
 
-    void handleAsyncUpdate() override
-    {
-        this->listener.zoomRelative({ this->originX.get(), this->originY.get() },
-            { this->factorX.get(), this->factorY.get() });
+        const float numSteps = deltaMs / float(this->timerDelay);
+        const float decay = powf(this->zoomDecayFactor, numSteps);
+        this->factorX *= decay;
+        this->factorY *= decay;
+
+        this->listener.zoomRelative({ this->originX, this->originY },
+            { this->factorX * numSteps, this->factorY * numSteps });
     }
 
     SmoothZoomListener &listener;
 
-    Atomic<float> factorX;
-    Atomic<float> factorY;
-    Atomic<float> originX;
-    Atomic<float> originY;
+    float factorX;
+    float factorY;
+    float originX;
+    float originY;
 
 private:
 
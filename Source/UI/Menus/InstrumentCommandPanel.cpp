@@ -22,15 +22,23 @@
 #include "CommandIDs.h"
 #include "App.h"
 #include "MainLayout.h"
+#include "Workspace.h"
+#include "AudioCore.h"
+#include "MidiInputRouter.h"
 
 InstrumentCommandPanel::InstrumentCommandPanel(InstrumentTreeItem &parentInstrument) :
     instrument(parentInstrument)
 {
-    CommandPanel::Items cmds;
-    //cmds.add(CommandItem::withParams(Icons::reset, CommandIDs::UpdateInstrument, TRANS("menu::instrument::update")));
-    //cmds.add(CommandItem::withParams(Icons::ellipsis, CommandIDs::RenameInstrument, TRANS("menu::instrument::rename")));
-    cmds.add(CommandItem::withParams(Icons::trash, CommandIDs::DeleteInstrument, TRANS("menu::instrument::delete")));
-    this->updateContent(cmds);
+    auto &device = App::Workspace().getAudioCore().getDevice();
+    for (const auto &midiInputName : MidiInput::getDevices())
+    {
+        if (device.isMidiInputEnabled(midiInputName))
+        {
+            this->midiInputs.add(midiInputName);
+        }
+    }
+
+    this->initDefaultCommands();
 }
 
 InstrumentCommandPanel::~InstrumentCommandPanel()
@@ -52,7 +60,70 @@ void InstrumentCommandPanel::handleCommandMessage(int commandId)
         case CommandIDs::DeleteInstrument:
             TreeItem::deleteItem(&this->instrument);
             break;
+
+        case CommandIDs::SelectInstrumentMidiInput:
+            this->initMidiInputSelection();
+            return;
+
+        case CommandIDs::Back:
+            this->initDefaultCommands();
+            return;
+    }
+
+    const int deviceIndex = commandId - CommandIDs::ToggleInstrumentMidiInput;
+    if (deviceIndex >= 0 && deviceIndex < this->midiInputs.size())
+    {
+        // the device is routed to the instrument on all channels
+        const String &deviceName = this->midiInputs[deviceIndex];
+        auto &router = App::Workspace().getAudioCore().getMidiInputRouter();
+        if (Instrument *target = this->instrument.getInstrument())
+        {
+            if (router.hasRule(deviceName, 0, target))
+            {
+                router.removeRule(deviceName, 0, target);
+            }
+            else
+            {
+                router.addRule(deviceName, 0, target);
+            }
+        }
+
+        this->initMidiInputSelection();
+        return;
     }
 
     this->getParentComponent()->exitModalState(0);
 }
+
+void InstrumentCommandPanel::initDefaultCommands()
+{
+    CommandPanel::Items cmds;
+    //cmds.add(CommandItem::withParams(Icons::reset, CommandIDs::UpdateInstrument, TRANS("menu::instrument::update")));
+    //cmds.add(CommandItem::withParams(Icons::ellipsis, CommandIDs::RenameInstrument, TRANS("menu::instrument::rename")));
+
+    if (!this->midiInputs.isEmpty())
+    {
+        cmds.add(CommandItem::withParams(Icons::switcher, CommandIDs::SelectInstrumentMidiInput, TRANS("menu::instrument::midiinput"))->withSubmenu());
+    }
+
+    cmds.add(CommandItem::withParams(Icons::trash, CommandIDs::DeleteInstrument, TRANS("menu::instrument::delete")));
+    this->updateContent(cmds, CommandPanel::SlideRight);
+}
+
+void InstrumentCommandPanel::initMidiInputSelection()
+{
+    CommandPanel::Items cmds;
+    cmds.add(CommandItem::withParams(Icons::left, CommandIDs::Back, TRANS("menu::back"))->withTimer());
+
+    const auto &router = App::Workspace().getAudioCore().getMidiInputRouter();
+    const Instrument *target = this->instrument.getInstrument();
+
+    for (int i = 0; i < this->midiInputs.size(); ++i)
+    {
+        const bool isRouted = router.hasRule(this->midiInputs[i], 0, target);
+        cmds.add(CommandItem::withParams(isRouted ? Icons::toggleOn : Icons::toggleOff,
+            CommandIDs::ToggleInstrumentMidiInput + i, this->midiInputs[i]));
+    }
+
+    this->updateContent(cmds, CommandPanel::SlideLeft);
+}
@@ -32,7 +32,13 @@ public:
     void handleCommandMessage(int commandId) override;
     
 private:
-    
+
+    void initDefaultCommands();
+    void initMidiInputSelection();
+
     InstrumentTreeItem &instrument;
+
+    // the enabled midi input devices
+    StringArray midiInputs;
     
 };
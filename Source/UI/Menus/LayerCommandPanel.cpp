@@ -27,6 +27,8 @@
 #include "Instrument.h"
 #include "MidiSequence.h"
 #include "HybridRoll.h"
+#include "PianoRoll.h"
+#include "NotesQuery.h"
 #include "ProjectTreeItem.h"
 #include "ModalDialogInput.h"
 
@@ -38,6 +40,7 @@
 #include "AutomationTrackActions.h"
 #include "UndoStack.h"
 #include "NavigationSidebar.h"
+#include "Transport.h"
 #include "Workspace.h"
 #include "App.h"
 
@@ -76,6 +79,20 @@ void LayerCommandPanel::handleCommandMessage(int commandId)
             this->exit();
             break;
 
+        case CommandIDs::SelectOutOfScaleEvents:
+
+            if (ProjectTreeItem *project = this->layerItem.getProject())
+            {
+                if (PianoRoll *roll = dynamic_cast<PianoRoll *>(project->getLastFocusedRoll()))
+                {
+                    const Array<MidiSequence *> sequences(this->layerItem.getSequence());
+                    roll->selectEvents(NotesQuery(*project).withinTracks(sequences).outOfScale(), true);
+                }
+            }
+
+            this->exit();
+            break;
+
         case CommandIDs::SelectLayerColour:
             this->initColorSelection();
         break;
@@ -100,6 +117,16 @@ void LayerCommandPanel::handleCommandMessage(int commandId)
         }
             break;
 
+        case CommandIDs::FreezeLayer:
+            this->layerItem.getProject()->getTransport().freezeTrack(&this->layerItem);
+            this->exit();
+            break;
+
+        case CommandIDs::UnfreezeLayer:
+            this->layerItem.getProject()->getTransport().unfreezeTrack(&this->layerItem);
+            this->exit();
+            break;
+
         case CommandIDs::SelectLayerInstrument:
             this->initInstrumentSelection();
             break;
@@ -200,6 +227,12 @@ void LayerCommandPanel::initDefaultCommands()
 {
     CommandPanel::Items cmds;
     cmds.add(CommandItem::withParams(Icons::paste, CommandIDs::SelectAllEvents, TRANS("menu::layer::selectall")));
+
+    if (dynamic_cast<PianoTrackTreeItem *>(&this->layerItem) != nullptr)
+    {
+        cmds.add(CommandItem::withParams(Icons::paste, CommandIDs::SelectOutOfScaleEvents, TRANS("menu::layer::selectoutofscale")));
+    }
+
     cmds.add(CommandItem::withParams(Icons::colour, CommandIDs::SelectLayerColour, TRANS("menu::layer::change::colour"))->withSubmenu());
     
     const Array<Instrument *> &info = App::Workspace().getAudioCore().getInstruments();
@@ -235,6 +268,16 @@ void LayerCommandPanel::initDefaultCommands()
         {
             cmds.add(CommandItem::withParams(Icons::volumeOff, CommandIDs::MuteLayer, TRANS("menu::layer::mute")));
         }
+
+        const Transport &transport = this->layerItem.getProject()->getTransport();
+        if (transport.isTrackFrozen(&this->layerItem))
+        {
+            cmds.add(CommandItem::withParams(Icons::render, CommandIDs::UnfreezeLayer, TRANS("menu::layer::unfreeze")));
+        }
+        else
+        {
+            cmds.add(CommandItem::withParams(Icons::render, CommandIDs::FreezeLayer, TRANS("menu::layer::freeze")));
+        }
     }
     
     cmds.add(CommandItem::withParams(Icons::trash, CommandIDs::DeleteLayer, TRANS("menu::layer::delete")));
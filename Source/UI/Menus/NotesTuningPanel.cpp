@@ -95,9 +95,9 @@ private:
         {
             if (NoteComponent *nc = dynamic_cast<NoteComponent *>(i))
             {
-                const float xAbsPosition = (nc->getNote().getBeat() - startBeat) / (endBeat - startBeat);
+                const float xAbsPosition = (nc->getBeat() - startBeat) / (endBeat - startBeat);
                 const int x = this->proportionOfWidth(xAbsPosition);
-                const int y = this->proportionOfHeight(1.f - nc->getNote().getVelocity());
+                const int y = this->proportionOfHeight(1.f - nc->getVelocity());
 
                 //Logger::writeToLog(String(x) + " : " + String(y));
                 //this->path.quadraticTo(x, y, x, y);
@@ -300,6 +300,12 @@ void NotesTuningPanel::sliderValueChanged (Slider* sliderThatWasMoved)
     }
 
     //[UsersliderValueChanged_Post]
+    // dragging only previews the changes until the drag is ended,
+    // but the other changes (like the keyboard ones) are applied at once
+    if (! sliderThatWasMoved->isMouseButtonDown())
+    {
+        PianoRollToolbox::applyPreviews(this->roll.getLassoSelection());
+    }
     //[/UsersliderValueChanged_Post]
 }
 
@@ -0,0 +1,180 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "PerformanceSettings.h"
+#include "AudioCore.h"
+#include "AudioMonitor.h"
+#include "AudioLoadStats.h"
+#include "PerformanceTrace.h"
+#include "DocumentHelpers.h"
+
+#define PERFORMANCE_STATUS_UPDATE_MS 500
+
+static String formatLoad(const AudioLoadStats &stats)
+{
+    return String(roundToInt(stats.getAverageLoad() * 100.f)) + "% (peak " +
+        String(roundToInt(stats.getPeakLoad() * 100.f)) + "%), overruns: " +
+        String(stats.getNumOverruns()) + " of " + String(stats.getNumMeasurements());
+}
+
+static String formatHistogram(const AudioLoadStats &stats)
+{
+    String result;
+    for (int i = 0; i < AUDIO_LOAD_HISTOGRAM_SIZE; ++i)
+    {
+        if (const int value = stats.getHistogramValue(i))
+        {
+            result << AudioLoadStats::getHistogramBucketName(i) << ": " << value << "  ";
+        }
+    }
+
+    return result.trimEnd();
+}
+
+PerformanceSettings::PerformanceSettings(AudioCore &core) :
+    audioCore(core)
+{
+    this->statusText = new TextEditor();
+    this->statusText->setMultiLine(true);
+    this->statusText->setReadOnly(true);
+    this->statusText->setScrollbarsShown(true);
+    this->statusText->setCaretVisible(false);
+    this->statusText->setPopupMenuEnabled(true);
+    this->statusText->setWantsKeyboardFocus(false);
+    this->statusText->setColour(TextEditor::textColourId, Colours::white);
+    this->statusText->setColour(TextEditor::backgroundColourId, Colour(0xa9000000));
+    this->statusText->setFont(Font(Font::getDefaultMonospacedFontName(), 14.f, Font::plain));
+    this->addAndMakeVisible(this->statusText);
+
+    this->traceButton = new TextButton();
+    this->traceButton->addListener(this);
+    this->addAndMakeVisible(this->traceButton);
+
+    this->saveTraceButton = new TextButton(TRANS("settings::performance::trace::save"));
+    this->saveTraceButton->addListener(this);
+    this->addAndMakeVisible(this->saveTraceButton);
+
+    this->updateTraceButton();
+    this->setSize(550, 260);
+}
+
+PerformanceSettings::~PerformanceSettings()
+{
+    this->stopTimer();
+}
+
+void PerformanceSettings::resized()
+{
+    const int buttonWidth = (this->getWidth() - 40) / 2;
+    this->statusText->setBounds(16, 12, this->getWidth() - 32, this->getHeight() - 68);
+    this->traceButton->setBounds(16, this->getHeight() - 48, buttonWidth, 36);
+    this->saveTraceButton->setBounds(24 + buttonWidth, this->getHeight() - 48, buttonWidth, 36);
+}
+
+void PerformanceSettings::visibilityChanged()
+{
+    if (this->isVisible())
+    {
+        this->updateStatus();
+        this->startTimer(PERFORMANCE_STATUS_UPDATE_MS);
+    }
+    else
+    {
+        this->stopTimer();
+    }
+}
+
+void PerformanceSettings::timerCallback()
+{
+    this->updateStatus();
+}
+
+void PerformanceSettings::buttonClicked(Button *button)
+{
+    if (button == this->traceButton)
+    {
+        PerformanceTrace::setEnabled(!PerformanceTrace::isEnabled());
+        this->traceStatus = {};
+        this->updateTraceButton();
+    }
+    else if (button == this->saveTraceButton)
+    {
+        const String fileName = "Trace " +
+            Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S") + ".json";
+
+        const File file(DocumentHelpers::getDocumentSlot(fileName));
+        this->traceStatus = PerformanceTrace::saveAsChromeTrace(file) ?
+            (TRANS("settings::performance::trace::saved") + " " + file.getFullPathName()) :
+            TRANS("settings::performance::trace::empty");
+
+        Logger::writeToLog(this->traceStatus);
+    }
+
+    this->updateStatus();
+}
+
+void PerformanceSettings::updateTraceButton()
+{
+    this->traceButton->setButtonText(PerformanceTrace::isEnabled() ?
+        TRANS("settings::performance::trace::stop") :
+        TRANS("settings::performance::trace::start"));
+}
+
+void PerformanceSettings::updateStatus()
+{
+    String text;
+
+    if (const auto *monitor = this->audioCore.getMonitor())
+    {
+        const auto &stats = monitor->getLoadStats();
+        text << TRANS("settings::performance::load") << ": " << formatLoad(stats) << newLine;
+        text << "  " << formatHistogram(stats) << newLine;
+    }
+
+    auto &device = this->audioCore.getDevice();
+    text << TRANS("settings::performance::cpu") << ": " << roundToInt(device.getCpuUsage() * 100.0) << "%";
+
+    if (const auto *audioDevice = device.getCurrentAudioDevice())
+    {
+        const int xruns = audioDevice->getXRunCount();
+        text << ", " << TRANS("settings::performance::xruns") << ": " <<
+            (xruns >= 0 ? String(xruns) : TRANS("settings::performance::unknown"));
+    }
+
+    text << newLine;
+
+    for (const auto *instrument : this->audioCore.getInstruments())
+    {
+        const auto &stats = instrument->getLoadStats();
+        text << newLine << instrument->getName() << ": " << formatLoad(stats);
+        text << (instrument->isSuspended() ? ", " + TRANS("settings::performance::suspended") : "");
+        text << (instrument->isLoading() ?
+            ", " + TRANS("settings::performance::loading") + " " + String(roundToInt(instrument->getLoadingProgress() * 100.f)) + "%" : "") << newLine;
+        text << "  " << formatHistogram(stats) << newLine;
+    }
+
+    if (this->traceStatus.isNotEmpty())
+    {
+        text << newLine << this->traceStatus << newLine;
+    }
+
+    if (this->statusText->getText() != text)
+    {
+        this->statusText->setText(text, false);
+    }
+}
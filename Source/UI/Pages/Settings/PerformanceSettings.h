@@ -0,0 +1,54 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+class AudioCore;
+
+// Shows the audio engine load and lets the user record a performance trace,
+// so that dropouts can be diagnosed on the user's machine
+class PerformanceSettings final :
+    public Component,
+    private Timer,
+    private Button::Listener
+{
+public:
+
+    explicit PerformanceSettings(AudioCore &core);
+    ~PerformanceSettings() override;
+
+    void resized() override;
+    void visibilityChanged() override;
+
+private:
+
+    void timerCallback() override;
+    void buttonClicked(Button *button) override;
+
+    void updateStatus();
+    void updateTraceButton();
+
+    AudioCore &audioCore;
+
+    String traceStatus;
+
+    ScopedPointer<TextEditor> statusText;
+    ScopedPointer<TextButton> traceButton;
+    ScopedPointer<TextButton> saveTraceButton;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerformanceSettings)
+};
@@ -238,8 +238,9 @@ void StageComponent::changeListenerCallback(ChangeBroadcaster *source)
     {
         if (head->isRebuildingDiff())
         {
+            // the diff is rebuilt item by item, so show what's ready
             this->startProgressAnimation();
-            this->clearList();
+            this->updateList();
         }
         else
         {
@@ -119,7 +119,7 @@ PopupButton::PopupButton(bool shouldShowConfirmImage)
     setSize (48, 48);
 
     //[Constructor]
-    this->startTimerHz(60);
+    this->startReceivingFrames();
     //[/Constructor]
 }
 
@@ -294,14 +294,14 @@ void PopupButton::mouseUp (const MouseEvent& e)
 
 //[MiscUserCode]
 
-void PopupButton::timerCallback()
+void PopupButton::onFrame(float deltaMs)
 {
-    this->raduisDelta += RADUIS_STEP;
+    this->raduisDelta += RADUIS_STEP * deltaMs * FRAME_CLOCK_RATE_HZ / 1000.f;
 
     if (this->raduisDelta >= RADUIS_END)
     {
         this->raduisDelta = RADUIS_END;
-        this->stopTimer();
+        this->stopReceivingFrames();
     }
 
     this->repaint();
@@ -364,7 +364,7 @@ void PopupButton::updateChildren()
 BEGIN_JUCER_METADATA
 
 <JUCER_COMPONENT documentType="Component" className="PopupButton" template="../../Template"
-                 componentName="" parentClasses="public Component, private Timer"
+                 componentName="" parentClasses="public Component, private FrameClock::Listener"
                  constructorParams="bool shouldShowConfirmImage" variableInitialisers="alpha(0.5f),&#10;firstClickDone(false),&#10;raduisDelta(RADUIS_START)&#10;showConfirmImage(shouldShowConfirmImage)"
                  snapPixels="8" snapActive="0" snapShown="1" overlayOpacity="0.330"
                  fixedSize="1" initialWidth="48" initialHeight="48">
@@ -23,11 +23,12 @@ class PopupButtonConfirmation;
 
 #include "PopupButtonOwner.h"
 #include "ComponentFader.h"
+#include "FrameClock.h"
 //[/Headers]
 
 
 class PopupButton  : public Component,
-                     private Timer
+                     private FrameClock::Listener
 {
 public:
 
@@ -57,7 +58,7 @@ private:
 
     void onAction();
     void updateChildren();
-    void timerCallback() override;
+    void onFrame(float deltaMs) override;
 
     float alpha;
     float raduisDelta;
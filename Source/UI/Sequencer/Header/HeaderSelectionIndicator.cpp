@@ -39,7 +39,7 @@ HeaderSelectionIndicator::HeaderSelectionIndicator()
 
     //[Constructor]
     this->setAlpha(0.f);
-    this->startTimerHz(60);
+    this->startReceivingFrames();
     //[/Constructor]
 }
 
@@ -98,7 +98,7 @@ void HeaderSelectionIndicator::parentSizeChanged()
 BEGIN_JUCER_METADATA
 
 <JUCER_COMPONENT documentType="Component" className="HeaderSelectionIndicator"
-                 template="../../../Template" componentName="" parentClasses="public Component, private Timer"
+                 template="../../../Template" componentName="" parentClasses="public Component, private FrameClock::Listener"
                  constructorParams="" variableInitialisers="startAbsPosition(0.f),&#10;endAbsPosition(0.f)"
                  snapPixels="8" snapActive="1" snapShown="1" overlayOpacity="0.330"
                  fixedSize="1" initialWidth="128" initialHeight="16">
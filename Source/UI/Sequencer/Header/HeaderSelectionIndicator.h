@@ -19,11 +19,13 @@
 
 //[Headers]
 class IconComponent;
+
+#include "FrameClock.h"
 //[/Headers]
 
 
 class HeaderSelectionIndicator  : public Component,
-                                  private Timer
+                                  private FrameClock::Listener
 {
 public:
 
@@ -58,13 +60,13 @@ private:
 
     //[UserVariables]
 
-    void timerCallback() override
+    void onFrame(float deltaMs) override
     {
-        this->setAlpha(this->getAlpha() + 0.1f);
+        this->setAlpha(this->getAlpha() + 0.1f * deltaMs * FRAME_CLOCK_RATE_HZ / 1000.f);
 
         if (this->getAlpha() >= 1.f)
         {
-            this->stopTimer();
+            this->stopReceivingFrames();
         }
     }
 
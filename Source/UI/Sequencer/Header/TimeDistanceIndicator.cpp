@@ -45,7 +45,7 @@ TimeDistanceIndicator::TimeDistanceIndicator()
 
     //[Constructor]
     this->setAlpha(0.f);
-    this->startTimerHz(60);
+    this->startReceivingFrames();
     //[/Constructor]
 }
 
@@ -112,7 +112,7 @@ void TimeDistanceIndicator::parentSizeChanged()
 BEGIN_JUCER_METADATA
 
 <JUCER_COMPONENT documentType="Component" className="TimeDistanceIndicator" template="../../../Template"
-                 componentName="" parentClasses="public Component, private Timer"
+                 componentName="" parentClasses="public Component, private FrameClock::Listener"
                  constructorParams="" variableInitialisers="startAbsPosition(0.f),&#10;endAbsPosition(0.f)"
                  snapPixels="8" snapActive="1" snapShown="1" overlayOpacity="0.330"
                  fixedSize="1" initialWidth="128" initialHeight="32">
@@ -19,11 +19,13 @@
 
 //[Headers]
 class IconComponent;
+
+#include "FrameClock.h"
 //[/Headers]
 
 
 class TimeDistanceIndicator  : public Component,
-                               private Timer
+                               private FrameClock::Listener
 {
 public:
 
@@ -57,13 +59,13 @@ private:
 
     //[UserVariables]
 
-    void timerCallback() override
+    void onFrame(float deltaMs) override
     {
-        this->setAlpha(this->getAlpha() + 0.1f);
+        this->setAlpha(this->getAlpha() + 0.1f * deltaMs * FRAME_CLOCK_RATE_HZ / 1000.f);
 
         if (this->getAlpha() >= 1.f)
         {
-            this->stopTimer();
+            this->stopReceivingFrames();
         }
     }
 
@@ -41,7 +41,7 @@ HybridRollExpandMark::HybridRollExpandMark(HybridRoll &parentRoll, float targetB
     setSize (256, 48);
 
     //[Constructor]
-    this->startTimerHz(60);
+    this->startReceivingFrames();
     //[/Constructor]
 }
 
@@ -102,9 +102,9 @@ void HybridRollExpandMark::updatePosition()
     this->setBounds(xOffset, 0, newWidth, this->getParentHeight());
 }
 
-void HybridRollExpandMark::timerCallback()
+void HybridRollExpandMark::onFrame(float deltaMs)
 {
-    this->alpha -= 0.015f;
+    this->alpha -= 0.015f * deltaMs * FRAME_CLOCK_RATE_HZ / 1000.f;
 
     if (this->alpha <= 0)
     {
@@ -123,7 +123,7 @@ void HybridRollExpandMark::timerCallback()
 BEGIN_JUCER_METADATA
 
 <JUCER_COMPONENT documentType="Component" className="HybridRollExpandMark" template="../../../Template"
-                 componentName="" parentClasses="public Component, private Timer"
+                 componentName="" parentClasses="public Component, private FrameClock::Listener"
                  constructorParams="HybridRoll &amp;parentRoll, float targetBar, int numBarsToTake"
                  variableInitialisers="roll(parentRoll),&#10;bar(targetBar),&#10;numBars(numBarsToTake),&#10;alpha(1.f)"
                  snapPixels="8" snapActive="1" snapShown="1" overlayOpacity="0.330"
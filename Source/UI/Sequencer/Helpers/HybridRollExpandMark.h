@@ -20,11 +20,12 @@
 //[Headers]
 class HybridRoll;
 #include "IconComponent.h"
+#include "FrameClock.h"
 //[/Headers]
 
 
 class HybridRollExpandMark  : public Component,
-                              private Timer
+                              private FrameClock::Listener
 {
 public:
 
@@ -45,7 +46,7 @@ private:
 
     //[UserVariables]
 
-    void timerCallback() override;
+    void onFrame(float deltaMs) override;
     void updatePosition();
 
     HybridRoll &roll;
@@ -668,139 +668,74 @@ void HybridRoll::computeVisibleBeatLines()
     this->visibleBeats.clearQuick();
     this->visibleSnaps.clearQuick();
 
-    const auto tsSequence =
-        this->project.getTimeline()->getTimeSignatures()->getSequence();
-    
-    const float zeroCanvasOffset = this->firstBar * this->barWidth; // usually a negative value
+    const auto tsSequence = dynamic_cast<TimeSignaturesSequence *>
+        (this->project.getTimeline()->getTimeSignatures()->getSequence());
+
+    if (tsSequence == nullptr)
+    {
+        return;
+    }
+
+    const float beatWidth = this->barWidth / float(BEATS_PER_BAR);
     const float viewPosX = float(this->viewport.getViewPositionX());
-    const float paintStartX = viewPosX + zeroCanvasOffset;
-    const float paintEndX = float(viewPosX + this->viewport.getViewWidth()) + zeroCanvasOffset;
-    
-    const float paintStartBar = roundf(paintStartX / this->barWidth) - 2.f;
-    const float paintEndBar = roundf(paintEndX / this->barWidth) + 1.f;
-    
+    const float viewEndX = viewPosX + float(this->viewport.getViewWidth());
+    const float paintStartBeat = this->getFirstBeat() + viewPosX / beatWidth;
+    const float paintEndBeat = this->getFirstBeat() + viewEndX / beatWidth;
+
     // Get number of snaps depending on bar width, 
     // 2 for 64, 4 for 128, 8 for 256, etc:
     const float nearestPowTwo = ceilf(log(this->barWidth) / log(2.f));
     const float numSnaps = powf(2, jlimit(1.f, 6.f, nearestPowTwo - 5.f)); // use -4.f for twice as dense grid
     const float snapWidth = this->barWidth / numSnaps;
 
-    int numerator = TIME_SIGNATURE_DEFAULT_NUMERATOR;
-    int denominator = TIME_SIGNATURE_DEFAULT_DENOMINATOR;
-    float barIterator = float(this->firstBar);
-    int nextSignatureIdx = 0;
-    bool firstEvent = true;
-
-    // Find a time signature to start from (or use default values):
-    // find a first time signature after a paint start and take a previous one, if any
-    for (; nextSignatureIdx < tsSequence->size(); ++nextSignatureIdx)
+    // Start from the bar under the left edge of the screen, which the
+    // time signatures index finds without walking through the whole timeline
+    for (int bar = tsSequence->getBarByBeat(paintStartBeat);; ++bar)
     {
-        const auto signature =
-            static_cast<TimeSignatureEvent *>(tsSequence->getUnchecked(nextSignatureIdx));
-
-        // The very first event defines what's before it (both time signature and offset)
-        if (firstEvent)
-        {
-            numerator = signature->getNumerator();
-            denominator = signature->getDenominator();
-            const float beatStep = 1.f / float(denominator);
-            const float barStep = beatStep * float(numerator);
-            barIterator += fmodf(signature->getBeat() / BEATS_PER_BAR - float(this->firstBar), barStep) - barStep;
-            firstEvent = false;
-        }
-
-        if (signature->getBeat() >= (paintStartBar * BEATS_PER_BAR))
+        const Range<float> barRange(tsSequence->getBarRange(bar));
+        if (barRange.getStart() > paintEndBeat)
         {
             break;
         }
 
-        numerator = signature->getNumerator();
-        denominator = signature->getDenominator();
-        barIterator = signature->getBeat() / BEATS_PER_BAR;
-    }
-
-    // At this point we have barIterator pointing at the anchor,
-    // that is nearest to the left side of visible screen area
-    // (it could be either TimeSignatureEvent, or just the very first bar)
-
-    float barWidthSum = 0.f;
-    bool canDrawBarLine = false;
-
-    while (barIterator <= paintEndBar)
-    {
-        // We don't do anything else unless we have reached the left side of visible area
-        // Since we have already found the nearest time signature,
-        // we assume that time signature does not change in between,
-        // and we only need to count barWidthSum:
-
-        float beatStep = 1.f / float(denominator);
-        float barStep = beatStep * float(numerator);
-        const float barStartX = this->barWidth * barIterator - zeroCanvasOffset;
-        const float stepWidth = this->barWidth * barStep;
+        const auto &meter = tsSequence->getMeterByBar(bar);
+        const float barStartX = (barRange.getStart() - this->getFirstBeat()) * beatWidth;
+        const float barEndX = (barRange.getEnd() - this->getFirstBeat()) * beatWidth;
 
-        barWidthSum += stepWidth;
-        canDrawBarLine = barWidthSum > MIN_BAR_WIDTH;
-        barWidthSum = canDrawBarLine ? 0.f : barWidthSum;
-
-        // When in the drawing area:
-        if (barIterator > paintStartBar)
+        // When zoomed out, only draw every n-th bar line, counting from
+        // the meter start, so that the meter changes are always shown
+        // and the lines don't jump around while scrolling
+        const int barsPerLine = int(MIN_BAR_WIDTH / (meter.barLength * beatWidth)) + 1;
+        const int barInMeter = bar - meter.firstBar;
+        if (((barInMeter % barsPerLine) + barsPerLine) % barsPerLine == 0)
         {
-            if (canDrawBarLine)
-            {
-                visibleBars.add(barStartX);
-            }
+            this->visibleBars.add(barStartX);
+        }
 
-            // Check if we have more time signatures to come
-            TimeSignatureEvent *nextSignature = nullptr;
-            if (nextSignatureIdx < tsSequence->size())
-            {
-                nextSignature = static_cast<TimeSignatureEvent *>(tsSequence->getUnchecked(nextSignatureIdx));
-            }
+        const float beatStepX = meter.beatLength * beatWidth;
+        for (int beat = 0; barStartX + beatStepX * beat < barEndX; ++beat)
+        {
+            const float beatStartX = barStartX + beatStepX * beat;
+            const float nextBeatStartX = jmin(beatStartX + beatStepX, barEndX);
 
-            // Now for the beat lines
-            bool lastFrame = false;
-            for (float j = 0.f; j < barStep && !lastFrame; j += beatStep)
+            // Get snap lines and beat lines
+            for (float k = beatStartX + snapWidth;
+                k < (nextBeatStartX - 1);
+                k += snapWidth)
             {
-                const float beatStartX = barStartX + this->barWidth * j;
-                float nextBeatStartX = barStartX + this->barWidth * (j + beatStep);
-
-                // Check for time signature change at this point
-                if (nextSignature != nullptr)
+                if (k >= viewPosX)
                 {
-                    const float tsBar = nextSignature->getBeat() / BEATS_PER_BAR;
-                    if (tsBar <= (barIterator + j + beatStep))
-                    {
-                        numerator = nextSignature->getNumerator();
-                        denominator = nextSignature->getDenominator();
-                        barStep = (tsBar - barIterator); // i.e. incomplete bar
-                        nextBeatStartX = barStartX + this->barWidth * barStep;
-                        nextSignatureIdx++;
-                        barWidthSum = MIN_BAR_WIDTH; // forces to draw the next bar line
-                        lastFrame = true;
-                    }
-                }
-
-                // Get snap lines and beat lines
-                for (float k = beatStartX + snapWidth;
-                    k < (nextBeatStartX - 1);
-                    k += snapWidth)
-                {
-                    if (k >= viewPosX)
-                    {
-                        visibleSnaps.add(k);
-                    }
+                    this->visibleSnaps.add(k);
                 }
+            }
 
-                if (beatStartX >= viewPosX &&
-                    j >= beatStep && // don't draw the first one as it is a bar line
-                    (nextBeatStartX - beatStartX) > MIN_BEAT_WIDTH)
-                {
-                    visibleBeats.add(beatStartX);
-                }
+            if (beatStartX >= viewPosX &&
+                beat > 0 && // don't draw the first one as it is a bar line
+                (nextBeatStartX - beatStartX) > MIN_BEAT_WIDTH)
+            {
+                this->visibleBeats.add(beatStartX);
             }
         }
-
-        barIterator += barStep;
     }
 }
 
@@ -1320,7 +1255,7 @@ void HybridRoll::stopFollowingPlayhead()
     }
 
 #if ROLL_VIEW_FOLLOWS_PLAYHEAD
-    this->stopTimer();
+    this->stopReceivingFrames();
     // this introduces the case when I change a note during playback, and the note component position is not updated
     //this->cancelPendingUpdate();
     this->shouldFollowPlayhead = false;
@@ -1331,7 +1266,7 @@ void HybridRoll::scrollToSeekPosition()
 {
 #if ROLL_VIEW_FOLLOWS_PLAYHEAD
     this->startFollowingPlayhead();
-    this->startTimer(8);
+    this->startReceivingFrames();
 #else
     const int playheadX = this->getXPositionByTransportPosition(this->lastTransportPosition.get(), float(this->getWidth()));
     this->viewport.setViewPosition(playheadX - (this->viewport.getViewWidth() / 3), this->viewport.getViewPositionY());
@@ -1348,21 +1283,7 @@ void HybridRoll::handleAsyncUpdate()
     // batch repaint & resize stuff
     if (this->batchRepaintList.size() > 0)
     {
-        HYBRID_ROLL_BULK_REPAINT_START
-
-        for (int i = 0; i < this->batchRepaintList.size(); ++i)
-        {
-            if (FloatBoundsComponent *mc = this->batchRepaintList.getUnchecked(i))
-            {
-                const Rectangle<float> nb(this->getEventBounds(mc));
-                mc->setFloatBounds(nb);
-                mc->repaint();
-            }
-        }
-
-        HYBRID_ROLL_BULK_REPAINT_END
-
-        this->batchRepaintList.clear();
+        this->applyBatchRepaints();
     }
 
 #if ROLL_VIEW_FOLLOWS_PLAYHEAD
@@ -1388,6 +1309,61 @@ void HybridRoll::handleAsyncUpdate()
 #endif
 }
 
+void HybridRoll::applyBatchRepaints()
+{
+    // The same component is often scheduled several times per frame,
+    // e.g. when a note is both moved and selected, so only take it once
+    SparseHashSet<FloatBoundsComponent *> uniqueTargets;
+    uniqueTargets.reserve(this->batchRepaintList.size());
+    this->batchRepaintTargets.clearQuick();
+
+    for (const auto &target : this->batchRepaintList)
+    {
+        FloatBoundsComponent *mc = target.getComponent();
+        if (mc != nullptr && uniqueTargets.insert(mc).second)
+        {
+            this->batchRepaintTargets.add(mc);
+        }
+    }
+
+    this->batchRepaintList.clearQuick();
+
+    // A visible component can't be moved without repainting its parent,
+    // so for the large batches the roll is hidden while the bounds are applied:
+    // no repaints propagate from the children, and showing the roll back
+    // invalidates the visible area as a whole, once per batch.
+    // Small batches rely on setBounds repainting the old and the new areas,
+    // which the peer merges into its dirty region, and only the components
+    // that haven't moved need an explicit repaint
+    const bool isLargeBatch = this->batchRepaintTargets.size() > HYBRID_ROLL_MAX_BATCH_REPAINTS;
+
+    if (isLargeBatch)
+    {
+        HYBRID_ROLL_BULK_REPAINT_START
+
+        for (auto *mc : this->batchRepaintTargets)
+        {
+            mc->setFloatBounds(this->getEventBounds(mc));
+        }
+
+        HYBRID_ROLL_BULK_REPAINT_END
+    }
+    else
+    {
+        for (auto *mc : this->batchRepaintTargets)
+        {
+            const Rectangle<int> oldBounds(mc->getBounds());
+            mc->setFloatBounds(this->getEventBounds(mc));
+            if (mc->getBounds() == oldBounds)
+            {
+                mc->repaint();
+            }
+        }
+    }
+
+    this->batchRepaintTargets.clearQuick();
+}
+
 double HybridRoll::findPlayheadOffsetFromViewCentre() const
 {
     const int playheadX = this->getXPositionByTransportPosition(this->lastTransportPosition.get(), float(this->getWidth()));
@@ -1402,19 +1378,14 @@ void HybridRoll::triggerBatchRepaintFor(FloatBoundsComponent *target)
 }
 
 //===----------------------------------------------------------------------===//
-// Timer
+// FrameClock::Listener
 //===----------------------------------------------------------------------===//
 
-void HybridRoll::hiResTimerCallback()
+void HybridRoll::onFrame(float deltaMs)
 {
     if (fabs(this->playheadOffset) < 0.01)
     {
-        MessageManagerLock lock(Thread::getCurrentThread());
-
-        if (lock.lockWasGained())
-        {
-            this->stopFollowingPlayhead();
-        }
+        this->stopFollowingPlayhead();
     }
 
     this->triggerAsyncUpdate();
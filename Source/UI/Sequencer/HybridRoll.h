@@ -52,6 +52,7 @@ class TimelineWarningMarker;
 #include "Lasso.h"
 #include "HybridRollEditMode.h"
 #include "AudioMonitor.h"
+#include "FrameClock.h"
 
 #define HYBRID_ROLL_MAX_BAR_WIDTH (192)
 #define HYBRID_ROLL_HEADER_HEIGHT (40)
@@ -64,6 +65,10 @@ class TimelineWarningMarker;
 #define HYBRID_ROLL_BULK_REPAINT_END \
     this->setVisible(true);
 
+// Batches larger than this are moved with the roll hidden,
+// so that they end up in a single repaint of the visible area
+#define HYBRID_ROLL_MAX_BATCH_REPAINTS 64
+
 class HybridRoll :
     public Component,
     public Serializable,
@@ -77,7 +82,7 @@ class HybridRoll :
     protected ChangeListener, // listens to HybridRollEditMode,
     protected TransportListener,
     protected AsyncUpdater, // for async scrolling on transport listener events
-    protected HighResolutionTimer, // for smooth scrolling to seek position
+    protected FrameClock::Listener, // for smooth scrolling to seek position
     protected Playhead::Listener, // for smooth scrolling to seek position
     protected AudioMonitor::ClippingListener // for displaying clipping indicator components
 {
@@ -304,14 +309,15 @@ protected:
     
     void handleAsyncUpdate() override;
 
+    void applyBatchRepaints();
     double findPlayheadOffsetFromViewCentre() const;
     friend class HybridRollHeader;
     
     //===------------------------------------------------------------------===//
-    // Timer
+    // FrameClock::Listener
     //===------------------------------------------------------------------===//
 
-    void hiResTimerCallback() override;
+    void onFrame(float deltaMs) override;
     
 protected:
     
@@ -419,7 +425,9 @@ protected:
     ScopedPointer<SmoothPanController> smoothPanController;
     ScopedPointer<SmoothZoomController> smoothZoomController;
 
+    // May contain duplicates, which are skipped when the batch is applied
     Array<SafePointer<FloatBoundsComponent>> batchRepaintList;
+    Array<FloatBoundsComponent *> batchRepaintTargets;
 
 protected:
     
@@ -0,0 +1,382 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "ClipThumbnailCache.h"
+#include "PianoSequence.h"
+#include "PatternRoll.h"
+#include "Note.h"
+
+#define CLIP_THUMBNAIL_HEIGHT PATTERN_ROLL_CLIP_HEIGHT
+#define CLIP_THUMBNAIL_MAX_WIDTH 4096
+#define CLIP_THUMBNAIL_MIN_ZOOM_LEVEL 0
+#define CLIP_THUMBNAIL_MAX_ZOOM_LEVEL 8
+#define CLIP_THUMBNAILS_MEMORY_BUDGET (24 * 1024 * 1024)
+
+// Zoom levels are powers of two of the beat width, so that the thumbnail
+// is only re-rendered when it would be scaled more than twice
+static inline int getZoomLevel(float beatWidth) noexcept
+{
+    return jlimit(CLIP_THUMBNAIL_MIN_ZOOM_LEVEL, CLIP_THUMBNAIL_MAX_ZOOM_LEVEL,
+        roundToInt(log2f(jmax(1.f, beatWidth))));
+}
+
+static inline int getThumbnailWidth(int zoomLevel, float lengthInBeats) noexcept
+{
+    const float pixelsPerBeat = float(1 << zoomLevel);
+    return jlimit(1, CLIP_THUMBNAIL_MAX_WIDTH, int(ceilf(lengthInBeats * pixelsPerBeat)));
+}
+
+static inline int64 getImageSize(const Image &image) noexcept
+{
+    return image.isValid() ? int64(image.getWidth()) * image.getHeight() * 4 : 0;
+}
+
+class ClipThumbnailCache::RenderJob final : public ThreadPoolJob
+{
+public:
+
+    RenderJob(ClipThumbnailCache &cache, const Key &key, uint32 version,
+        float firstBeat, float lastBeat, int width, const Image &baseImage,
+        float dirtyStartBeat, float dirtyEndBeat, const Array<NoteSnapshot> &notes) :
+        ThreadPoolJob("Clip thumbnail"),
+        cache(cache),
+        key(key),
+        version(version),
+        firstBeat(firstBeat),
+        lastBeat(lastBeat),
+        width(width),
+        baseImage(baseImage),
+        dirtyStartBeat(dirtyStartBeat),
+        dirtyEndBeat(dirtyEndBeat),
+        notes(notes) {}
+
+    JobStatus runJob() override
+    {
+        const float pixelsPerBeat = float(this->width) / (this->lastBeat - this->firstBeat);
+        const float keyHeight = float(CLIP_THUMBNAIL_HEIGHT) / 128.f;
+
+        Image image;
+        Rectangle<int> area(0, 0, this->width, CLIP_THUMBNAIL_HEIGHT);
+
+        if (this->baseImage.isValid())
+        {
+            // Only redraw the changed range on top of the previous image
+            const int x1 = int(floorf((this->dirtyStartBeat - this->firstBeat) * pixelsPerBeat)) - 1;
+            const int x2 = int(ceilf((this->dirtyEndBeat - this->firstBeat) * pixelsPerBeat)) + 1;
+            area = area.getIntersection({ x1, 0, x2 - x1, CLIP_THUMBNAIL_HEIGHT });
+            image = this->baseImage.createCopy();
+            image.clear(area);
+        }
+        else
+        {
+            image = Image(Image::ARGB, this->width, CLIP_THUMBNAIL_HEIGHT, true, SoftwareImageType());
+        }
+
+        {
+            Graphics g(image);
+            g.reduceClipRegion(area);
+
+            for (const auto &note : this->notes)
+            {
+                if (this->shouldExit())
+                {
+                    return jobHasFinished;
+                }
+
+                const float x = (note.beat - this->firstBeat) * pixelsPerBeat;
+                const float w = jmax(1.f, note.length * pixelsPerBeat);
+                const float y = float(CLIP_THUMBNAIL_HEIGHT) - float(note.key + 1) * keyHeight;
+                g.setColour(Colours::white.withAlpha(0.3f + 0.5f * note.velocity));
+                g.fillRect(x, y, w, jmax(1.f, keyHeight));
+            }
+        }
+
+        this->cache.onThumbnailRendered({ this->key, this->version,
+            this->firstBeat, this->lastBeat, image });
+
+        return jobHasFinished;
+    }
+
+private:
+
+    ClipThumbnailCache &cache;
+
+    const Key key;
+    const uint32 version;
+    const float firstBeat;
+    const float lastBeat;
+    const int width;
+
+    const Image baseImage;
+    const float dirtyStartBeat;
+    const float dirtyEndBeat;
+
+    const Array<NoteSnapshot> notes;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderJob)
+};
+
+ClipThumbnailCache::ClipThumbnailCache(UpdateCallback onThumbnailUpdated) :
+    onThumbnailUpdated(onThumbnailUpdated),
+    usageCounter(0),
+    versionCounter(0),
+    renderPool(1)
+{
+    this->renderPool.setThreadPriorities(3);
+}
+
+ClipThumbnailCache::~ClipThumbnailCache()
+{
+    this->renderPool.removeAllJobs(true, -1);
+}
+
+Image ClipThumbnailCache::getThumbnail(const MidiSequence *sequence, float beatWidth)
+{
+    if (dynamic_cast<const PianoSequence *>(sequence) == nullptr ||
+        sequence->getLengthInBeats() <= 0.f)
+    {
+        return {};
+    }
+
+    const Key key = { sequence, getZoomLevel(beatWidth) };
+    auto &thumbnail = this->thumbnails[key];
+    thumbnail.lastUsed = ++this->usageCounter;
+
+    if (thumbnail.isDirty && !thumbnail.isRendering)
+    {
+        this->triggerAsyncUpdate();
+    }
+
+    if (thumbnail.image.isValid())
+    {
+        return thumbnail.image;
+    }
+
+    // While the requested one is rendering, any other zoom level will do
+    for (const auto &other : this->thumbnails)
+    {
+        if (other.first.sequence == sequence && other.second.image.isValid())
+        {
+            return other.second.image;
+        }
+    }
+
+    return {};
+}
+
+void ClipThumbnailCache::invalidateBeatRange(const MidiSequence *sequence,
+    float startBeat, float endBeat)
+{
+    for (auto &e : this->thumbnails)
+    {
+        if (e.first.sequence != sequence)
+        {
+            continue;
+        }
+
+        auto &thumbnail = e.second;
+        if (thumbnail.isDirty)
+        {
+            thumbnail.dirtyStartBeat = jmin(thumbnail.dirtyStartBeat, startBeat);
+            thumbnail.dirtyEndBeat = jmax(thumbnail.dirtyEndBeat, endBeat);
+        }
+        else
+        {
+            thumbnail.isDirty = true;
+            thumbnail.dirtyStartBeat = startBeat;
+            thumbnail.dirtyEndBeat = endBeat;
+        }
+
+        this->triggerAsyncUpdate();
+    }
+}
+
+void ClipThumbnailCache::invalidateSequence(const MidiSequence *sequence)
+{
+    for (auto &e : this->thumbnails)
+    {
+        if (e.first.sequence == sequence)
+        {
+            e.second.isDirty = true;
+            e.second.needsFullRender = true;
+            this->triggerAsyncUpdate();
+        }
+    }
+}
+
+void ClipThumbnailCache::removeSequence(const MidiSequence *sequence)
+{
+    // Jobs still rendering will have their results dropped,
+    // since their versions won't match any thumbnail
+    Array<Key> keys;
+    for (const auto &e : this->thumbnails)
+    {
+        if (e.first.sequence == sequence)
+        {
+            keys.add(e.first);
+        }
+    }
+
+    for (const auto &key : keys)
+    {
+        this->thumbnails.erase(key);
+    }
+}
+
+void ClipThumbnailCache::removeAll()
+{
+    this->renderPool.removeAllJobs(true, -1);
+    this->thumbnails.clear();
+
+    const ScopedLock lock(this->renderedThumbnailsLock);
+    this->renderedThumbnails.clearQuick();
+}
+
+//===----------------------------------------------------------------------===//
+// Rendering
+//===----------------------------------------------------------------------===//
+
+void ClipThumbnailCache::scheduleRendering(const Key &key, Thumbnail &thumbnail)
+{
+    const float firstBeat = key.sequence->getFirstBeat();
+    const float lastBeat = key.sequence->getLastBeat();
+    const int width = getThumbnailWidth(key.zoomLevel, lastBeat - firstBeat);
+
+    // Partial rendering only makes sense if the sequence range hasn't changed
+    const bool canRenderPartially = !thumbnail.needsFullRender &&
+        thumbnail.image.isValid() &&
+        thumbnail.image.getWidth() == width &&
+        thumbnail.imageFirstBeat == firstBeat &&
+        thumbnail.imageLastBeat == lastBeat;
+
+    const float pixelsPerBeat = float(width) / (lastBeat - firstBeat);
+    const float margin = 1.f / pixelsPerBeat;
+    const float dirtyStartBeat = canRenderPartially ? thumbnail.dirtyStartBeat - margin : firstBeat;
+    const float dirtyEndBeat = canRenderPartially ? thumbnail.dirtyEndBeat + margin : lastBeat;
+
+    Array<MidiEvent *> eventsInRange;
+    key.sequence->findEventsInRange(dirtyStartBeat, dirtyEndBeat, eventsInRange);
+
+    Array<NoteSnapshot> notes;
+    for (const auto *event : eventsInRange)
+    {
+        const Note &note = static_cast<const Note &>(*event);
+        notes.add({ note.getKey(), note.getBeat(), note.getLength(), note.getVelocity() });
+    }
+
+    thumbnail.isDirty = false;
+    thumbnail.needsFullRender = false;
+    thumbnail.isRendering = true;
+    thumbnail.scheduledVersion = ++this->versionCounter;
+
+    this->renderPool.addJob(new RenderJob(*this, key, thumbnail.scheduledVersion,
+        firstBeat, lastBeat, width, canRenderPartially ? thumbnail.image : Image(),
+        dirtyStartBeat, dirtyEndBeat, notes), true);
+}
+
+void ClipThumbnailCache::onThumbnailRendered(const RenderedThumbnail &rendered)
+{
+    // Called from the render thread
+    const ScopedLock lock(this->renderedThumbnailsLock);
+    this->renderedThumbnails.add(rendered);
+    this->triggerAsyncUpdate();
+}
+
+void ClipThumbnailCache::handleAsyncUpdate()
+{
+    Array<RenderedThumbnail> results;
+
+    {
+        const ScopedLock lock(this->renderedThumbnailsLock);
+        results.swapWith(this->renderedThumbnails);
+    }
+
+    Array<const MidiSequence *> updatedSequences;
+
+    for (const auto &rendered : results)
+    {
+        const auto found = this->thumbnails.find(rendered.key);
+        if (found != this->thumbnails.end() &&
+            found->second.isRendering &&
+            found->second.scheduledVersion == rendered.version)
+        {
+            auto &thumbnail = found->second;
+            thumbnail.image = rendered.image;
+            thumbnail.imageFirstBeat = rendered.firstBeat;
+            thumbnail.imageLastBeat = rendered.lastBeat;
+            thumbnail.isRendering = false;
+            updatedSequences.addIfNotAlreadyThere(rendered.key.sequence);
+        }
+    }
+
+    for (auto &e : this->thumbnails)
+    {
+        if (e.second.isDirty && !e.second.isRendering)
+        {
+            if (e.first.sequence->getLengthInBeats() > 0.f)
+            {
+                this->scheduleRendering(e.first, e.second);
+            }
+            else
+            {
+                e.second = {};
+                e.second.isDirty = false;
+                updatedSequences.addIfNotAlreadyThere(e.first.sequence);
+            }
+        }
+    }
+
+    this->applyMemoryBudget();
+
+    for (const auto *sequence : updatedSequences)
+    {
+        this->onThumbnailUpdated(sequence);
+    }
+}
+
+void ClipThumbnailCache::applyMemoryBudget()
+{
+    int64 totalSize = 0;
+    for (const auto &e : this->thumbnails)
+    {
+        totalSize += getImageSize(e.second.image);
+    }
+
+    while (totalSize > CLIP_THUMBNAILS_MEMORY_BUDGET)
+    {
+        auto leastRecentlyUsed = this->thumbnails.end();
+        for (auto it = this->thumbnails.begin(); it != this->thumbnails.end(); ++it)
+        {
+            if (it->second.image.isValid() &&
+                it->second.lastUsed != this->usageCounter &&
+                (leastRecentlyUsed == this->thumbnails.end() ||
+                    it->second.lastUsed < leastRecentlyUsed->second.lastUsed))
+            {
+                leastRecentlyUsed = it;
+            }
+        }
+
+        if (leastRecentlyUsed == this->thumbnails.end())
+        {
+            break;
+        }
+
+        totalSize -= getImageSize(leastRecentlyUsed->second.image);
+        this->thumbnails.erase(leastRecentlyUsed);
+    }
+}
@@ -0,0 +1,123 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+class MidiSequence;
+
+// Note thumbnails for the pattern roll clips: all clips of the same sequence
+// share one image per zoom level, which is rendered on a background thread
+// and, after the sequence changes, re-rendered only within the changed range;
+// the least recently used images are dropped when the cache gets too large.
+class ClipThumbnailCache final : private AsyncUpdater
+{
+public:
+
+    typedef Function<void(const MidiSequence *)> UpdateCallback;
+
+    explicit ClipThumbnailCache(UpdateCallback onThumbnailUpdated);
+    ~ClipThumbnailCache() override;
+
+    // Returns the best image available at the moment, which might be
+    // outdated or rendered for another zoom level, and schedules rendering
+    // of the requested one, if needed; the callback will tell when it's ready.
+    Image getThumbnail(const MidiSequence *sequence, float beatWidth);
+
+    void invalidateBeatRange(const MidiSequence *sequence, float startBeat, float endBeat);
+    void invalidateSequence(const MidiSequence *sequence);
+    void removeSequence(const MidiSequence *sequence);
+    void removeAll();
+
+private:
+
+    struct Key final
+    {
+        const MidiSequence *sequence;
+        int zoomLevel;
+
+        inline bool operator==(const Key &other) const noexcept
+        {
+            return this->sequence == other.sequence && this->zoomLevel == other.zoomLevel;
+        }
+    };
+
+    struct KeyHash final
+    {
+        inline HashCode operator()(const Key &key) const noexcept
+        {
+            return (reinterpret_cast<HashCode>(key.sequence) ^
+                static_cast<HashCode>(key.zoomLevel)) % HASH_CODE_MAX;
+        }
+    };
+
+    struct NoteSnapshot final
+    {
+        int key;
+        float beat;
+        float length;
+        float velocity;
+    };
+
+    struct Thumbnail final
+    {
+        Image image;
+        float imageFirstBeat = 0.f;
+        float imageLastBeat = 0.f;
+
+        // what has changed since the last scheduled render
+        bool isDirty = true;
+        bool needsFullRender = true;
+        float dirtyStartBeat = 0.f;
+        float dirtyEndBeat = 0.f;
+
+        bool isRendering = false;
+        uint32 scheduledVersion = 0;
+        uint32 lastUsed = 0;
+    };
+
+    struct RenderedThumbnail final
+    {
+        Key key;
+        uint32 version;
+        float firstBeat;
+        float lastBeat;
+        Image image;
+    };
+
+    class RenderJob;
+    friend class RenderJob;
+
+    void handleAsyncUpdate() override;
+    void onThumbnailRendered(const RenderedThumbnail &rendered);
+
+    void scheduleRendering(const Key &key, Thumbnail &thumbnail);
+    void applyMemoryBudget();
+
+    UpdateCallback onThumbnailUpdated;
+
+    typedef SparseHashMap<Key, Thumbnail, KeyHash> ThumbnailsMap;
+    ThumbnailsMap thumbnails;
+    uint32 usageCounter;
+    uint32 versionCounter;
+
+    CriticalSection renderedThumbnailsLock;
+    Array<RenderedThumbnail> renderedThumbnails;
+
+    ThreadPool renderPool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClipThumbnailCache)
+};
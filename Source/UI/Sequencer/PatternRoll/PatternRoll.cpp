@@ -45,6 +45,7 @@
 #include "AutomationSequence.h"
 #include "AutomationClipComponent.h"
 #include "DummyClipComponent.h"
+#include "ClipThumbnailCache.h"
 #include "ComponentIDs.h"
 #include "ColourIDs.h"
 
@@ -77,6 +78,17 @@ PatternRoll::PatternRoll(ProjectTreeItem &parentProject,
     this->insertTrackHelper = new MidiTrackHeader(nullptr);
     this->addAndMakeVisible(this->insertTrackHelper);
 
+    this->clipThumbnails = new ClipThumbnailCache([this](const MidiSequence *sequence)
+    {
+        for (const auto &e : this->clipComponents)
+        {
+            if (e.first.getPattern()->getTrack()->getSequence() == sequence)
+            {
+                e.second->repaint();
+            }
+        }
+    });
+
     this->repaintBackgroundsCache();
     this->reloadRollContent();
     this->setBarRange(0, 8);
@@ -345,26 +357,56 @@ Pattern *PatternRoll::getPatternByMousePosition(int y) const
     return this->tracks.getUnchecked(patternIndex)->getPattern();
 }
 
+Image PatternRoll::getClipThumbnail(const MidiSequence *sequence)
+{
+    return this->clipThumbnails->getThumbnail(sequence, this->barWidth / float(BEATS_PER_BAR));
+}
+
+void PatternRoll::invalidateClipsOf(const Note &note)
+{
+    const auto sequence = note.getSequence();
+    this->clipThumbnails->invalidateBeatRange(sequence,
+        note.getBeat(), note.getBeat() + note.getLength());
+
+    // The sequence range might have changed, so the clips have to be resized
+    for (const auto &e : this->clipComponents)
+    {
+        if (e.first.getPattern()->getTrack()->getSequence() == sequence)
+        {
+            this->batchRepaintList.add(e.second.get());
+        }
+    }
+
+    this->triggerAsyncUpdate();
+}
+
 //===----------------------------------------------------------------------===//
 // ProjectListener
 //===----------------------------------------------------------------------===//
 
 void PatternRoll::onAddMidiEvent(const MidiEvent &event)
 {
-    // the question is:
-    // is pattern roll supposed to monitor single event changes?
-    // or it just reloads the whole sequence on show?0
-    //this->reloadRollContent();
+    if (event.isTypeOf(MidiEvent::Note))
+    {
+        this->invalidateClipsOf(static_cast<const Note &>(event));
+    }
 }
 
 void PatternRoll::onChangeMidiEvent(const MidiEvent &oldEvent, const MidiEvent &newEvent)
 {
-    //
+    if (oldEvent.isTypeOf(MidiEvent::Note))
+    {
+        this->invalidateClipsOf(static_cast<const Note &>(oldEvent));
+        this->invalidateClipsOf(static_cast<const Note &>(newEvent));
+    }
 }
 
 void PatternRoll::onRemoveMidiEvent(const MidiEvent &event)
 {
-    //
+    if (event.isTypeOf(MidiEvent::Note))
+    {
+        this->invalidateClipsOf(static_cast<const Note &>(event));
+    }
 }
 
 void PatternRoll::onPostRemoveMidiEvent(MidiSequence *const layer)
@@ -439,6 +481,7 @@ void PatternRoll::onChangeTrackProperties(MidiTrack *const track)
 void PatternRoll::onRemoveTrack(MidiTrack *const track)
 {
     this->tracks.removeAllInstancesOf(track);
+    this->clipThumbnails->removeSequence(track->getSequence());
 
     if (MidiTrackHeader *deletedHeader = this->trackHeaders[track].get())
     {
@@ -520,6 +563,7 @@ void PatternRoll::onPostRemoveClip(Pattern *const pattern)
 
 void PatternRoll::onReloadProjectContent(const Array<MidiTrack *> &tracks)
 {
+    this->clipThumbnails->removeAll();
     this->reloadRollContent();
 }
 
@@ -26,6 +26,8 @@
 #endif
 
 class ClipComponent;
+class ClipThumbnailCache;
+class Note;
 class MidiTrackHeader;
 class PianoRollReboundThread;
 class PianoRollCellHighlighter;
@@ -65,6 +67,7 @@ public:
     float getBeatByComponentPosition(float x) const;
     float getBeatByMousePosition(int x) const;
     Pattern *getPatternByMousePosition(int y) const;
+    Image getClipThumbnail(const MidiSequence *sequence);
 
     //===------------------------------------------------------------------===//
     // ProjectListener
@@ -168,5 +171,8 @@ private:
     typedef SparseHashMap<Clip, UniquePointer<ClipComponent>, ClipHash> ClipComponentsMap;
     ClipComponentsMap clipComponents;
 
+    ScopedPointer<ClipThumbnailCache> clipThumbnails;
+    void invalidateClipsOf(const Note &note);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatternRoll)
 };
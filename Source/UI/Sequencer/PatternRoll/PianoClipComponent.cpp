@@ -23,6 +23,7 @@
 #include "HybridRoll.h"
 #include "Pattern.h"
 #include "MidiTrack.h"
+#include "PatternRoll.h"
 
 PianoClipComponent::PianoClipComponent(MidiTrack *targetTrack,
     HybridRoll &editor, const Clip &clip) :
@@ -31,3 +32,21 @@ PianoClipComponent::PianoClipComponent(MidiTrack *targetTrack,
 {
     //
 }
+
+//===----------------------------------------------------------------------===//
+// Component
+//===----------------------------------------------------------------------===//
+
+void PianoClipComponent::paint(Graphics &g)
+{
+    ClipComponent::paint(g);
+
+    // The thumbnail is shared by all clips of the sequence,
+    // and might be rendered for another zoom level, hence the scaling
+    const Image thumbnail(this->getRoll().getClipThumbnail(this->track->getSequence()));
+    if (thumbnail.isValid())
+    {
+        g.drawImage(thumbnail, this->getLocalBounds().toFloat().reduced(1.f, 0.f).withTrimmedTop(3.f),
+            RectanglePlacement::stretchToFit);
+    }
+}
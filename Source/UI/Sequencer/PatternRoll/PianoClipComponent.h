@@ -27,6 +27,12 @@ public:
 
     PianoClipComponent(MidiTrack *track, HybridRoll &editor, const Clip &clip);
 
+    //===------------------------------------------------------------------===//
+    // Component
+    //===------------------------------------------------------------------===//
+
+    void paint(Graphics &g) override;
+
 protected:
 
     MidiTrack *track;
@@ -31,19 +31,14 @@
 #define RESIZE_CORNER 10
 #define MAX_DRAG_POLYPHONY 8
 
-static PianoSequence *getPianoLayer(SelectionProxyArray::Ptr selection)
-{
-    const auto &firstEvent = selection->getFirstAs<NoteComponent>()->getNote();
-    PianoSequence *pianoLayer = static_cast<PianoSequence *>(firstEvent.getSequence());
-    return pianoLayer;
-}
-
 NoteComponent::NoteComponent(PianoRoll &editor, const Note &event, bool ghostMode)
     : HybridRollEventComponent(editor, ghostMode),
       midiEvent(event),
       state(None),
       anchor(event),
       groupScalingAnchor(event),
+      preview(event),
+      isPreviewing(false),
       firstChangeDone(false)
 {
     this->updateColours();
@@ -68,17 +63,43 @@ PianoRoll &NoteComponent::getRoll() const noexcept
 
 int NoteComponent::getKey() const noexcept
 {
-    return static_cast<const Note &>(this->midiEvent).getKey();
+    return this->getPreview().getKey();
 }
 
 float NoteComponent::getLength() const noexcept
 {
-    return static_cast<const Note &>(this->midiEvent).getLength();
+    return this->getPreview().getLength();
 }
 
 float NoteComponent::getVelocity() const noexcept
 {
-    return static_cast<const Note &>(this->midiEvent).getVelocity();
+    return this->getPreview().getVelocity();
+}
+
+//===----------------------------------------------------------------------===//
+// Preview
+//===----------------------------------------------------------------------===//
+
+void NoteComponent::setPreview(const Note &note)
+{
+    this->preview = note;
+    this->isPreviewing = true;
+    this->roll.triggerBatchRepaintFor(this);
+}
+
+void NoteComponent::clearPreview() noexcept
+{
+    this->isPreviewing = false;
+}
+
+bool NoteComponent::hasPreview() const noexcept
+{
+    return this->isPreviewing;
+}
+
+const Note &NoteComponent::getPreview() const noexcept
+{
+    return this->isPreviewing ? this->preview : this->getNote();
 }
 
 void NoteComponent::updateColours()
@@ -128,7 +149,7 @@ void NoteComponent::setSelected(bool selected)
 
 float NoteComponent::getBeat() const
 {
-    return this->midiEvent.getBeat();
+    return this->getPreview().getBeat();
 }
 
 String NoteComponent::getSelectionGroupId() const
@@ -217,6 +238,9 @@ void NoteComponent::mouseDown(const MouseEvent &e)
 
     const Lasso &selection = this->roll.getLassoSelection();
 
+    // The previous gesture must have applied its previews on release
+    jassert(!PianoRollToolbox::hasPreviews(selection));
+
     if (e.mods.isLeftButtonDown())
     {
 #if HELIO_MOBILE
@@ -358,19 +382,10 @@ void NoteComponent::mouseDrag(const MouseEvent &e)
         if (lengthChanged)
         {
             this->checkpointIfNeeded();
-            for (const auto &s : selection.getGroupedSelections())
+            for (int i = 0; i < selection.getNumSelected(); ++i)
             {
-                const auto sequenceSelection(s.second);
-                Array<Note> groupDragBefore, groupDragAfter;
-                
-                for (int i = 0; i < sequenceSelection->size(); ++i)
-                {
-                    NoteComponent *nc = static_cast<NoteComponent *>(sequenceSelection->getUnchecked(i));
-                    groupDragBefore.add(nc->getNote());
-                    groupDragAfter.add(nc->continueResizingRight(deltaLength));
-                }
-                
-                getPianoLayer(sequenceSelection)->changeGroup(groupDragBefore, groupDragAfter, true);
+                NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
+                nc->setPreview(nc->continueResizingRight(deltaLength));
             }
         }
         else
@@ -386,19 +401,10 @@ void NoteComponent::mouseDrag(const MouseEvent &e)
         if (lengthChanged)
         {
             this->checkpointIfNeeded();
-            for (const auto &s : selection.getGroupedSelections())
+            for (int i = 0; i < selection.getNumSelected(); ++i)
             {
-                const auto sequenceSelection(s.second);
-                Array<Note> groupDragBefore, groupDragAfter;
-                
-                for (int i = 0; i < sequenceSelection->size(); ++i)
-                {
-                    NoteComponent *nc = static_cast<NoteComponent *>(sequenceSelection->getUnchecked(i));
-                    groupDragBefore.add(nc->getNote());
-                    groupDragAfter.add(nc->continueResizingLeft(deltaLength));
-                }
-                
-                getPianoLayer(sequenceSelection)->changeGroup(groupDragBefore, groupDragAfter, true);
+                NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
+                nc->setPreview(nc->continueResizingLeft(deltaLength));
             }
         }
         else
@@ -414,19 +420,10 @@ void NoteComponent::mouseDrag(const MouseEvent &e)
         if (scaleFactorChanged)
         {
             this->checkpointIfNeeded();
-            for (const auto &s : selection.getGroupedSelections())
+            for (int i = 0; i < selection.getNumSelected(); ++i)
             {
-                const auto sequenceSelection(s.second);
-                Array<Note> groupDragBefore, groupDragAfter;
-                
-                for (int i = 0; i < sequenceSelection->size(); ++i)
-                {
-                    NoteComponent *nc = static_cast<NoteComponent *>(sequenceSelection->getUnchecked(i));
-                    groupDragBefore.add(nc->getNote());
-                    groupDragAfter.add(nc->continueGroupScalingRight(groupScaleFactor));
-                }
-                
-                getPianoLayer(sequenceSelection)->changeGroup(groupDragBefore, groupDragAfter, true);
+                NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
+                nc->setPreview(nc->continueGroupScalingRight(groupScaleFactor));
             }
         }
         else
@@ -442,19 +439,10 @@ void NoteComponent::mouseDrag(const MouseEvent &e)
         if (scaleFactorChanged)
         {
             this->checkpointIfNeeded();
-            for (const auto &s : selection.getGroupedSelections())
+            for (int i = 0; i < selection.getNumSelected(); ++i)
             {
-                const auto sequenceSelection(s.second);
-                Array<Note> groupDragBefore, groupDragAfter;
-                
-                for (int i = 0; i < sequenceSelection->size(); ++i)
-                {
-                    NoteComponent *nc = static_cast<NoteComponent *>(sequenceSelection->getUnchecked(i));
-                    groupDragBefore.add(nc->getNote());
-                    groupDragAfter.add(nc->continueGroupScalingLeft(groupScaleFactor));
-                }
-                
-                getPianoLayer(sequenceSelection)->changeGroup(groupDragBefore, groupDragAfter, true);
+                NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
+                nc->setPreview(nc->continueGroupScalingLeft(groupScaleFactor));
             }
         }
         else
@@ -493,19 +481,10 @@ void NoteComponent::mouseDrag(const MouseEvent &e)
                 this->stopSound();
             }
             
-            for (const auto &s : selection.getGroupedSelections())
+            for (int i = 0; i < selection.getNumSelected(); ++i)
             {
-                const auto sequenceSelection(s.second);
-                Array<Note> groupDragBefore, groupDragAfter;
-                
-                for (int i = 0; i < sequenceSelection->size(); ++i)
-                {
-                    NoteComponent *nc = static_cast<NoteComponent *>(sequenceSelection->getUnchecked(i));
-                    groupDragBefore.add(nc->getNote());
-                    groupDragAfter.add(nc->continueDragging(deltaBeat, deltaKey, shouldSendMidi));
-                }
-                
-                getPianoLayer(sequenceSelection)->changeGroup(groupDragBefore, groupDragAfter, true);
+                NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
+                nc->setPreview(nc->continueDragging(deltaBeat, deltaKey, shouldSendMidi));
             }
         }
     }
@@ -513,30 +492,21 @@ void NoteComponent::mouseDrag(const MouseEvent &e)
     {
         this->checkpointIfNeeded();
         
-        for (const auto &s : selection.getGroupedSelections())
+        for (int i = 0; i < selection.getNumSelected(); ++i)
         {
-            const auto sequenceSelection(s.second);
-            Array<Note> groupTuneBefore, groupTuneAfter;
-            
-            for (int i = 0; i < sequenceSelection->size(); ++i)
-            {
-                NoteComponent *nc = static_cast<NoteComponent *>(sequenceSelection->getUnchecked(i));
-                groupTuneBefore.add(nc->getNote());
-                
-                Note tuned(nc->continueTuning(e));
-                groupTuneAfter.add(tuned);
-                
-                //this->getRoll().setDefaultNoteVelocity(tuned.getVelocity());
-                //this->roll.triggerBatchRepaintFor(nc);
-            }
-            
-            getPianoLayer(sequenceSelection)->changeGroup(groupTuneBefore, groupTuneAfter, true);
+            NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
+            nc->setPreview(nc->continueTuning(e));
         }
     }
 }
 
 void NoteComponent::mouseUp(const MouseEvent &e)
 {
+    // Whatever the gesture ends with, e.g. a drag released with Alt held,
+    // its previews are applied first, so that the roll matches the model
+    Lasso &selection = this->roll.getLassoSelection();
+    PianoRollToolbox::applyPreviews(selection);
+
     if (this->shouldGoQuickSelectLayerMode(e.mods))
     {
         return;
@@ -563,8 +533,6 @@ void NoteComponent::mouseUp(const MouseEvent &e)
     const bool shouldSendMidi = true;
 #endif
 
-    
-    Lasso &selection = this->roll.getLassoSelection();
 
     if (this->state == ResizingRight)
     {
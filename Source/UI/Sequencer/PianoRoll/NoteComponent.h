@@ -50,6 +50,14 @@ public:
     const Note &getNote() const noexcept;
     PianoRoll &getRoll() const noexcept;
 
+    // While dragging or tuning, the component only displays the new values,
+    // and the sequence gets them all at once when the gesture is finished;
+    // the accessors above return the previewed values, getNote() doesn't
+    void setPreview(const Note &note);
+    void clearPreview() noexcept;
+    bool hasPreview() const noexcept;
+    const Note &getPreview() const noexcept;
+
     void updateColours() override;
 
     //===------------------------------------------------------------------===//
@@ -84,6 +92,9 @@ protected:
     Note anchor;
     Note groupScalingAnchor;
 
+    Note preview;
+    bool isPreviewing;
+
     bool belongsToAnySequence(Array<MidiSequence *> sequences) const;
     void activateCorrespondingTrack(bool selectOthers, bool deselectOthers);
 
@@ -151,22 +151,10 @@ void NoteResizerRight::mouseDrag (const MouseEvent& e)
     {
         this->noteComponent->checkpointIfNeeded();
 
-        for (const auto &s : selection.getGroupedSelections())
+        for (int i = 0; i < selection.getNumSelected(); ++i)
         {
-            const auto sequenceSelection(s.second);
-            Array<Note> groupDragBefore, groupDragAfter;
-
-            for (int i = 0; i < selection.getNumSelected(); ++i)
-            {
-                NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
-                groupDragBefore.add(nc->getNote());
-                groupDragAfter.add(nc->continueGroupScalingRight(groupScaleFactor));
-            }
-
-            const auto &event = sequenceSelection->getFirstAs<NoteComponent>()->getNote();
-            PianoSequence *pianoLayer = static_cast<PianoSequence *>(event.getSequence());
-
-            pianoLayer->changeGroup(groupDragBefore, groupDragAfter, true);
+            NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
+            nc->setPreview(nc->continueGroupScalingRight(groupScaleFactor));
         }
     }
 
@@ -177,7 +165,8 @@ void NoteResizerRight::mouseDrag (const MouseEvent& e)
 void NoteResizerRight::mouseUp (const MouseEvent &e)
 {
     //[UserCode_mouseUp] -- Add your code here...
-    const Lasso &selection = this->roll.getLassoSelection();
+    Lasso &selection = this->roll.getLassoSelection();
+    PianoRollToolbox::applyPreviews(selection);
 
     for (int i = 0; i < selection.getNumSelected(); i++)
     {
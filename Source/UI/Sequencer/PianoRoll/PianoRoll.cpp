@@ -49,6 +49,7 @@
 #include "NotesTuningPanel.h"
 #include "ArpeggiatorEditorPanel.h"
 #include "PianoRollToolbox.h"
+#include "NotesQuery.h"
 #include "Config.h"
 #include "SerializationKeys.h"
 #include "ComponentIDs.h"
@@ -144,6 +145,17 @@ void PianoRoll::reloadRollContent()
     this->eventComponents.clear();
 
     const auto &tracks = this->project.getTracks();
+
+    // allocate the buckets once instead of growing and rehashing
+    // the map over and over while adding the components
+    size_t numEvents = 0;
+    for (auto track : tracks)
+    {
+        numEvents += size_t(track->getSequence()->size());
+    }
+
+    this->eventComponents.reserve(numEvents);
+
     for (auto track : tracks)
     {
         //for (int p = 0; p < track->getPattern()->size(); ++p)
@@ -159,7 +171,7 @@ void PianoRoll::reloadRollContent()
                     Note *note = static_cast<Note *>(event);
                     auto noteComponent = new NoteComponent(*this, *note);
 
-                    this->eventComponents[*note] = UniquePointer<NoteComponent>(noteComponent);
+                    this->eventComponents[note] = UniquePointer<NoteComponent>(noteComponent);
                     //(*clipMap)[*note] = noteComponent;
 
                     const bool belongsToActiveTrack = noteComponent->belongsToAnySequence(this->activeLayers);
@@ -447,19 +459,14 @@ void PianoRoll::onChangeMidiEvent(const MidiEvent &oldEvent, const MidiEvent &ne
     
     if (oldEvent.isTypeOf(MidiEvent::Note))
     {
-        const Note &note = static_cast<const Note &>(oldEvent);
-        const Note &newNote = static_cast<const Note &>(newEvent);
-        if (const auto component = this->eventComponents[note].release())
+        // The new event is the one owned by the sequence, changed in place,
+        // so the component is still found by the same key:
+        const Note &note = static_cast<const Note &>(newEvent);
+        const auto found = this->eventComponents.find(&note);
+        if (found != this->eventComponents.end())
         {
-            // Pass ownership to another key:
-            this->eventComponents.erase(note);
-            // Hitting this assert means that a track somehow contains events
-            // with duplicate id's. This should never, ever happen.
-            jassert(! this->eventComponents.contains(newNote));
-            // Always erase before updating, as it may happen both events have the same hash code:
-            this->eventComponents[newNote] = UniquePointer<NoteComponent>(component);
             // Schedule to be repainted later:
-            this->batchRepaintList.add(component);
+            this->batchRepaintList.add(found->second.get());
             this->triggerAsyncUpdate();
         }
     }
@@ -486,7 +493,7 @@ void PianoRoll::onAddMidiEvent(const MidiEvent &event)
         const Note &note = static_cast<const Note &>(event);
 
         auto component = new NoteComponent(*this, note);
-        this->eventComponents[note] = UniquePointer<NoteComponent>(component);
+        this->eventComponents[&note] = UniquePointer<NoteComponent>(component);
         this->addAndMakeVisible(component);
 
         this->fader.fadeIn(component, 150);
@@ -521,11 +528,13 @@ void PianoRoll::onRemoveMidiEvent(const MidiEvent &event)
     if (event.isTypeOf(MidiEvent::Note))
     {
         const Note &note = static_cast<const Note &>(event);
-        if (NoteComponent *deletedComponent = this->eventComponents[note].get())
+        const auto found = this->eventComponents.find(&note);
+        if (found != this->eventComponents.end())
         {
+            NoteComponent *deletedComponent = found->second.get();
             this->fader.fadeOut(deletedComponent, 150);
             this->selection.deselect(deletedComponent);
-            this->eventComponents.erase(note);
+            this->eventComponents.erase(found);
         }
     }
     else if (event.isTypeOf(MidiEvent::KeySignature))
@@ -553,6 +562,8 @@ void PianoRoll::onChangeTrackProperties(MidiTrack *const track)
 
 void PianoRoll::onAddTrack(MidiTrack *const track)
 {
+    this->eventComponents.reserve(this->eventComponents.size() + size_t(track->getSequence()->size()));
+
     for (int j = 0; j < track->getSequence()->size(); ++j)
     {
         const MidiEvent *const event = track->getSequence()->getUnchecked(j);
@@ -560,7 +571,7 @@ void PianoRoll::onAddTrack(MidiTrack *const track)
         {
             const auto note = static_cast<const Note *const>(event);
             auto noteComponent = new NoteComponent(*this, *note);
-            this->eventComponents[*note] = UniquePointer<NoteComponent>(noteComponent);
+            this->eventComponents[note] = UniquePointer<NoteComponent>(noteComponent);
 
             const bool belongsToActiveTrack = noteComponent->belongsToAnySequence(this->activeLayers);
             noteComponent->setActive(belongsToActiveTrack, true);
@@ -584,12 +595,14 @@ void PianoRoll::onRemoveTrack(MidiTrack *const track)
         const auto event = track->getSequence()->getUnchecked(i);
         if (event->isTypeOf(MidiEvent::Note))
         {
-            const Note &note = static_cast<const Note &>(*event);
-            if (NoteComponent *deletedComponent = this->eventComponents[note].get())
+            const Note *note = static_cast<const Note *>(event);
+            const auto found = this->eventComponents.find(note);
+            if (found != this->eventComponents.end())
             {
+                NoteComponent *deletedComponent = found->second.get();
                 this->fader.fadeOut(deletedComponent, 150);
                 this->selection.deselect(deletedComponent);
-                this->eventComponents.erase(note);
+                this->eventComponents.erase(found);
             }
         }
         else if (event->isTypeOf(MidiEvent::KeySignature))
@@ -629,6 +642,26 @@ void PianoRoll::selectEventsInRange(float startBeat, float endBeat, bool shouldC
     }
 }
 
+void PianoRoll::selectEvents(const NotesQuery &query, bool shouldClearAllOthers)
+{
+    if (shouldClearAllOthers)
+    {
+        this->selection.deselectAll();
+    }
+
+    Array<const Note *> foundNotes;
+    query.findNotes(foundNotes);
+
+    for (const auto *note : foundNotes)
+    {
+        const auto found = this->eventComponents.find(note);
+        if (found != this->eventComponents.end() && found->second->isActive())
+        {
+            this->selection.addToSelection(found->second.get());
+        }
+    }
+}
+
 void PianoRoll::findLassoItemsInArea(Array<SelectableComponent *> &itemsFound, const Rectangle<int> &rectangle)
 {
     this->selection.invalidateCache();
@@ -709,17 +742,12 @@ ValueTree PianoRoll::clipboardCopy() const
         annotationLayerIdParent.setProperty(Serialization::Clipboard::layerId, annotations->getTrackId(), nullptr);
         tree.appendChild(annotationLayerIdParent, nullptr);
 
-        for (int i = 0; i < annotations->size(); ++i)
+        Array<MidiEvent *> eventsInRange;
+        annotations->findEventsInRange(firstBeat, lastBeat, eventsInRange);
+
+        for (const auto *event : eventsInRange)
         {
-            if (const AnnotationEvent *event =
-                dynamic_cast<AnnotationEvent *>(annotations->getUnchecked(i)))
-            {
-                if (const bool eventFitsInRange =
-                    (event->getBeat() >= firstBeat) && (event->getBeat() < lastBeat))
-                {
-                    annotationLayerIdParent.appendChild(event->serialize(), nullptr);
-                }
-            }
+            annotationLayerIdParent.appendChild(event->serialize(), nullptr);
         }
 
         // and from all autos
@@ -731,17 +759,12 @@ ValueTree PianoRoll::clipboardCopy() const
             autoLayerIdParent.setProperty(Serialization::Clipboard::layerId, autoLayer->getTrackId(), nullptr);
             tree.appendChild(autoLayerIdParent, nullptr);
             
-            for (int j = 0; j < autoLayer->size(); ++j)
+            eventsInRange.clearQuick();
+            autoLayer->findEventsInRange(firstBeat, lastBeat, eventsInRange);
+
+            for (const auto *event : eventsInRange)
             {
-                if (const AutomationEvent *event =
-                    dynamic_cast<AutomationEvent *>(autoLayer->getUnchecked(j)))
-                {
-                    if (const bool eventFitsInRange =
-                        (event->getBeat() >= firstBeat) && (event->getBeat() < lastBeat))
-                    {
-                        autoLayerIdParent.appendChild(event->serialize(), nullptr);
-                    }
-                }
+                autoLayerIdParent.appendChild(event->serialize(), nullptr);
             }
         }
     }
@@ -752,6 +775,34 @@ ValueTree PianoRoll::clipboardCopy() const
     return tree;
 }
 
+// Ids are allocated in one batch, and the events are then inserted
+// as a single group, so that large pastes don't stall the UI
+template<typename T>
+static Array<T> createPastedEvents(MidiSequence *targetSequence,
+    const ValueTree &layerElement, const Identifier &eventType, float deltaBeat)
+{
+    int numEvents = 0;
+    forEachValueTreeChildWithType(layerElement, element, eventType)
+    {
+        numEvents++;
+    }
+
+    const auto ids = targetSequence->createUniqueEventIds(numEvents);
+
+    Array<T> result;
+    result.ensureStorageAllocated(numEvents);
+
+    forEachValueTreeChildWithType(layerElement, element, eventType)
+    {
+        const auto parameters = T().withParameters(element);
+        result.add(T(targetSequence, parameters)
+            .withId(ids.getUnchecked(result.size()))
+            .withDeltaBeat(deltaBeat));
+    }
+
+    return result;
+}
+
 void PianoRoll::clipboardPaste(const ValueTree &tree)
 {
     const auto root = tree.hasType(Serialization::Clipboard::clipboard) ?
@@ -772,10 +823,8 @@ void PianoRoll::clipboardPaste(const ValueTree &tree)
 
     this->deselectAll();
 
-    forEachValueTreeChildWithType(root, layerElement, Serialization::Core::track)
+    forEachValueTreeChildWithType(root, layerElement, Serialization::Clipboard::layer)
     {
-        Array<Note> pastedNotes;
-
         const String layerId = layerElement.getProperty(Serialization::Clipboard::layerId);
         
         // TODO: store track type in copy-paste info
@@ -792,13 +841,8 @@ void PianoRoll::clipboardPaste(const ValueTree &tree)
             
             if (correspondingTreeItemExists)
             {
-                Array<AutomationEvent> pastedEvents;
-
-                forEachValueTreeChildWithType(layerElement, autoElement, Serialization::Midi::automationEvent)
-                {
-                    const auto &ae = AutomationEvent(targetLayer).withParameters(autoElement).copyWithNewId();
-                    pastedEvents.add(ae.withDeltaBeat(deltaBeat));
-                }
+                auto pastedEvents = createPastedEvents<AutomationEvent>(targetLayer,
+                    layerElement, Serialization::Midi::automationEvent, deltaBeat);
                 
                 targetLayer->insertGroup(pastedEvents, true);
             }
@@ -808,13 +852,8 @@ void PianoRoll::clipboardPaste(const ValueTree &tree)
             AnnotationsSequence *targetLayer = this->project.findSequenceByTrackId<AnnotationsSequence>(layerId);
             
             // no check for a tree item as there isn't any for ProjectTimeline
-            Array<AnnotationEvent> pastedAnnotations;
-            
-            forEachValueTreeChildWithType(layerElement, annotationElement, Serialization::Midi::annotation)
-            {
-                const auto &ae = AnnotationEvent(targetLayer).withParameters(annotationElement).copyWithNewId();
-                pastedAnnotations.add(ae.withDeltaBeat(deltaBeat));
-            }
+            auto pastedAnnotations = createPastedEvents<AnnotationEvent>(targetLayer,
+                layerElement, Serialization::Midi::annotation, deltaBeat);
             
             targetLayer->insertGroup(pastedAnnotations, true);
         }
@@ -830,11 +869,8 @@ void PianoRoll::clipboardPaste(const ValueTree &tree)
                 targetLayer = static_cast<PianoSequence *>(this->primaryActiveLayer);
             }
             
-            forEachValueTreeChildWithType(layerElement, noteElement, Serialization::Midi::note)
-            {
-                const auto &n = Note(targetLayer).withParameters(noteElement).copyWithNewId();
-                pastedNotes.add(n.withDeltaBeat(deltaBeat));
-            }
+            auto pastedNotes = createPastedEvents<Note>(targetLayer,
+                layerElement, Serialization::Midi::note, deltaBeat);
             
             if (pastedNotes.size() > 0)
             {
@@ -984,6 +1020,9 @@ void PianoRoll::handleCommandMessage(int commandId)
     case CommandIDs::SelectAllEvents:
         this->selectAll();
         break;
+    case CommandIDs::SelectOutOfScaleEvents:
+        this->selectEvents(NotesQuery(this->project).withinTracks(this->activeLayers).outOfScale(), true);
+        break;
     case CommandIDs::ZoomIn:
         this->zoomInImpulse();
         break;
@@ -991,10 +1030,10 @@ void PianoRoll::handleCommandMessage(int commandId)
         this->zoomOutImpulse();
         break;
     case CommandIDs::CopyEvents:
-        InternalClipboard::copy(*this, false);
+        InternalClipboard::copy(*this, true);
         break;
     case CommandIDs::CutEvents:
-        InternalClipboard::copy(*this, false);
+        InternalClipboard::copy(*this, true);
         this->deleteSelection();
         break;
     case CommandIDs::PasteEvents:
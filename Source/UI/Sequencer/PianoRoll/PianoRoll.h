@@ -32,6 +32,7 @@ class NoteComponent;
 class PianoRollReboundThread;
 class PianoRollCellHighlighter;
 class HelperRectangle;
+class NotesQuery;
 class Scale;
 
 #include "HybridRoll.h"
@@ -127,6 +128,9 @@ public:
     void findLassoItemsInArea(Array<SelectableComponent *> &itemsFound,
         const Rectangle<int> &rectangle) override;
 
+    // Selects the notes found by the query, if they belong to active tracks
+    void selectEvents(const NotesQuery &query, bool shouldClearAllOthers);
+
     //===------------------------------------------------------------------===//
     // ClipboardOwner
     //===------------------------------------------------------------------===//
@@ -240,7 +244,10 @@ private:
     ScopedPointer<NoteResizerLeft> noteResizerLeft;
     ScopedPointer<NoteResizerRight> noteResizerRight;
     
-    typedef SparseHashMap<const Note, UniquePointer<NoteComponent>, MidiEventHash> EventComponentsMap;
+    // Keyed by the notes owned by the sequences, which keep their addresses
+    // while they live there, even when changed: no notes are copied or hashed
+    // for lookups, and changing a note doesn't need re-keying its component
+    typedef SparseHashMap<const Note *, UniquePointer<NoteComponent>> EventComponentsMap;
     EventComponentsMap eventComponents;
 
     typedef SparseHashMap<const Clip, UniquePointer<EventComponentsMap>, ClipHash> ClipsMap;
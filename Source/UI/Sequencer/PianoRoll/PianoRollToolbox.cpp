@@ -383,28 +383,23 @@ void PianoRollToolbox::wipeSpace(Array<MidiTrack *> tracks,
     AnnotationChangeGroup annotationsRemoveGroup;
     AutoChangeGroup autoRemoveGroup;
    
+    Array<MidiEvent *> eventsInRange;
+
     for (int i = 0; i < tracks.size(); ++i)
     {
-        const auto sequence = tracks.getUnchecked(i)->getSequence();
+        eventsInRange.clearQuick();
+        tracks.getUnchecked(i)->getSequence()->findEventsInRange(startBeat, endBeat, eventsInRange);
 
-        if (nullptr != dynamic_cast<PianoSequence *>(sequence))
+        for (auto *event : eventsInRange)
         {
-            PianoSequence *layer = dynamic_cast<PianoSequence *>(sequence);
-            for (int j = 0; j < layer->size(); ++j)
+            if (event->isTypeOf(MidiEvent::Note))
             {
-                Note *note = static_cast<Note *>(layer->getUnchecked(j));
+                const Note *note = static_cast<Note *>(event);
                 const float noteStartBeat = note->getBeat();
                 const float noteEndBeat = note->getBeat() + note->getLength();
-                
-                const bool shouldBeDeleted = ((noteStartBeat < endBeat && noteStartBeat >= startBeat) ||
-                                              (noteEndBeat > startBeat && noteEndBeat <= endBeat) ||
-                                              (noteStartBeat < endBeat && noteEndBeat > endBeat));
-                
-                if (shouldBeDeleted)
-                {
-                    pianoRemoveGroup.add(*note);
-                }
-                
+
+                pianoRemoveGroup.add(*note);
+
                 if (shouldKeepCroppedNotes)
                 {
                     const bool hasLeftPartToKeep = (noteStartBeat < startBeat && noteEndBeat > startBeat);
@@ -422,33 +417,13 @@ void PianoRollToolbox::wipeSpace(Array<MidiTrack *> tracks,
                     }
                 }
             }
-        }
-        else if (nullptr != dynamic_cast<AnnotationsSequence *>(sequence))
-        {
-            AnnotationsSequence *layer = dynamic_cast<AnnotationsSequence *>(sequence);
-            for (int j = 0; j < layer->size(); ++j)
+            else if (event->isTypeOf(MidiEvent::Annotation))
             {
-                AnnotationEvent *annotation = static_cast<AnnotationEvent *>(layer->getUnchecked(j));
-                const bool shouldBeDeleted = (annotation->getBeat() < endBeat && annotation->getBeat() >= startBeat);
-                
-                if (shouldBeDeleted)
-                {
-                    annotationsRemoveGroup.add(*annotation);
-                }
+                annotationsRemoveGroup.add(*static_cast<AnnotationEvent *>(event));
             }
-        }
-        else if (nullptr != dynamic_cast<AutomationSequence *>(sequence))
-        {
-            AutomationSequence *layer = dynamic_cast<AutomationSequence *>(sequence);
-            for (int j = 0; j < layer->size(); ++j)
+            else if (event->isTypeOf(MidiEvent::Auto))
             {
-                AutomationEvent *event = static_cast<AutomationEvent *>(layer->getUnchecked(j));
-                const bool shouldBeDeleted = (event->getBeat() < endBeat && event->getBeat() >= startBeat);
-                
-                if (shouldBeDeleted)
-                {
-                    autoRemoveGroup.add(*event);
-                }
+                autoRemoveGroup.add(*static_cast<AutomationEvent *>(event));
             }
         }
     }
@@ -480,46 +455,30 @@ void PianoRollToolbox::shiftEventsToTheLeft(Array<MidiTrack *> tracks, float tar
     {
         const auto sequence = tracks.getUnchecked(i)->getSequence();
 
-        if (nullptr != dynamic_cast<PianoSequence *>(sequence))
+        // the events are sorted, so only the ones before the target beat are visited
+        const int numEventsBefore = sequence->indexOfFirstEventAt(targetBeat);
+
+        for (int j = 0; j < numEventsBefore; ++j)
         {
-            PianoSequence *layer = dynamic_cast<PianoSequence *>(sequence);
-            for (int j = 0; j < layer->size(); ++j)
-            {
-                Note *note = static_cast<Note *>(layer->getUnchecked(j));
+            MidiEvent *event = sequence->getUnchecked(j);
 
-                if (note->getBeat() < targetBeat)
-                {
-                    pianoGroupBefore.add(*note);
-                    pianoGroupAfter.add(note->withDeltaBeat(beatOffset));
-                }
+            if (event->isTypeOf(MidiEvent::Note))
+            {
+                const Note *note = static_cast<Note *>(event);
+                pianoGroupBefore.add(*note);
+                pianoGroupAfter.add(note->withDeltaBeat(beatOffset));
             }
-        }
-        else if (nullptr != dynamic_cast<AnnotationsSequence *>(sequence))
-        {
-            AnnotationsSequence *layer = dynamic_cast<AnnotationsSequence *>(sequence);
-            for (int j = 0; j < layer->size(); ++j)
+            else if (event->isTypeOf(MidiEvent::Annotation))
             {
-                AnnotationEvent *annotation = static_cast<AnnotationEvent *>(layer->getUnchecked(j));
-
-                if (annotation->getBeat() < targetBeat)
-                {
-                    annotationsGroupBefore.add(*annotation);
-                    annotationsGroupAfter.add(annotation->withDeltaBeat(beatOffset));
-                }
+                const AnnotationEvent *annotation = static_cast<AnnotationEvent *>(event);
+                annotationsGroupBefore.add(*annotation);
+                annotationsGroupAfter.add(annotation->withDeltaBeat(beatOffset));
             }
-        }
-        else if (nullptr != dynamic_cast<AutomationSequence *>(sequence))
-        {
-            AutomationSequence *layer = dynamic_cast<AutomationSequence *>(sequence);
-            for (int j = 0; j < layer->size(); ++j)
+            else if (event->isTypeOf(MidiEvent::Auto))
             {
-                AutomationEvent *event = static_cast<AutomationEvent *>(layer->getUnchecked(j));
-                
-                if (event->getBeat() < targetBeat)
-                {
-                    autoGroupBefore.add(*event);
-                    autoGroupAfter.add(event->withDeltaBeat(beatOffset));
-                }
+                const AutomationEvent *autoEvent = static_cast<AutomationEvent *>(event);
+                autoGroupBefore.add(*autoEvent);
+                autoGroupAfter.add(autoEvent->withDeltaBeat(beatOffset));
             }
         }
     }
@@ -546,46 +505,30 @@ void PianoRollToolbox::shiftEventsToTheRight(Array<MidiTrack *> tracks, float ta
     {
         const auto sequence = tracks.getUnchecked(i)->getSequence();
 
-        if (nullptr != dynamic_cast<PianoSequence *>(sequence))
+        // the events are sorted, so only the ones after the target beat are visited
+        const int firstEventAfter = sequence->indexOfFirstEventAt(targetBeat);
+
+        for (int j = firstEventAfter; j < sequence->size(); ++j)
         {
-            PianoSequence *layer = dynamic_cast<PianoSequence *>(sequence);
-            for (int j = 0; j < layer->size(); ++j)
+            MidiEvent *event = sequence->getUnchecked(j);
+
+            if (event->isTypeOf(MidiEvent::Note))
             {
-                Note *note = static_cast<Note *>(layer->getUnchecked(j));
-                
-                if (note->getBeat() >= targetBeat)
-                {
-                    groupBefore.add(*note);
-                    groupAfter.add(note->withDeltaBeat(beatOffset));
-                }
+                const Note *note = static_cast<Note *>(event);
+                groupBefore.add(*note);
+                groupAfter.add(note->withDeltaBeat(beatOffset));
             }
-        }
-        else if (nullptr != dynamic_cast<AnnotationsSequence *>(sequence))
-        {
-            AnnotationsSequence *layer = dynamic_cast<AnnotationsSequence *>(sequence);
-            for (int j = 0; j < layer->size(); ++j)
+            else if (event->isTypeOf(MidiEvent::Annotation))
             {
-                AnnotationEvent *annotation = static_cast<AnnotationEvent *>(layer->getUnchecked(j));
-                
-                if (annotation->getBeat() >= targetBeat)
-                {
-                    annotationsGroupBefore.add(*annotation);
-                    annotationsGroupAfter.add(annotation->withDeltaBeat(beatOffset));
-                }
+                const AnnotationEvent *annotation = static_cast<AnnotationEvent *>(event);
+                annotationsGroupBefore.add(*annotation);
+                annotationsGroupAfter.add(annotation->withDeltaBeat(beatOffset));
             }
-        }
-        else if (nullptr != dynamic_cast<AutomationSequence *>(sequence))
-        {
-            AutomationSequence *layer = dynamic_cast<AutomationSequence *>(sequence);
-            for (int j = 0; j < layer->size(); ++j)
+            else if (event->isTypeOf(MidiEvent::Auto))
             {
-                AutomationEvent *event = static_cast<AutomationEvent *>(layer->getUnchecked(j));
-                
-                if (event->getBeat() >= targetBeat)
-                {
-                    autoGroupBefore.add(*event);
-                    autoGroupAfter.add(event->withDeltaBeat(beatOffset));
-                }
+                const AutomationEvent *autoEvent = static_cast<AutomationEvent *>(event);
+                autoGroupBefore.add(*autoEvent);
+                autoGroupAfter.add(autoEvent->withDeltaBeat(beatOffset));
             }
         }
     }
@@ -1343,22 +1286,10 @@ void PianoRollToolbox::changeVolumeLinear(Lasso &selection, float volumeDelta)
     if (selection.getNumSelected() == 0)
     { return; }
 
-    for (const auto &s : selection.getGroupedSelections())
+    for (int i = 0; i < selection.getNumSelected(); ++i)
     {
-        const auto layerSelection(s.second);
-        PianoSequence *pianoLayer = getPianoLayer(layerSelection);
-        jassert(pianoLayer);
-
-        PianoChangeGroup groupBefore, groupAfter;
-
-        for (int i = 0; i < layerSelection->size(); ++i)
-        {
-            NoteComponent *nc = static_cast<NoteComponent *>(layerSelection->getUnchecked(i));
-            groupBefore.add(nc->getNote());
-            groupAfter.add(nc->continueTuningLinear(volumeDelta));
-        }
-        
-        pianoLayer->changeGroup(groupBefore, groupAfter, true);
+        NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
+        nc->setPreview(nc->continueTuningLinear(volumeDelta));
     }
 }
 
@@ -1367,29 +1298,10 @@ void PianoRollToolbox::changeVolumeMultiplied(Lasso &selection, float volumeFact
     if (selection.getNumSelected() == 0)
     { return; }
 
-    for (const auto &s : selection.getGroupedSelections())
+    for (int i = 0; i < selection.getNumSelected(); ++i)
     {
-        const auto layerSelection(s.second);
-        PianoSequence *pianoLayer = getPianoLayer(layerSelection);
-        jassert(pianoLayer);
-
-        PianoChangeGroup groupBefore, groupAfter;
-        
-        //const double t1 = Time::getMillisecondCounterHiRes();
-        
-        for (int i = 0; i < layerSelection->size(); ++i)
-        {
-            NoteComponent *nc = static_cast<NoteComponent *>(layerSelection->getUnchecked(i));
-            groupBefore.add(nc->getNote());
-            groupAfter.add(nc->continueTuningMultiplied(volumeFactor));
-        }
-        
-        pianoLayer->changeGroup(groupBefore, groupAfter, true);
-        
-        //const double t2 = Time::getMillisecondCounterHiRes();
-        //const double t3 = t2 - t1;
-        
-        //Logger::writeToLog(String(t3));
+        NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
+        nc->setPreview(nc->continueTuningMultiplied(volumeFactor));
     }
 }
 
@@ -1410,35 +1322,67 @@ void PianoRollToolbox::changeVolumeSine(Lasso &selection, float volumeFactor)
     const float startBeat = PianoRollToolbox::findStartBeat(selection);
     const float endBeat = PianoRollToolbox::findEndBeat(selection);
     
+    for (int i = 0; i < selection.getNumSelected(); ++i)
+    {
+        NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
+        const float phase = ((nc->getBeat() - startBeat) / (endBeat - startBeat)) * MathConstants<float>::pi * 2.f * numSines;
+        nc->setPreview(nc->continueTuningSine(volumeFactor, midline, phase));
+    }
+}
+
+void PianoRollToolbox::endTuning(Lasso &selection)
+{
+    jassert(selection.getNumSelected() > 0);
+    PianoRollToolbox::applyPreviews(selection);
+    
+    for (int i = 0; i < selection.getNumSelected(); ++i)
+    {
+        NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
+        nc->endTuning();
+    }
+}
+
+void PianoRollToolbox::applyPreviews(Lasso &selection)
+{
     for (const auto &s : selection.getGroupedSelections())
     {
         const auto layerSelection(s.second);
-        PianoSequence *pianoLayer = getPianoLayer(layerSelection);
-        jassert(pianoLayer);
-        
         PianoChangeGroup groupBefore, groupAfter;
-        
+
         for (int i = 0; i < layerSelection->size(); ++i)
         {
             NoteComponent *nc = static_cast<NoteComponent *>(layerSelection->getUnchecked(i));
-            const float phase = ((nc->getBeat() - startBeat) / (endBeat - startBeat)) * MathConstants<float>::pi * 2.f * numSines;
-            groupBefore.add(nc->getNote());
-            groupAfter.add(nc->continueTuningSine(volumeFactor, midline, phase));
+            if (nc->hasPreview())
+            {
+                groupBefore.add(nc->getNote());
+                groupAfter.add(nc->getPreview());
+                nc->clearPreview();
+            }
+        }
+
+        if (groupBefore.size() > 0)
+        {
+            PianoSequence *pianoLayer = getPianoLayer(layerSelection);
+            jassert(pianoLayer);
+            pianoLayer->changeGroup(groupBefore, groupAfter, true);
         }
-        
-        pianoLayer->changeGroup(groupBefore, groupAfter, true);
     }
 }
 
-void PianoRollToolbox::endTuning(Lasso &selection)
+bool PianoRollToolbox::hasPreviews(const Lasso &selection)
 {
-    jassert(selection.getNumSelected() > 0);
-    
     for (int i = 0; i < selection.getNumSelected(); ++i)
     {
-        NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
-        nc->endTuning();
+        if (NoteComponent *nc = dynamic_cast<NoteComponent *>(selection.getSelectedItem(i)))
+        {
+            if (nc->hasPreview())
+            {
+                return true;
+            }
+        }
     }
+
+    return false;
 }
 
 void PianoRollToolbox::deleteSelection(Lasso &selection)
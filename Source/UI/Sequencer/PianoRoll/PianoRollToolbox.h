@@ -66,6 +66,11 @@ public:
     static void changeVolumeMultiplied(Lasso &selection, float volumeFactor);
     static void changeVolumeSine(Lasso &selection, float volumeFactor);
     static void endTuning(Lasso &selection);
+
+    // Sends the previewed values of the selected notes to their sequences,
+    // as a single change per sequence
+    static void applyPreviews(Lasso &selection);
+    static bool hasPreviews(const Lasso &selection);
     
     static void deleteSelection(Lasso &selection);
     
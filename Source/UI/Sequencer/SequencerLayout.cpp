@@ -45,6 +45,7 @@
 #include "MainLayout.h"
 #include "AudioCore.h"
 #include "AudioMonitor.h"
+#include "FrameClock.h"
 #include "ComponentIDs.h"
 #include "ColourIDs.h"
 
@@ -68,7 +69,7 @@ template class KeySignaturesTrackMap<KeySignatureSmallComponent>;
 // Splitter
 //===----------------------------------------------------------------------===//
 
-class MidiEditorSplitContainer : public Component, private Timer
+class MidiEditorSplitContainer : public Component, private FrameClock::Listener
 {
 public:
     
@@ -168,21 +169,22 @@ public:
             this->deltaH = float(heightOffset);
             this->automations->setSize(this->automations->getWidth(), this->automations->getHeight() + heightOffset);
             this->automations->setTopLeftPosition(0, this->automations->getY() - heightOffset);
-            this->startTimerHz(60);
+            this->startReceivingFrames();
         }
     }
     
 private:
     
-    void timerCallback() override
+    void onFrame(float deltaMs) override
     {
-        this->deltaH = this->deltaH / 1.6f;
+        const float numFrames = deltaMs * FRAME_CLOCK_RATE_HZ / 1000.f;
+        this->deltaH = this->deltaH / powf(1.6f, numFrames);
         this->resized();
         
         if (fabs(this->deltaH) < 0.1f)
         {
             this->deltaH = 0.f;
-            this->stopTimer();
+            this->stopReceivingFrames();
         }
     }
     
@@ -315,7 +317,7 @@ private:
 // Rolls container responsible for switching between piano and pattern roll
 //===----------------------------------------------------------------------===//
 
-class RollsSwitchingProxy : public Component, private Timer
+class RollsSwitchingProxy : public Component, private FrameClock::Listener
 {
 public:
     
@@ -366,7 +368,7 @@ public:
         this->patternViewport->setVisible(true);
         this->pianoViewport->setVisible(true);
         this->resized();
-        this->startTimerHz(60);
+        this->startReceivingFrames();
     }
 
     // This simply prevents a JUCE assertion about opaque component with no painting method
@@ -445,14 +447,16 @@ public:
 
 private:
 
-    void timerCallback() override
+    // The speed and acceleration are per a 60Hz frame, adjusted for the actual frame time
+    void onFrame(float deltaMs) override
     {
-        this->animationPosition += this->animationDirection * this->animationSpeed;
-        this->animationSpeed *= ROLLS_SWITCH_ANIMATION_ACCELERATION;
+        const float numFrames = deltaMs * FRAME_CLOCK_RATE_HZ / 1000.f;
+        this->animationPosition += this->animationDirection * this->animationSpeed * numFrames;
+        this->animationSpeed *= powf(ROLLS_SWITCH_ANIMATION_ACCELERATION, numFrames);
 
         if (this->animationPosition < 0.001f || this->animationPosition > 0.999f)
         {
-            this->stopTimer();
+            this->stopReceivingFrames();
 
             if (this->isPatternMode())
             { this->pianoViewport->setVisible(false); }
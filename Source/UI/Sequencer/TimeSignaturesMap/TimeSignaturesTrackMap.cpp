@@ -20,6 +20,7 @@
 #include "ProjectTreeItem.h"
 #include "Transport.h"
 #include "MidiSequence.h"
+#include "TimeSignaturesSequence.h"
 #include "ProjectTimeline.h"
 #include "PianoSequence.h"
 #include "PlayerThread.h"
@@ -316,21 +317,18 @@ void TimeSignaturesTrackMap<T>::onTimeSignatureTapped(T *nc)
 {
     const TimeSignatureEvent *timeSignatureUnderSeekCursor = nullptr;
     const ProjectTimeline *timeline = this->project.getTimeline();
-    const auto timeSignatures = timeline->getTimeSignatures()->getSequence();
     const double seekPosition = this->project.getTransport().getSeekPosition();
 
-    for (int i = 0; i < timeSignatures->size(); ++i)
+    if (const auto timeSignatures =
+        dynamic_cast<TimeSignaturesSequence *>(timeline->getTimeSignatures()->getSequence()))
     {
-        if (TimeSignatureEvent *timeSignature =
-            dynamic_cast<TimeSignatureEvent *>(timeSignatures->getUnchecked(i)))
+        // The nearest signature at or before the cursor (within the threshold),
+        // found by the bar grid index instead of checking each of them
+        const float seekBeat = this->roll.getBeatByTransportPosition(seekPosition);
+        const auto *signature = timeSignatures->getMeterByBeat(seekBeat + 0.1f).signature;
+        if (signature != nullptr && fabs(signature->getBeat() - seekBeat) < 0.1)
         {
-            const float seekBeat = this->roll.getBeatByTransportPosition(seekPosition);
-            
-            if (fabs(timeSignature->getBeat() - seekBeat) < 0.1)
-            {
-                timeSignatureUnderSeekCursor = timeSignature;
-                break;
-            }
+            timeSignatureUnderSeekCursor = signature;
         }
     }
 
@@ -25,55 +25,78 @@
 #include "AnnotationEvent.h"
 #include "MidiTrack.h"
 
-class TrackMapNoteComponent final : public Component
+#include <float.h>
+
+#define TRACK_MAP_TILE_BEATS 32
+#define TRACK_MAP_TILE_HEIGHT 128
+
+// The tiles are rendered at 2^level pixels per beat,
+// from 1/4 for the longest projects, to 128 for the shortest ones
+#define TRACK_MAP_MIN_SCALE_LEVEL -2
+#define TRACK_MAP_MAX_SCALE_LEVEL 7
+#define TRACK_MAP_DEFAULT_PIXELS_PER_BEAT 4.f
+
+static inline int getTileIndex(float beat) noexcept
+{
+    return int(floorf(beat / float(TRACK_MAP_TILE_BEATS)));
+}
+
+class PianoTrackMap::TileRenderJob final : public ThreadPoolJob
 {
 public:
 
-    TrackMapNoteComponent(PianoTrackMap &parent, const Note &event) :
-        note(event),
-        map(parent),
-        dx(0.f),
-        dw(0.f)
-    {
-        this->updateColour();
-        this->setInterceptsMouseClicks(false, false);
-        this->setPaintingIsUnclipped(true);
-    }
+    TileRenderJob(PianoTrackMap &map, int tileIndex, uint32 version,
+        float pixelsPerBeat, const Array<NoteSnapshot> &notes) :
+        ThreadPoolJob("Track map tile"),
+        map(map),
+        tileIndex(tileIndex),
+        version(version),
+        pixelsPerBeat(pixelsPerBeat),
+        notes(notes) {}
 
-    inline int getKey() const noexcept           { return this->note.getKey(); }
-    inline float getBeat() const noexcept        { return this->note.getBeat(); }
-    inline float getLength() const noexcept      { return this->note.getLength(); }
-    inline float getVelocity() const noexcept    { return this->note.getVelocity(); }
-    inline void updateColour()
+    JobStatus runJob() override
     {
-        this->colour = this->note.getColour().
-            interpolatedWith(Colours::white, .35f).
-            withAlpha(.55f);
-    }
+        Image image;
 
-    void setRealBounds(float x, int y, float w, int h)
-    {
-        this->dx = x - floorf(x);
-        this->dw = ceilf(w) - w;
-        this->setBounds(int(floorf(x)), y, int(ceilf(w)), h);
-    }
-    
-    void paint(Graphics &g) override
-    {
-        g.setColour(this->colour);
-        g.drawHorizontalLine(0, this->dx, float(this->getWidth()) - this->dw);
+        if (this->notes.size() > 0)
+        {
+            const float pixelsPerBeat = this->pixelsPerBeat;
+            const int tileWidth = jmax(1, roundToInt(pixelsPerBeat * float(TRACK_MAP_TILE_BEATS)));
+            image = Image(Image::ARGB, tileWidth, TRACK_MAP_TILE_HEIGHT,
+                true, SoftwareImageType());
+
+            Graphics g(image);
+            const float tileStartBeat = float(this->tileIndex * TRACK_MAP_TILE_BEATS);
+
+            for (const auto &note : this->notes)
+            {
+                if (this->shouldExit())
+                {
+                    return jobHasFinished;
+                }
+
+                const float x = (note.beat - tileStartBeat) * pixelsPerBeat;
+                const float w = jmax(1.f, note.length * pixelsPerBeat);
+                const int y = jlimit(0, TRACK_MAP_TILE_HEIGHT - 1, TRACK_MAP_TILE_HEIGHT - 1 - note.key);
+                g.setColour(note.colour);
+                g.fillRect(x, float(y), w, 1.f);
+            }
+        }
+
+        this->map.onTileRendered(this->tileIndex, this->version, image);
+        return jobHasFinished;
     }
 
 private:
 
-    const Note &note;
     PianoTrackMap &map;
-    
-    Colour colour;
 
-    float dx;
-    float dw;
+    const int tileIndex;
+    const uint32 version;
+    const float pixelsPerBeat;
+    const Array<NoteSnapshot> notes;
 
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TileRenderJob)
 };
 
 PianoTrackMap::PianoTrackMap(ProjectTreeItem &parentProject, HybridRoll &parentRoll) :
@@ -83,35 +106,57 @@ PianoTrackMap::PianoTrackMap(ProjectTreeItem &parentProject, HybridRoll &parentR
     projectLastBeat(0.f),
     rollFirstBeat(0.f),
     rollLastBeat(0.f),
-    componentHeight(1.f)
+    tilePixelsPerBeat(TRACK_MAP_DEFAULT_PIXELS_PER_BEAT),
+    renderPool(1)
 {
+    this->renderPool.setThreadPriorities(3);
     this->setInterceptsMouseClicks(false, false);
     this->setPaintingIsUnclipped(true);
-    this->reloadTrackMap();
+    this->invalidateAll();
     this->project.addListener(this);
 }
 
 PianoTrackMap::~PianoTrackMap()
 {
     this->project.removeListener(this);
+    this->renderPool.removeAllJobs(true, -1);
 }
 
 //===----------------------------------------------------------------------===//
 // Component
 //===----------------------------------------------------------------------===//
 
-void PianoTrackMap::resized()
+void PianoTrackMap::paint(Graphics &g)
 {
-    this->componentHeight = float(this->getHeight()) / 128.f; // TODO remove hard-coded value
-    
-    this->setVisible(false);
+    const float rollLengthInBeats = (this->rollLastBeat - this->rollFirstBeat);
+    if (rollLengthInBeats <= 0.f)
+    {
+        return;
+    }
 
-    for (const auto &e : this->componentsMap)
+    const float pixelsPerBeat = float(this->getWidth()) / rollLengthInBeats;
+    const float tileWidth = pixelsPerBeat * float(TRACK_MAP_TILE_BEATS);
+    const float tileHeight = float(this->getHeight());
+
+    const auto clip = g.getClipBounds();
+    const int firstTile = getTileIndex(this->rollFirstBeat + float(clip.getX()) / pixelsPerBeat);
+    const int lastTile = getTileIndex(this->rollFirstBeat + float(clip.getRight()) / pixelsPerBeat);
+
+    for (int i = firstTile; i <= lastTile; ++i)
     {
-        this->applyNoteBounds(e.second.get());
+        const auto tile = this->tiles.find(i);
+        if (tile != this->tiles.end() && tile->second.image.isValid())
+        {
+            const float x = (float(i * TRACK_MAP_TILE_BEATS) - this->rollFirstBeat) * pixelsPerBeat;
+            g.drawImage(tile->second.image, { x, 0.f, tileWidth, tileHeight },
+                RectanglePlacement::stretchToFit);
+        }
     }
+}
 
-    this->setVisible(true);
+void PianoTrackMap::resized()
+{
+    this->updateTileScale();
 }
 
 //===----------------------------------------------------------------------===//
@@ -122,14 +167,8 @@ void PianoTrackMap::onChangeMidiEvent(const MidiEvent &oldEvent, const MidiEvent
 {
     if (oldEvent.isTypeOf(MidiEvent::Note))
     {
-        const Note &note = static_cast<const Note &>(oldEvent);
-        const Note &newNote = static_cast<const Note &>(newEvent);
-        if (const auto component = this->componentsMap[note].release())
-        {
-            this->componentsMap.erase(note);
-            this->componentsMap[newNote] = UniquePointer<TrackMapNoteComponent>(component);
-            this->applyNoteBounds(component);
-        }
+        this->invalidateNote(static_cast<const Note &>(oldEvent));
+        this->invalidateNote(static_cast<const Note &>(newEvent));
     }
 }
 
@@ -137,14 +176,7 @@ void PianoTrackMap::onAddMidiEvent(const MidiEvent &event)
 {
     if (event.isTypeOf(MidiEvent::Note))
     {
-        const Note &note = static_cast<const Note &>(event);
-
-        auto component = new TrackMapNoteComponent(*this, note);
-        this->componentsMap[note] = UniquePointer<TrackMapNoteComponent>(component);
-
-        this->addAndMakeVisible(component);
-        this->applyNoteBounds(component);
-        component->toFront(false);
+        this->invalidateNote(static_cast<const Note &>(event));
     }
 }
 
@@ -152,56 +184,31 @@ void PianoTrackMap::onRemoveMidiEvent(const MidiEvent &event)
 {
     if (event.isTypeOf(MidiEvent::Note))
     {
-        const Note &note = static_cast<const Note &>(event);
-        if (const auto deletedComponent = this->componentsMap[note].get())
-        {
-            this->componentsMap.erase(note);
-        }
+        this->invalidateNote(static_cast<const Note &>(event));
     }
 }
 
 void PianoTrackMap::onChangeTrackProperties(MidiTrack *const track)
 {
     if (!dynamic_cast<const PianoSequence *>(track->getSequence())) { return; }
-
-    this->setVisible(false);
-
-    for (const auto &e : this->componentsMap)
-    {
-        e.second->updateColour();
-    }
-
-    this->setVisible(true);
-    this->repaint();
+    this->invalidateTrack(track);
 }
 
 void PianoTrackMap::onReloadProjectContent(const Array<MidiTrack *> &tracks)
 {
-    this->reloadTrackMap();
+    this->invalidateAll();
 }
 
 void PianoTrackMap::onAddTrack(MidiTrack *const track)
 {
     if (!dynamic_cast<const PianoSequence *>(track->getSequence())) { return; }
-
-    if (track->getSequence()->size() > 0)
-    {
-        this->reloadTrackMap();
-    }
+    this->invalidateTrack(track);
 }
 
 void PianoTrackMap::onRemoveTrack(MidiTrack *const track)
 {
     if (!dynamic_cast<const PianoSequence *>(track->getSequence())) { return; }
-
-    for (int i = 0; i < track->getSequence()->size(); ++i)
-    {
-        const Note &note = static_cast<const Note &>(*track->getSequence()->getUnchecked(i));
-        if (const auto deletedComponent = this->componentsMap[note].get())
-        {
-            this->componentsMap.erase(note);
-        }
-    }
+    this->invalidateTrack(track);
 }
 
 void PianoTrackMap::onChangeProjectBeatRange(float firstBeat, float lastBeat)
@@ -214,7 +221,8 @@ void PianoTrackMap::onChangeProjectBeatRange(float firstBeat, float lastBeat)
     {
         this->rollFirstBeat = firstBeat;
         this->rollLastBeat = lastBeat;
-        this->resized();
+        this->updateTileScale();
+        this->repaint();
     }
 }
 
@@ -222,49 +230,181 @@ void PianoTrackMap::onChangeViewBeatRange(float firstBeat, float lastBeat)
 {
     this->rollFirstBeat = firstBeat;
     this->rollLastBeat = lastBeat;
-    this->resized();
+    this->updateTileScale();
+    this->repaint();
 }
 
 //===----------------------------------------------------------------------===//
-// Private
+// Tiles
 //===----------------------------------------------------------------------===//
 
-void PianoTrackMap::reloadTrackMap()
+void PianoTrackMap::updateTileScale()
 {
-    this->componentsMap.clear();
+    const float rollLengthInBeats = (this->rollLastBeat - this->rollFirstBeat);
+    if (rollLengthInBeats <= 0.f || this->getWidth() <= 0)
+    {
+        return;
+    }
 
-    this->setVisible(false);
+    // The nearest power of two keeps the tiles within a factor of
+    // sqrt(2) from the actual scale, so the notes stay crisp enough
+    const float pixelsPerBeat = float(this->getWidth()) / rollLengthInBeats;
+    const int level = jlimit(TRACK_MAP_MIN_SCALE_LEVEL, TRACK_MAP_MAX_SCALE_LEVEL,
+        roundToInt(log2f(pixelsPerBeat)));
 
-    const auto &tracks = this->project.getTracks();
-    for (auto track : tracks)
+    const float newPixelsPerBeat = ldexpf(1.f, level);
+    if (newPixelsPerBeat != this->tilePixelsPerBeat)
     {
-        for (int j = 0; j < track->getSequence()->size(); ++j)
+        this->tilePixelsPerBeat = newPixelsPerBeat;
+        this->invalidateAll();
+    }
+}
+
+void PianoTrackMap::invalidateNote(const Note &note)
+{
+    this->invalidateBeatRange(note.getBeat(), note.getBeat() + note.getLength());
+}
+
+void PianoTrackMap::invalidateBeatRange(float startBeat, float endBeat)
+{
+    const int lastTile = getTileIndex(endBeat);
+    for (int i = getTileIndex(startBeat); i <= lastTile; ++i)
+    {
+        this->tiles[i].version++;
+    }
+
+    this->triggerAsyncUpdate();
+}
+
+void PianoTrackMap::invalidateTrack(const MidiTrack *track)
+{
+    const auto *sequence = track->getSequence();
+    if (sequence->size() == 0)
+    {
+        return;
+    }
+
+    // The last note is not necessarily the one that ends last
+    float lastBeat = -FLT_MAX;
+    for (const auto *event : *sequence)
+    {
+        const Note &note = static_cast<const Note &>(*event);
+        lastBeat = jmax(lastBeat, note.getBeat() + note.getLength());
+    }
+
+    this->invalidateBeatRange(sequence->getFirstBeat(), lastBeat);
+}
+
+void PianoTrackMap::invalidateAll()
+{
+    for (auto &tile : this->tiles)
+    {
+        tile.second.version++;
+    }
+
+    for (const auto *track : this->project.getTracks())
+    {
+        if (dynamic_cast<const PianoSequence *>(track->getSequence()))
         {
-            MidiEvent *event = track->getSequence()->getUnchecked(j);
+            this->invalidateTrack(track);
+        }
+    }
 
-            if (Note *note = dynamic_cast<Note *>(event))
+    this->triggerAsyncUpdate();
+}
+
+void PianoTrackMap::onTileRendered(int tileIndex, uint32 version, const Image &image)
+{
+    // Called from the render thread
+    const ScopedLock lock(this->renderedTilesLock);
+    this->renderedTiles.add({ tileIndex, version, image });
+    this->triggerAsyncUpdate();
+}
+
+void PianoTrackMap::handleAsyncUpdate()
+{
+    bool hasNewImages = false;
+
+    {
+        const ScopedLock lock(this->renderedTilesLock);
+        for (const auto &rendered : this->renderedTiles)
+        {
+            // Even if the tile is already outdated, the newer image is still
+            // better than the old one, while the up-to-date one is rendering
+            auto &tile = this->tiles[rendered.index];
+            if (rendered.version > tile.renderedVersion)
             {
-                auto noteComponent = new TrackMapNoteComponent(*this, *note);
-                this->componentsMap[*note] = UniquePointer<TrackMapNoteComponent>(noteComponent);
-                this->addAndMakeVisible(noteComponent);
+                tile.image = rendered.image;
+                tile.renderedVersion = rendered.version;
+                hasNewImages = true;
             }
         }
+
+        this->renderedTiles.clearQuick();
     }
 
-    this->resized();
-    this->setVisible(true);
-}
+    if (hasNewImages)
+    {
+        this->repaint();
+    }
 
-void PianoTrackMap::applyNoteBounds(TrackMapNoteComponent *nc)
-{
-    const float rollLengthInBeats = (this->rollLastBeat - this->rollFirstBeat);
-    const float projectLengthInBeats = (this->projectLastBeat - this->projectFirstBeat);
+    SparseHashMap<int, Array<NoteSnapshot>> dirtyTiles;
+    float dirtyStartBeat = FLT_MAX;
+    float dirtyEndBeat = -FLT_MAX;
 
-    const float beat = (nc->getBeat() - this->rollFirstBeat);
-    const float mapWidth = float(this->getWidth()) * (projectLengthInBeats / rollLengthInBeats);
+    for (auto &tile : this->tiles)
+    {
+        if (tile.second.version != tile.second.scheduledVersion)
+        {
+            tile.second.scheduledVersion = tile.second.version;
+            dirtyTiles[tile.first] = {};
+            dirtyStartBeat = jmin(dirtyStartBeat, float(tile.first * TRACK_MAP_TILE_BEATS));
+            dirtyEndBeat = jmax(dirtyEndBeat, float((tile.first + 1) * TRACK_MAP_TILE_BEATS));
+        }
+    }
 
-    const float x = (mapWidth * (beat / projectLengthInBeats));
-    const float w = (mapWidth * (nc->getLength() / projectLengthInBeats));
-    const int y = this->getHeight() - int(nc->getKey() * this->componentHeight);
-    nc->setRealBounds(x, y, jmax(1.f, w), 1);
+    if (dirtyTiles.empty())
+    {
+        return;
+    }
+
+    // Collect the notes for the tiles to be rendered, in a single pass:
+    Array<MidiEvent *> notesInRange;
+    for (const auto *track : this->project.getTracks())
+    {
+        const auto *sequence = dynamic_cast<const PianoSequence *>(track->getSequence());
+        if (sequence == nullptr)
+        {
+            continue;
+        }
+
+        notesInRange.clearQuick();
+        sequence->findEventsInRange(dirtyStartBeat, dirtyEndBeat, notesInRange);
+
+        for (const auto *event : notesInRange)
+        {
+            const Note &note = static_cast<const Note &>(*event);
+            const float noteEndBeat = note.getBeat() + note.getLength();
+
+            const NoteSnapshot snapshot = { note.getKey(), note.getBeat(), note.getLength(),
+                note.getColour().interpolatedWith(Colours::white, .35f).withAlpha(.55f) };
+
+            const int lastTile = getTileIndex(noteEndBeat);
+            for (int i = getTileIndex(note.getBeat()); i <= lastTile; ++i)
+            {
+                const auto dirtyTile = dirtyTiles.find(i);
+                if (dirtyTile != dirtyTiles.end())
+                {
+                    dirtyTile->second.add(snapshot);
+                }
+            }
+        }
+    }
+
+    for (const auto &dirtyTile : dirtyTiles)
+    {
+        const uint32 version = this->tiles[dirtyTile.first].version;
+        this->renderPool.addJob(new TileRenderJob(*this, dirtyTile.first,
+            version, this->tilePixelsPerBeat, dirtyTile.second), true);
+    }
 }
@@ -22,11 +22,17 @@
 
 class HybridRoll;
 class ProjectTreeItem;
-class TrackMapNoteComponent;
 
+// The map is rendered into a set of cached image tiles, each covering
+// a fixed range of beats; the tiles are re-rendered on a background thread,
+// only for the beat ranges affected by the changes, so that moving
+// and resizing the map costs no more than blitting those images.
+// The tiles are rendered at the power-of-two scale nearest to the map's,
+// and all of them are re-rendered once the map's scale crosses to another.
 class PianoTrackMap :
     public Component,
-    public ProjectListener
+    public ProjectListener,
+    private AsyncUpdater
 {
 public:
 
@@ -37,6 +43,7 @@ public:
     // Component
     //===------------------------------------------------------------------===//
 
+    void paint(Graphics &g) override;
     void resized() override;
 
     //===------------------------------------------------------------------===//
@@ -57,21 +64,59 @@ public:
 
 private:
 
-    void applyNoteBounds(TrackMapNoteComponent *nc);
-    void reloadTrackMap();
+    struct NoteSnapshot final
+    {
+        int key;
+        float beat;
+        float length;
+        Colour colour;
+    };
+
+    struct Tile final
+    {
+        Image image;
+        uint32 version = 1;
+        uint32 scheduledVersion = 0;
+        uint32 renderedVersion = 0;
+    };
+
+    struct RenderedTile final
+    {
+        int index;
+        uint32 version;
+        Image image;
+    };
+
+    class TileRenderJob;
+    friend class TileRenderJob;
+
+    void handleAsyncUpdate() override;
+    void onTileRendered(int tileIndex, uint32 version, const Image &image);
+    void updateTileScale();
+
+    void invalidateNote(const Note &note);
+    void invalidateBeatRange(float startBeat, float endBeat);
+    void invalidateTrack(const MidiTrack *track);
+    void invalidateAll();
 
     float projectFirstBeat;
     float projectLastBeat;
 
     float rollFirstBeat;
     float rollLastBeat;
-    
-    float componentHeight;
-    
+
+    // the scale the tiles are rendered at, set on the message thread
+    float tilePixelsPerBeat;
+
     HybridRoll &roll;
     ProjectTreeItem &project;
-    
-    SparseHashMap<Note, UniquePointer<TrackMapNoteComponent>, MidiEventHash> componentsMap;
-    
+
+    SparseHashMap<int, Tile> tiles;
+
+    CriticalSection renderedTilesLock;
+    Array<RenderedTile> renderedTiles;
+
+    ThreadPool renderPool;
+
     JUCE_LEAK_DETECTOR(PianoTrackMap)
 };
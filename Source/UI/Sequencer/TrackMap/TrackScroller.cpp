@@ -282,7 +282,7 @@ void TrackScroller::mouseWheelMove(const MouseEvent &event, const MouseWheelDeta
 
 void TrackScroller::onMidiRollMoved(HybridRoll *targetRoll)
 {
-    if (this->roll == targetRoll && !this->isTimerRunning())
+    if (this->roll == targetRoll && !this->isReceivingFrames())
     {
         this->triggerAsyncUpdate();
     }
@@ -290,7 +290,7 @@ void TrackScroller::onMidiRollMoved(HybridRoll *targetRoll)
 
 void TrackScroller::onMidiRollResized(HybridRoll *targetRoll)
 {
-    if (this->roll == targetRoll && !this->isTimerRunning())
+    if (this->roll == targetRoll && !this->isReceivingFrames())
     {
         this->triggerAsyncUpdate();
     }
@@ -302,13 +302,16 @@ void TrackScroller::switchToRoll(HybridRoll *targetRoll)
     this->oldAreaBounds = this->getIndicatorBounds();
     this->oldMapBounds = this->getMapBounds().toFloat();
     this->roll = targetRoll;
-    this->startTimerHz(60);
+    this->startReceivingFrames();
 }
 
 //===----------------------------------------------------------------------===//
-// Timer
+// FrameClock::Listener
 //===----------------------------------------------------------------------===//
 
+// The lerp factor per a 60Hz frame, adjusted for the actual frame time
+#define TRACK_SCROLLER_LERP_FACTOR 0.2f
+
 
 static Rectangle<float> lerpRectangle(const Rectangle<float> &r1,
     const Rectangle<float> &r2, float factor)
@@ -340,12 +343,15 @@ static float getRectangleDistance(const Rectangle<float> &r1,
         fabs(r1.getHeight() - r2.getHeight());
 }
 
-void TrackScroller::timerCallback()
+void TrackScroller::onFrame(float deltaMs)
 {
+    const float numFrames = deltaMs * FRAME_CLOCK_RATE_HZ / 1000.f;
+    const float factor = 1.f - powf(1.f - TRACK_SCROLLER_LERP_FACTOR, numFrames);
+
     const auto mb = this->getMapBounds().toFloat();
-    const auto mbLerp = lerpRectangle(this->oldMapBounds, mb, 0.2f);
+    const auto mbLerp = lerpRectangle(this->oldMapBounds, mb, factor);
     const auto ib = this->getIndicatorBounds();
-    const auto ibLerp = lerpRectangle(this->oldAreaBounds, ib, 0.2f);
+    const auto ibLerp = lerpRectangle(this->oldAreaBounds, ib, factor);
     const bool shouldStop = (getRectangleDistance(this->oldAreaBounds, ib) < 0.5f);
     const auto targetAreaBounds = shouldStop ? ib : ibLerp;
     const auto targetMapBounds = shouldStop ? mb : mbLerp;
@@ -364,7 +370,7 @@ void TrackScroller::timerCallback()
 
     if (shouldStop)
     {
-        this->stopTimer();
+        this->stopReceivingFrames();
     }
 }
 
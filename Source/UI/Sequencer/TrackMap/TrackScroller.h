@@ -26,12 +26,13 @@ class Transport;
 #include "HelperRectangle.h"
 #include "HybridRollListener.h"
 #include "ComponentFader.h"
+#include "FrameClock.h"
 
 class TrackScroller :
     public Component,
     public HybridRollListener,
     private AsyncUpdater,
-    private Timer
+    private FrameClock::Listener
 {
 public:
 
@@ -152,7 +153,7 @@ protected:
 private:
     
     void handleAsyncUpdate() override;
-    void timerCallback() override;
+    void onFrame(float deltaMs) override;
     
     Transport &transport;
     HybridRoll *roll;